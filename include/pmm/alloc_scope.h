@@ -0,0 +1,134 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+namespace pmm::detail
+{
+/*
+### pmm-detail-allocscope
+req: feat-002, fr-004, qa-rec-001
+*/
+template <typename IndexT> struct AllocScope
+{
+    std::vector<IndexT>                    allocated;
+    std::vector<IndexT>                    released;
+    std::vector<std::pair<size_t, IndexT>> roots;
+    AllocScope*                            outer        = nullptr;
+    uint64_t                               generation   = 0;
+    bool                                   active       = false;
+    bool                                   failed       = false;
+    bool                                   rolling_back = false;
+    bool reserve( size_t count ) noexcept
+    {
+        try
+        {
+            allocated.reserve( allocated.size() + count );
+        }
+        catch ( ... )
+        {
+            return false;
+        }
+        return true;
+    }
+    bool track( IndexT idx ) noexcept
+    {
+        try
+        {
+            allocated.push_back( idx );
+        }
+        catch ( ... )
+        {
+            return false;
+        }
+        return true;
+    }
+    bool defer( IndexT idx ) noexcept
+    {
+        try
+        {
+            released.push_back( idx );
+        }
+        catch ( ... )
+        {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+    void forget( IndexT idx ) noexcept
+    {
+        for ( size_t i = allocated.size(); i > 0; --i )
+        {
+            if ( allocated[i - 1] == idx )
+            {
+                allocated[i - 1] = 0;
+                return;
+            }
+        }
+    }
+    bool owns( IndexT idx ) const noexcept
+    {
+        for ( size_t i = allocated.size(); i > 0; --i )
+        {
+            if ( allocated[i - 1] == idx )
+                return true;
+        }
+        return false;
+    }
+    void record_root( size_t slot, IndexT old ) noexcept
+    {
+        for ( const auto& change : roots )
+        {
+            if ( change.first == slot )
+                return;
+        }
+        try
+        {
+            roots.emplace_back( slot, old );
+        }
+        catch ( ... )
+        {
+            failed = true;
+        }
+    }
+    bool reserve_commit( size_t more_released, size_t more_roots ) noexcept
+    {
+        try
+        {
+            released.reserve( released.size() + more_released );
+            roots.reserve( roots.size() + more_roots );
+            if ( outer != nullptr )
+            {
+                outer->allocated.reserve( outer->allocated.size() + allocated.size() );
+                outer->released.reserve( outer->released.size() + released.size() + more_released );
+                outer->roots.reserve( outer->roots.size() + roots.size() + more_roots );
+            }
+        }
+        catch ( ... )
+        {
+            return false;
+        }
+        return true;
+    }
+    bool merge_into( AllocScope& parent ) noexcept
+    {
+        if ( !reserve_commit( 0, 0 ) )
+            return false;
+        parent.allocated.insert( parent.allocated.end(), allocated.begin(), allocated.end() );
+        parent.released.insert( parent.released.end(), released.begin(), released.end() );
+        for ( const auto& change : roots )
+            parent.record_root( change.first, change.second );
+        parent.failed = parent.failed || failed;
+        return true;
+    }
+    void clear() noexcept
+    {
+        allocated.clear();
+        released.clear();
+        roots.clear();
+        failed       = false;
+        rolling_back = false;
+    }
+};
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include "pmm/alloc_scope.h"
+#include "pmm/forest_registry.h"
+#include "pmm/typed_guard.h"
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+namespace pmm
+{
+template <typename ManagerT>
+/*
+## pmm-alloc_transaction
+req: feat-002, fr-004, fr-021, qa-rec-001
+*/
+class alloc_transaction
+{
+  public:
+    using index_type                                         = typename ManagerT::index_type;
+    template <typename T> using pptr_t                       = typename ManagerT::template pptr<T>;
+    static constexpr size_t kDefaultReserve                  = 64;
+    alloc_transaction( const alloc_transaction& )            = delete;
+    alloc_transaction& operator=( const alloc_transaction& ) = delete;
+    explicit alloc_transaction( size_t reserve = kDefaultReserve ) noexcept
+    {
+        _active = _scope.reserve( reserve ) && ManagerT::begin_alloc_scope( _scope );
+    }
+    ~alloc_transaction() { (void)rollback(); }
+    template <typename T> pptr_t<T> allocate_typed( size_t count = 1 ) noexcept
+    {
+        return _active ? ManagerT::template allocate_typed<T>( count ) : pptr_t<T>();
+    }
+    template <typename T, typename... Args> pptr_t<T> create_typed( Args&&... args ) noexcept
+    {
+        return _active ? ManagerT::template create_typed<T>( static_cast<Args&&>( args )... ) : pptr_t<T>();
+    }
+    template <typename T> pptr_t<T> adopt( typed_guard<T, ManagerT>&& guard ) noexcept
+    {
+        if ( !_active || ( !guard.get().is_null() && !_scope.owns( guard.get().offset() ) &&
+                           !push_entry( _adopted, guard.get().offset(), &destroy_entry<T> ) ) )
+            return pptr_t<T>();
+        return guard.release();
+    }
+    template <typename T> bool deallocate_typed( pptr_t<T> p ) noexcept
+    {
+        return push_entry( _released, p.offset(), &deallocate_entry<T> );
+    }
+    template <typename T> bool destroy_typed( pptr_t<T> p ) noexcept
+    {
+        return push_entry( _released, p.offset(), &destroy_entry<T> );
+    }
+    template <typename T> bool set_domain_root( const char* name, pptr_t<T> root ) noexcept
+    {
+        if ( !_active || !detail::forest_domain_name_fits( name ) )
+            return false;
+        index_type idx = root.is_null() ? static_cast<index_type>( 0 ) : root.offset();
+        for ( auto& change : _roots )
+        {
+            if ( change.first == name )
+            {
+                change.second = idx;
+                return true;
+            }
+        }
+        try
+        {
+            _roots.emplace_back( name, idx );
+        }
+        catch ( ... )
+        {
+            return false;
+        }
+        return true;
+    }
+    template <typename T> bool set_root( pptr_t<T> root ) noexcept
+    {
+        return set_domain_root<T>( detail::kServiceNameDomainRoot, root );
+    }
+    bool commit() noexcept
+    {
+        if ( !_active || !_scope.reserve_commit( _released.size(), _roots.size() ) )
+            return false;
+        if ( !_roots.empty() )
+        {
+            std::vector<const char*> names;
+            std::vector<index_type>  roots;
+            try
+            {
+                names.reserve( _roots.size() );
+                roots.reserve( _roots.size() );
+            }
+            catch ( ... )
+            {
+                return false;
+            }
+            for ( const auto& change : _roots )
+            {
+                names.push_back( change.first.c_str() );
+                roots.push_back( change.second );
+            }
+            if ( !ManagerT::set_domain_roots( names.data(), roots.data(), names.size() ) )
+                return false;
+        }
+        for ( const auto& e : _released )
+            e.release( e.offset );
+        (void)ManagerT::commit_alloc_scope( _scope );
+        finish();
+        return true;
+    }
+    bool rollback() noexcept
+    {
+        if ( !_active )
+            return true;
+        _scope.rolling_back = true;
+        for ( size_t i = _adopted.size(); i > 0; --i )
+            _adopted[i - 1].release( _adopted[i - 1].offset );
+        const bool ok = ManagerT::rollback_alloc_scope( _scope );
+        finish();
+        return ok;
+    }
+    bool   active() const noexcept { return _active; }
+    size_t pending_allocations() const noexcept { return _scope.allocated.size() + _adopted.size(); }
+    size_t pending_releases() const noexcept { return _released.size(); }
+    size_t pending_roots() const noexcept { return _roots.size(); }
+    bool   empty() const noexcept { return pending_allocations() == 0 && _released.empty() && _roots.empty(); }
+
+  private:
+    struct entry
+    {
+        index_type offset;
+        void ( *release )( index_type ) noexcept;
+    };
+    detail::AllocScope<index_type>                  _scope;
+    bool                                            _active = false;
+    std::vector<entry>                              _adopted;
+    std::vector<entry>                              _released;
+    std::vector<std::pair<std::string, index_type>> _roots;
+    bool push_entry( std::vector<entry>& list, index_type offset, void ( *release )( index_type ) noexcept ) noexcept
+    {
+        if ( !_active || offset == 0 )
+            return false;
+        try
+        {
+            list.push_back( { offset, release } );
+        }
+        catch ( ... )
+        {
+            return false;
+        }
+        return true;
+    }
+    void finish() noexcept
+    {
+        _active = false;
+        _scope.clear();
+        _adopted.clear();
+        _released.clear();
+        _roots.clear();
+    }
+    template <typename T> static void deallocate_entry( index_type offset ) noexcept
+    {
+        ManagerT::deallocate_typed( pptr_t<T>( offset ) );
+    }
+    template <typename T> static void destroy_entry( index_type offset ) noexcept
+    {
+        typed_guard<T, ManagerT> guard{ pptr_t<T>( offset ) };
+    }
+};
+}
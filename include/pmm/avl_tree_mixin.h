@@ -276,6 +276,24 @@ template <typename PPtr> static PPtr avl_inorder_successor( PPtr cur ) noexcept
         cur = parent;
     }
 }
+template <typename PPtr> static PPtr avl_inorder_predecessor( PPtr cur ) noexcept
+{
+    if ( cur.is_null() )
+        return PPtr();
+    PPtr left = pptr_get_left( cur );
+    if ( !left.is_null() )
+        return avl_max_node( left );
+    while ( true )
+    {
+        PPtr parent = pptr_get_parent( cur );
+        if ( parent.is_null() )
+            return PPtr();
+        PPtr parent_right = pptr_get_right( parent );
+        if ( !parent_right.is_null() && parent_right.offset() == cur.offset() )
+            return parent;
+        cur = parent;
+    }
+}
 template <typename PPtr> static void avl_init_node( PPtr p ) noexcept
 {
     auto& tn         = p.tree_node_unchecked();
@@ -477,5 +495,94 @@ template <typename NodePPtr> struct AvlInorderIterator
         return *this;
     }
 };
+/*
+### pmm-detail-avlreverseinorderiterator
+*/
+template <typename NodePPtr> struct AvlReverseInorderIterator
+{
+    using index_type                     = typename NodePPtr::index_type;
+    using value_type                     = typename NodePPtr::element_type;
+    using pointer                        = NodePPtr;
+    static constexpr index_type no_block = NodePPtr::manager_type::address_traits::no_block;
+    index_type                  _current_idx;
+    AvlReverseInorderIterator() noexcept : _current_idx( static_cast<index_type>( 0 ) ) {}
+    explicit AvlReverseInorderIterator( index_type idx ) noexcept : _current_idx( idx ) {}
+    bool operator==( const AvlReverseInorderIterator& other ) const noexcept
+    {
+        return _current_idx == other._current_idx;
+    }
+    bool operator!=( const AvlReverseInorderIterator& other ) const noexcept
+    {
+        return _current_idx != other._current_idx;
+    }
+    NodePPtr operator*() const noexcept
+    {
+        if ( _current_idx == static_cast<index_type>( 0 ) || _current_idx == no_block )
+            return NodePPtr();
+        return NodePPtr( _current_idx );
+    }
+    AvlReverseInorderIterator& operator++() noexcept
+    {
+        if ( _current_idx == static_cast<index_type>( 0 ) || _current_idx == no_block )
+            return *this;
+        NodePPtr prev = avl_inorder_predecessor( NodePPtr( _current_idx ) );
+        _current_idx  = prev.is_null() ? static_cast<index_type>( 0 ) : prev.offset();
+        return *this;
+    }
+};
+inline constexpr size_t kAvlCursorMaxDepth = 96;
+template <typename PPtr> static void avl_prefetch_node( PPtr p ) noexcept
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+    if ( !p.is_null() )
+        __builtin_prefetch( &p.tree_node_unchecked(), 0, 1 );
+#else
+    (void)p;
+#endif
+}
+/*
+### pmm-detail-avlstackcursor
+*/
+template <typename NodePPtr> struct AvlStackCursor
+{
+    using index_type = typename NodePPtr::index_type;
+    index_type _stack[kAvlCursorMaxDepth];
+    size_t     _depth = 0;
+    bool       valid() const noexcept { return _depth != 0; }
+    NodePPtr   operator*() const noexcept { return _depth == 0 ? NodePPtr() : NodePPtr( _stack[_depth - 1] ); }
+    bool       push( NodePPtr p ) noexcept
+    {
+        if ( p.is_null() || _depth == kAvlCursorMaxDepth )
+            return false;
+        _stack[_depth++] = p.offset();
+        return true;
+    }
+    void push_left_spine( NodePPtr p ) noexcept
+    {
+        while ( push( p ) )
+            p = pptr_get_left( p );
+        prefetch_next();
+    }
+    void prefetch_next() const noexcept
+    {
+        if ( _depth == 0 )
+            return;
+        NodePPtr top( _stack[_depth - 1] );
+        avl_prefetch_node( pptr_get_right( top ) );
+        if ( _depth > 1 )
+            avl_prefetch_node( NodePPtr( _stack[_depth - 2] ) );
+    }
+    AvlStackCursor& operator++() noexcept
+    {
+        if ( _depth == 0 )
+            return *this;
+        NodePPtr right = pptr_get_right( NodePPtr( _stack[--_depth] ) );
+        if ( right.is_null() )
+            prefetch_next();
+        else
+            push_left_spine( right );
+        return *this;
+    }
+};
 }
 }
@@ -32,6 +32,7 @@ enum class ViolationType : uint8_t
     ForestDomainMissing,
     ForestDomainFlagsMissing,
     HeaderCorruption,
+    PageChecksumMismatch,
 };
 /*
 ## pmm-diagnosticaction
@@ -1,5 +1,6 @@
 #pragma once
 #include "pmm/address_traits.h"
+#include "pmm/types.h"
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -7,20 +8,25 @@
 namespace pmm::detail
 {
 inline constexpr size_t      kForestDomainNameCapacity     = 48;
-inline constexpr size_t      kMaxForestDomains             = 32;
+inline constexpr size_t      kForestDomainsPerPage         = 32;
 inline constexpr const char* kSystemDomainFreeTree         = "system/free_tree";
 inline constexpr const char* kSystemDomainSymbols          = "system/symbols";
 inline constexpr const char* kSystemDomainRegistry         = "system/domain_registry";
+inline constexpr const char* kSystemDomainSymbolIndex      = "system/symbol_index";
 inline constexpr const char* kSystemTypeForestRegistry     = "type/forest_registry";
 inline constexpr const char* kSystemTypeForestDomainRecord = "type/forest_domain_record";
 inline constexpr const char* kSystemTypePstringview        = "type/pstringview";
 inline constexpr const char* kServiceNameDomainRoot        = "service/domain_root";
 inline constexpr const char* kServiceNameDomainSymbol      = "service/domain_symbol";
 inline constexpr uint32_t    kForestRegistryMagic          = 0x50465247U;
-inline constexpr uint16_t    kForestRegistryVersion        = 1;
+inline constexpr uint32_t    kForestPageMagic              = 0x50465047U;
+inline constexpr uint16_t    kForestRegistryVersion        = 2;
 inline constexpr uint8_t     kForestBindingDirectRoot      = 0;
 inline constexpr uint8_t     kForestBindingFreeTree        = 1;
 inline constexpr uint8_t     kForestDomainFlagSystem       = 0x01;
+inline constexpr uint64_t    kSymbolIndexMinCapacity       = 64;
+inline constexpr uint64_t    kSymbolIndexMinSymbols        = 16;
+inline constexpr uint64_t    kDomainIndexMinCapacity       = 64;
 /*
 ### pmm-detail-forestdomainrecord
 */
@@ -50,13 +56,83 @@ template <typename AT> struct ForestDomainRegistry
     uint16_t               version;
     uint16_t               domain_count;
     index_type             next_binding_id;
-    ForestDomainRecord<AT> domains[kMaxForestDomains];
+    index_type             next_page;
+    index_type             tail_page;
+    index_type             index_offset;
+    ForestDomainRecord<AT> domains[kForestDomainsPerPage];
     constexpr ForestDomainRegistry() noexcept
         : magic( kForestRegistryMagic ), version( kForestRegistryVersion ), domain_count( 0 ), next_binding_id( 1 ),
-          domains{}
+          next_page( 0 ), tail_page( 0 ), index_offset( 0 ), domains{}
     {
     }
 };
+/*
+### pmm-detail-forestdomainpage
+*/
+template <typename AT> struct ForestDomainPage
+{
+    using index_type = typename AT::index_type;
+    uint32_t               magic;
+    uint16_t               domain_count;
+    uint16_t               reserved;
+    index_type             next_page;
+    ForestDomainRecord<AT> domains[kForestDomainsPerPage];
+    constexpr ForestDomainPage() noexcept
+        : magic( kForestPageMagic ), domain_count( 0 ), reserved( 0 ), next_page( 0 ), domains{}
+    {
+    }
+};
+/*
+### pmm-detail-domainindexheader
+*/
+struct DomainIndexHeader
+{
+    uint64_t capacity;
+    uint64_t count;
+};
+template <typename AT> struct DomainIndexSlot
+{
+    uint32_t                hash;
+    uint32_t                slot;
+    typename AT::index_type page;
+};
+/*
+### pmm-detail-domainrootcache
+*/
+template <typename AT> struct DomainRootCache
+{
+    typename AT::index_type* root  = nullptr;
+    uint64_t                 epoch = 0;
+};
+/*
+### pmm-detail-symbolindexheader
+*/
+struct SymbolIndexHeader
+{
+    uint64_t capacity;
+    uint64_t count;
+    uint64_t retry_at;
+};
+template <typename AT> struct SymbolIndexSlot
+{
+    uint32_t                hash;
+    typename AT::index_type symbol;
+};
+inline uint32_t symbol_hash( const char* s, size_t len ) noexcept
+{
+    return str_hash( s, len );
+}
+inline uint32_t forest_domain_name_hash( const char* name ) noexcept
+{
+    size_t len = 0;
+    while ( len < kForestDomainNameCapacity && name[len] != '\0' )
+        ++len;
+    return str_hash( name, len );
+}
+inline uint32_t forest_domain_binding_hash( uint64_t binding_id ) noexcept
+{
+    return static_cast<uint32_t>( ( binding_id * 0x9e3779b97f4a7c15ull ) >> 32 );
+}
 template <typename AT>
 inline bool forest_domain_name_equals( const ForestDomainRecord<AT>& rec, const char* name ) noexcept
 {
@@ -80,4 +156,5 @@ template <typename AT> inline bool forest_domain_name_copy( ForestDomainRecord<A
 }
 static_assert( std::is_trivially_copyable_v<ForestDomainRecord<DefaultAddressTraits>>, "" );
 static_assert( std::is_nothrow_default_constructible_v<ForestDomainRegistry<DefaultAddressTraits>>, "" );
+static_assert( std::is_nothrow_default_constructible_v<ForestDomainPage<DefaultAddressTraits>>, "" );
 }
@@ -1,10 +1,20 @@
 #pragma once
+#include "pmm/arena_internals.h"
+#include "pmm/block_state.h"
 #include "pmm/diagnostics.h"
+#include "pmm/page_watch.h"
 #include "pmm/types.h"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
 #include <string>
+#include <utility>
 #include <vector>
 #if defined( _WIN32 ) || defined( _WIN64 )
 #ifndef WIN32_LEAN_AND_MEAN
@@ -78,34 +88,60 @@ inline bool flush_parent_directory( const char* path )
     return ok;
 #endif
 }
-}
-template <typename MgrT> inline bool save_manager( const char* filename )
+template <typename MgrT, typename Fn> inline bool with_shared_image( Fn&& fn )
 {
-    using address_traits = typename MgrT::address_traits;
-    if ( filename == nullptr )
+    typename MgrT::thread_policy::shared_lock_type lock( MgrT::_mutex );
+    if ( !MgrT::is_initialized() )
         return false;
-    std::vector<uint8_t> snapshot;
+    const uint8_t* data  = MgrT::backend().base_ptr();
+    size_t         total = MgrT::backend().total_size();
+    if ( data == nullptr || total == 0 )
+        return false;
+    return fn( data, total );
+}
+template <typename MgrT> inline bool take_image_snapshot( std::vector<uint8_t>& snapshot )
+{
+    return with_shared_image<MgrT>(
+        [&]( const uint8_t* data, size_t total )
+        {
+            snapshot.assign( data, data + total );
+            return true;
+        } );
+}
+using byte_range = std::pair<size_t, size_t>;
+inline bool write_with_holes( std::FILE* f, const uint8_t* data, size_t size, const std::vector<byte_range>* holes )
+{
+    size_t pos = 0;
+    if ( holes != nullptr )
     {
-        typename MgrT::thread_policy::shared_lock_type lock( MgrT::_mutex );
-        if ( !MgrT::is_initialized() )
-            return false;
-        const uint8_t* data  = MgrT::backend().base_ptr();
-        size_t         total = MgrT::backend().total_size();
-        if ( data == nullptr || total == 0 )
-            return false;
-        snapshot.resize( total );
-        std::memcpy( snapshot.data(), data, total );
+        for ( const byte_range& hole : *holes )
+        {
+            if ( hole.first < pos || hole.second <= hole.first || hole.second >= size )
+                continue;
+            if ( std::fwrite( data + pos, 1, hole.first - pos, f ) != hole.first - pos )
+                return false;
+            for ( size_t gap = hole.second - hole.first; gap != 0; )
+            {
+                const size_t step = std::min<size_t>( gap, static_cast<size_t>( std::numeric_limits<long>::max() ) );
+                if ( std::fseek( f, static_cast<long>( step ), SEEK_CUR ) != 0 )
+                    return false;
+                gap -= step;
+            }
+            pos = hole.second;
+        }
     }
-    auto* hdr            = detail::manager_header_at<address_traits>( snapshot.data() );
-    hdr->crc32           = detail::compute_image_crc32<address_traits>( snapshot.data(), snapshot.size() );
+    return std::fwrite( data + pos, 1, size - pos, f ) == size - pos;
+}
+inline bool write_file_atomic( const char* filename, const uint8_t* data, size_t size,
+                               const std::vector<byte_range>* holes = nullptr )
+{
     std::string tmp_path = std::string( filename ) + ".tmp";
     std::FILE*  f        = std::fopen( tmp_path.c_str(), "wb" );
     if ( f == nullptr )
         return false;
-    size_t written = std::fwrite( snapshot.data(), 1, snapshot.size(), f );
-    bool   ok      = written == snapshot.size();
+    bool ok = write_with_holes( f, data, size, holes );
     if ( ok )
-        ok = detail::flush_file_to_storage( f );
+        ok = flush_file_to_storage( f );
     if ( std::fclose( f ) != 0 )
         ok = false;
     if ( !ok )
@@ -113,24 +149,15 @@ template <typename MgrT> inline bool save_manager( const char* filename )
         std::remove( tmp_path.c_str() );
         return false;
     }
-    if ( !detail::atomic_rename( tmp_path.c_str(), filename ) )
+    if ( !atomic_rename( tmp_path.c_str(), filename ) )
     {
         std::remove( tmp_path.c_str() );
         return false;
     }
-    if ( !detail::flush_parent_directory( filename ) )
-        return false;
-    return true;
+    return flush_parent_directory( filename );
 }
-template <typename MgrT> inline bool load_manager_from_file( const char* filename, VerifyResult& result )
+inline bool read_file_into( const char* filename, uint8_t* buf, size_t capacity, size_t& file_size )
 {
-    using address_traits = typename MgrT::address_traits;
-    if ( filename == nullptr )
-        return false;
-    uint8_t* buf  = MgrT::backend().base_ptr();
-    size_t   size = MgrT::backend().total_size();
-    if ( buf == nullptr || size < detail::kMinMemorySize )
-        return false;
     std::FILE* f = std::fopen( filename, "rb" );
     if ( f == nullptr )
         return false;
@@ -146,15 +173,313 @@ template <typename MgrT> inline bool load_manager_from_file( const char* filenam
         return false;
     }
     std::rewind( f );
-    size_t file_size = static_cast<size_t>( file_size_long );
-    if ( file_size > size )
+    file_size = static_cast<size_t>( file_size_long );
+    if ( file_size > capacity )
     {
         std::fclose( f );
         return false;
     }
     size_t read_bytes = std::fread( buf, 1, file_size, f );
     std::fclose( f );
-    if ( read_bytes != file_size )
+    return read_bytes == file_size;
+}
+inline constexpr size_t kSparseHoleAlignment = 4096;
+template <typename AT>
+inline size_t collect_free_payload_holes( const uint8_t* data, size_t length, std::vector<byte_range>& free_ranges,
+                                          std::vector<byte_range>& holes )
+{
+    constexpr size_t         kBlkBytes = static_cast<size_t>( kBlockHeaderGranules_t<AT> ) * AT::granule_size;
+    const ManagerHeader<AT>* hdr       = manager_header_at<AT>( data );
+    size_t                   skipped   = 0;
+    bool                     ok        = true;
+    free_ranges.clear();
+    holes.clear();
+    for_each_physical_block<AT, true>(
+        ConstArenaView<AT>( data, hdr ),
+        [&]( typename AT::index_type idx, const uint8_t* blk ) noexcept
+        {
+            if ( !BlockStateBase<AT>::is_free_raw( blk ) )
+                return true;
+            typename AT::index_type next  = BlockStateBase<AT>::get_next_offset( blk );
+            size_t                  begin = static_cast<size_t>( idx ) * AT::granule_size + kBlkBytes;
+            size_t                  end   = next == AT::no_block ? length
+                                                                 : static_cast<size_t>( next ) * AT::granule_size;
+            if ( end > length || begin >= end )
+                return true;
+            size_t hole_begin = ( begin + kSparseHoleAlignment - 1 ) / kSparseHoleAlignment * kSparseHoleAlignment;
+            size_t hole_end   = std::min( end / kSparseHoleAlignment * kSparseHoleAlignment, length - 1 );
+            try
+            {
+                free_ranges.emplace_back( begin, end );
+                if ( hole_begin < hole_end )
+                    holes.emplace_back( hole_begin, hole_end );
+            }
+            catch ( ... )
+            {
+                ok = false;
+                return false;
+            }
+            skipped += hole_begin < hole_end ? hole_end - hole_begin : 0;
+            return true;
+        } );
+    if ( !ok )
+        throw std::bad_alloc();
+    return skipped;
+}
+template <typename AT>
+inline uint32_t compute_sparse_image_crc32( const uint8_t* data, size_t length, const std::vector<byte_range>& holes ) noexcept
+{
+    constexpr size_t kCrcOffset = manager_header_offset_bytes_v<AT> + offsetof( ManagerHeader<AT>, crc32 );
+    constexpr size_t kAfterCrc  = kCrcOffset + sizeof( uint32_t );
+    uint32_t         crc        = 0xFFFFFFFFU;
+    size_t           pos        = 0;
+    auto             feed       = [&]( size_t end )
+    {
+        for ( ; pos < end; ++pos )
+            crc = crc32_accumulate_byte( crc, pos >= kCrcOffset && pos < kAfterCrc ? uint8_t{ 0 } : data[pos] );
+    };
+    for ( const byte_range& hole : holes )
+    {
+        if ( hole.first < pos || hole.second <= hole.first || hole.second >= length )
+            continue;
+        feed( hole.first );
+        crc = crc32_accumulate_zeros( crc, hole.second - hole.first );
+        pos = hole.second;
+    }
+    feed( length );
+    return crc ^ 0xFFFFFFFFU;
+}
+inline constexpr uint32_t kImagePageTableMagic = 0x504D5047U;
+inline constexpr size_t   kDefaultImagePageSize = 64 * 1024;
+struct ImagePageTableHeader
+{
+    uint32_t magic;
+    uint32_t page_size;
+    uint64_t image_size;
+    uint64_t page_count;
+    uint32_t merkle_root;
+    uint32_t table_crc;
+};
+template <typename AT>
+inline uint32_t compute_image_page_crc32( const uint8_t* data, size_t length, size_t page, size_t page_size ) noexcept
+{
+    constexpr size_t kCrcOffset = manager_header_offset_bytes_v<AT> + offsetof( ManagerHeader<AT>, crc32 );
+    size_t           begin      = page * page_size;
+    size_t           end        = std::min( length, begin + page_size );
+    uint32_t         crc        = 0xFFFFFFFFU;
+    for ( size_t i = begin; i < end; ++i )
+    {
+        bool in_crc = i >= kCrcOffset && i < kCrcOffset + sizeof( uint32_t );
+        crc         = crc32_accumulate_byte( crc, in_crc ? 0x00U : data[i] );
+    }
+    return crc ^ 0xFFFFFFFFU;
+}
+inline uint32_t compute_merkle_root( const uint32_t* leaves, size_t count )
+{
+    if ( count == 0 )
+        return 0;
+    std::vector<uint32_t> level( leaves, leaves + count );
+    while ( level.size() > 1 )
+    {
+        size_t parents = ( level.size() + 1 ) / 2;
+        for ( size_t i = 0; i < parents; ++i )
+        {
+            if ( 2 * i + 1 >= level.size() )
+            {
+                level[i] = level[2 * i];
+                continue;
+            }
+            uint8_t pair[8];
+            std::memcpy( pair, &level[2 * i], sizeof( uint32_t ) );
+            std::memcpy( pair + 4, &level[2 * i + 1], sizeof( uint32_t ) );
+            level[i] = compute_crc32( pair, sizeof( pair ) );
+        }
+        level.resize( parents );
+    }
+    return level[0];
+}
+}
+/*
+## pmm-imagepagetable
+req: feat-004, fr-014, fr-024, qa-rec-001
+*/
+struct ImagePageTable : detail::PageWatch
+{
+    size_t                page_size   = detail::kDefaultImagePageSize;
+    uint64_t              image_size  = 0;
+    uint32_t              merkle_root = 0;
+    std::vector<uint32_t> page_crc;
+    size_t                bad_pages = 0;
+    template <typename AT> void build( const uint8_t* data, size_t length )
+    {
+        image_size = length;
+        page_crc.resize( ( length + page_size - 1 ) / page_size );
+        for ( size_t page = 0; page < page_crc.size(); ++page )
+            page_crc[page] = detail::compute_image_page_crc32<AT>( data, length, page, page_size );
+        merkle_root = detail::compute_merkle_root( page_crc.data(), page_crc.size() );
+    }
+    template <typename AT> size_t verify( const uint8_t* data, size_t length, VerifyResult& result ) const
+    {
+        size_t bad = 0;
+        for ( size_t page = 0; page < page_crc.size(); ++page )
+            bad += verify_page<AT>( data, length, page, &result ) ? 0 : 1;
+        return bad;
+    }
+    template <typename AT>
+    bool verify_page( const uint8_t* data, size_t length, size_t page, VerifyResult* result ) const noexcept
+    {
+        uint32_t actual = detail::compute_image_page_crc32<AT>( data, length, page, page_size );
+        if ( page < page_crc.size() && actual == page_crc[page] )
+            return true;
+        if ( result != nullptr )
+            result->add( ViolationType::PageChecksumMismatch, DiagnosticAction::Aborted, page,
+                         page < page_crc.size() ? page_crc[page] : 0, actual );
+        return false;
+    }
+    template <typename AT>
+    static bool verify_pending( detail::PageWatch& watch, const uint8_t* base, size_t length, size_t page ) noexcept
+    {
+        auto& table = static_cast<ImagePageTable&>( watch );
+        if ( table.verify_page<AT>( base, length, page, nullptr ) )
+            return true;
+        std::atomic_ref<size_t>( table.bad_pages ).fetch_add( 1, std::memory_order_relaxed );
+        std::atomic_ref<uint64_t>( table.pending[page / 64] ).fetch_or( uint64_t{ 1 } << ( page % 64 ),
+                                                                        std::memory_order_relaxed );
+        return false;
+    }
+    void append_to( std::vector<uint8_t>& image ) const
+    {
+        detail::ImagePageTableHeader th{};
+        const size_t                 table_bytes = page_crc.size() * sizeof( uint32_t );
+        th.magic                                 = detail::kImagePageTableMagic;
+        th.page_size                             = static_cast<uint32_t>( page_size );
+        th.image_size                            = image_size;
+        th.page_count                            = page_crc.size();
+        th.merkle_root                           = merkle_root;
+        th.table_crc = detail::compute_crc32( reinterpret_cast<const uint8_t*>( page_crc.data() ), table_bytes );
+        const size_t at = image.size();
+        image.resize( at + table_bytes + sizeof( th ) );
+        if ( table_bytes != 0 )
+            std::memcpy( image.data() + at, page_crc.data(), table_bytes );
+        std::memcpy( image.data() + at + table_bytes, &th, sizeof( th ) );
+    }
+    bool read_from( const char* filename, uint8_t* buf, size_t capacity )
+    {
+        detail::ImagePageTableHeader th{};
+        std::FILE*                   f = std::fopen( filename, "rb" );
+        if ( f == nullptr )
+            return false;
+        long file_size = std::fseek( f, 0, SEEK_END ) == 0 ? std::ftell( f ) : -1;
+        bool ok        = file_size >= static_cast<long>( sizeof( th ) ) &&
+                  std::fseek( f, file_size - static_cast<long>( sizeof( th ) ), SEEK_SET ) == 0 &&
+                  std::fread( &th, sizeof( th ), 1, f ) == 1 && th.magic == detail::kImagePageTableMagic &&
+                  std::has_single_bit( th.page_size ) && th.image_size <= capacity &&
+                  th.page_count == ( th.image_size + th.page_size - 1 ) / th.page_size &&
+                  th.image_size + th.page_count * sizeof( uint32_t ) + sizeof( th ) ==
+                      static_cast<uint64_t>( file_size );
+        if ( ok )
+        {
+            page_crc.resize( static_cast<size_t>( th.page_count ) );
+            std::rewind( f );
+            ok = std::fread( buf, 1, static_cast<size_t>( th.image_size ), f ) == th.image_size &&
+                 ( page_crc.empty() ||
+                   std::fread( page_crc.data(), sizeof( uint32_t ), page_crc.size(), f ) == page_crc.size() );
+        }
+        std::fclose( f );
+        if ( !ok || th.table_crc != detail::compute_crc32( reinterpret_cast<const uint8_t*>( page_crc.data() ),
+                                                           page_crc.size() * sizeof( uint32_t ) ) )
+            return false;
+        page_size   = th.page_size;
+        image_size  = th.image_size;
+        merkle_root = th.merkle_root;
+        return merkle_root == detail::compute_merkle_root( page_crc.data(), page_crc.size() );
+    }
+};
+template <typename MgrT> inline bool save_manager( const char* filename )
+{
+    using address_traits = typename MgrT::address_traits;
+    if ( filename == nullptr )
+        return false;
+    std::vector<uint8_t> snapshot;
+    if ( !detail::take_image_snapshot<MgrT>( snapshot ) )
+        return false;
+    auto* hdr  = detail::manager_header_at<address_traits>( snapshot.data() );
+    hdr->crc32 = detail::compute_image_crc32<address_traits>( snapshot.data(), snapshot.size() );
+    return detail::write_file_atomic( filename, snapshot.data(), snapshot.size() );
+}
+template <typename MgrT> inline bool save_manager_sparse( const char* filename, size_t* skipped_bytes = nullptr )
+{
+    using address_traits = typename MgrT::address_traits;
+    if ( filename == nullptr )
+        return false;
+    std::unique_ptr<uint8_t[]>      snapshot;
+    size_t                          size    = 0;
+    size_t                          skipped = 0;
+    std::vector<detail::byte_range> free_ranges;
+    std::vector<detail::byte_range> holes;
+    if ( !detail::with_shared_image<MgrT>(
+             [&]( const uint8_t* data, size_t total )
+             {
+                 skipped  = detail::collect_free_payload_holes<address_traits>( data, total, free_ranges, holes );
+                 snapshot = std::make_unique_for_overwrite<uint8_t[]>( total );
+                 size     = total;
+                 size_t pos  = 0;
+                 size_t hole = 0;
+                 for ( const detail::byte_range& range : free_ranges )
+                 {
+                     std::memcpy( snapshot.get() + pos, data + pos, range.first - pos );
+                     size_t zero = range.first;
+                     if ( hole < holes.size() && holes[hole].first >= range.first && holes[hole].second <= range.second )
+                     {
+                         std::memset( snapshot.get() + zero, 0, holes[hole].first - zero );
+                         zero = holes[hole++].second;
+                     }
+                     std::memset( snapshot.get() + zero, 0, range.second - zero );
+                     pos = range.second;
+                 }
+                 std::memcpy( snapshot.get() + pos, data + pos, total - pos );
+                 return true;
+             } ) )
+        return false;
+    auto* hdr  = detail::manager_header_at<address_traits>( snapshot.get() );
+    hdr->crc32 = detail::compute_sparse_image_crc32<address_traits>( snapshot.get(), size, holes );
+    if ( skipped_bytes != nullptr )
+        *skipped_bytes = skipped;
+    return detail::write_file_atomic( filename, snapshot.get(), size, &holes );
+}
+template <typename MgrT> inline bool save_manager_paged( const char* filename, ImagePageTable& table )
+{
+    using address_traits = typename MgrT::address_traits;
+    if ( filename == nullptr || !std::has_single_bit( table.page_size ) )
+        return false;
+    if ( table.detach != nullptr && table.page_shift != static_cast<unsigned>( std::countr_zero( table.page_size ) ) )
+        table.detach( table );
+    std::vector<uint8_t> snapshot;
+    if ( !detail::with_shared_image<MgrT>(
+             [&]( const uint8_t* data, size_t total )
+             {
+                 snapshot.reserve( total + ( total / table.page_size + 1 ) * sizeof( uint32_t ) +
+                                   sizeof( detail::ImagePageTableHeader ) );
+                 snapshot.assign( data, data + total );
+                 return true;
+             } ) )
+        return false;
+    table.build<address_traits>( snapshot.data(), snapshot.size() );
+    detail::manager_header_at<address_traits>( snapshot.data() )->crc32 = table.merkle_root;
+    table.append_to( snapshot );
+    return detail::write_file_atomic( filename, snapshot.data(), snapshot.size() );
+}
+template <typename MgrT> inline bool load_manager_from_file( const char* filename, VerifyResult& result )
+{
+    using address_traits = typename MgrT::address_traits;
+    if ( filename == nullptr )
+        return false;
+    uint8_t* buf  = MgrT::backend().base_ptr();
+    size_t   size = MgrT::backend().total_size();
+    if ( buf == nullptr || size < detail::kMinMemorySize )
+        return false;
+    size_t file_size = 0;
+    if ( !detail::read_file_into( filename, buf, size, file_size ) )
         return false;
     constexpr size_t kHdrOffset = detail::manager_header_offset_bytes_v<address_traits>;
     if ( file_size >= kHdrOffset + sizeof( detail::ManagerHeader<address_traits> ) )
@@ -171,4 +496,80 @@ template <typename MgrT> inline bool load_manager_from_file( const char* filenam
     }
     return MgrT::load( result );
 }
+template <typename MgrT>
+inline bool load_manager_from_file_paged( const char* filename, VerifyResult& result, ImagePageTable* out = nullptr )
+{
+    using address_traits = typename MgrT::address_traits;
+    if ( filename == nullptr )
+        return false;
+    uint8_t* buf  = MgrT::backend().base_ptr();
+    size_t   size = MgrT::backend().total_size();
+    if ( buf == nullptr || size < detail::kMinMemorySize )
+        return false;
+    constexpr size_t kMinImage = detail::manager_header_offset_bytes_v<address_traits> +
+                                 sizeof( detail::ManagerHeader<address_traits> );
+    constexpr size_t kBlkBytes = detail::manager_header_offset_bytes_v<address_traits>;
+    ImagePageTable   local;
+    ImagePageTable&  table = out != nullptr ? *out : local;
+    if ( table.detach != nullptr )
+        table.detach( table );
+    bool ok = table.read_from( filename, buf, size ) && table.image_size >= kMinImage &&
+              detail::manager_header_at<address_traits>( buf )->crc32 == table.merkle_root;
+    const size_t          length = static_cast<size_t>( table.image_size );
+    std::vector<uint64_t> checked( ( table.page_crc.size() + 63 ) / 64, 0 );
+    auto                  check = [&]( size_t begin, size_t end )
+    {
+        for ( size_t page = begin / table.page_size; ok && page <= ( end - 1 ) / table.page_size; ++page )
+        {
+            if ( ( checked[page / 64] >> ( page % 64 ) ) & 1 )
+                continue;
+            checked[page / 64] |= uint64_t{ 1 } << ( page % 64 );
+            ok = table.verify_page<address_traits>( buf, length, page, &result );
+        }
+        return ok;
+    };
+    if ( ok && out == nullptr )
+        ok = table.verify<address_traits>( buf, length, result ) == 0;
+    else if ( ok && check( 0, kMinImage ) )
+    {
+        auto idx = detail::manager_header_at<address_traits>( buf )->first_block_offset;
+        for ( size_t hops = 0; idx != address_traits::no_block && hops <= length / address_traits::granule_size;
+              ++hops )
+        {
+            const size_t off = static_cast<size_t>( idx ) * address_traits::granule_size;
+            if ( off > length - kBlkBytes || !check( off, off + kBlkBytes ) )
+                break;
+            const size_t end = off + kBlkBytes +
+                               static_cast<size_t>( BlockStateBase<address_traits>::get_weight( buf + off ) ) *
+                                   address_traits::granule_size;
+            if ( BlockStateBase<address_traits>::get_node_type( buf + off ) == NodeType::ReadOnlyLocked &&
+                 ( end > length || !check( off, end ) ) )
+                break;
+            idx = BlockStateBase<address_traits>::get_next_offset( buf + off );
+        }
+    }
+    if ( ok && out != nullptr )
+    {
+        table.page_shift = static_cast<unsigned>( std::countr_zero( table.page_size ) );
+        table.pending.assign( checked.size(), 0 );
+        for ( size_t page = 0; page < table.page_crc.size(); ++page )
+            table.pending[page / 64] |= ( ~checked[page / 64] ) & ( uint64_t{ 1 } << ( page % 64 ) );
+        table.check_page = &ImagePageTable::verify_pending<address_traits>;
+        table.bad_pages  = 0;
+        ok               = MgrT::attach_page_watch( table );
+    }
+    if ( !ok )
+    {
+        MgrT::set_last_error( PmmError::CrcMismatch );
+        MgrT::logging_policy::on_corruption_detected( PmmError::CrcMismatch );
+        return false;
+    }
+    if ( !MgrT::load( result ) )
+    {
+        if ( table.detach != nullptr )
+            table.detach( table );
+        return false;
+    }
+    return true;
+}
 }
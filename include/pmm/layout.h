@@ -81,12 +81,20 @@ template <typename ManagerAccess> struct ManagerLayoutOps
             return false;
         if ( !backend.resize_to( *target_size ) )
             return false;
-        uint8_t* new_base = backend.base_ptr();
-        size_t   new_size = backend.total_size();
-        if ( new_base == nullptr || new_size <= old_size )
+        if ( backend.base_ptr() == nullptr || backend.total_size() <= old_size )
+            return false;
+        logging_policy::on_expand( old_size, backend.total_size() );
+        return adopt_tail( backend );
+    }
+    static bool adopt_tail( storage_backend& backend ) noexcept
+    {
+        static constexpr size_t        kGranSz  = address_traits::granule_size;
+        uint8_t*                       new_base = backend.base_ptr();
+        size_t                         new_size = backend.total_size();
+        ManagerHeader<address_traits>* hdr      = ManagerAccess::get_header( new_base );
+        size_t                         old_size = hdr->total_size;
+        if ( new_size <= old_size )
             return false;
-        logging_policy::on_expand( old_size, new_size );
-        hdr                     = ManagerAccess::get_header( new_base );
         auto extra_idx_opt      = byte_off_to_idx_checked<address_traits>( old_size );
         auto new_total_gran_opt = byte_off_to_idx_checked<address_traits>( new_size );
         if ( !extra_idx_opt.has_value() || !new_total_gran_opt.has_value() )
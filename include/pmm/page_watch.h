@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+namespace pmm
+{
+namespace detail
+{
+/*
+### pmm-detail-pagewatch
+req: feat-004, fr-014, qa-rec-001
+*/
+struct PageWatch
+{
+    using verify_fn = bool ( * )( PageWatch&, const uint8_t* base, size_t length, size_t page ) noexcept;
+    using detach_fn = void ( * )( PageWatch& ) noexcept;
+    unsigned              page_shift = 16;
+    std::vector<uint64_t> pending;
+    verify_fn             check_page = nullptr;
+    detach_fn             detach     = nullptr;
+    PageWatch*            next       = nullptr;
+    PageWatch()                              = default;
+    PageWatch( const PageWatch& )            = delete;
+    PageWatch& operator=( const PageWatch& ) = delete;
+    ~PageWatch()
+    {
+        if ( detach != nullptr )
+            detach( *this );
+    }
+    bool touch( const uint8_t* base, size_t length, size_t begin, size_t end ) noexcept
+    {
+        bool ok = true;
+        for ( size_t page = begin >> page_shift; begin < end && page <= ( end - 1 ) >> page_shift; ++page )
+        {
+            const size_t   w   = page / 64;
+            const uint64_t bit = uint64_t{ 1 } << ( page % 64 );
+            if ( w >= pending.size() )
+                break;
+            if ( ( std::atomic_ref<uint64_t>( pending[w] ).fetch_and( ~bit, std::memory_order_acq_rel ) & bit ) != 0 )
+                ok = check_page( *this, base, length, page ) && ok;
+        }
+        return ok;
+    }
+};
+/*
+### pmm-detail-pagewatchlatch
+req: feat-004, fr-014, qa-rec-001
+*/
+struct PageWatchLatch
+{
+    static constexpr uint32_t kWriter = uint32_t{ 1 } << 31;
+    std::atomic<uint32_t>     state{ 0 };
+    void                      lock_shared() noexcept
+    {
+        for ( ;; )
+        {
+            uint32_t s = state.load( std::memory_order_relaxed );
+            if ( ( s & kWriter ) == 0 &&
+                 state.compare_exchange_weak( s, s + 1, std::memory_order_acquire, std::memory_order_relaxed ) )
+                return;
+        }
+    }
+    void unlock_shared() noexcept { state.fetch_sub( 1, std::memory_order_release ); }
+    void lock() noexcept
+    {
+        while ( ( state.fetch_or( kWriter, std::memory_order_acquire ) & kWriter ) != 0 )
+        {
+        }
+        while ( state.load( std::memory_order_acquire ) != kWriter )
+        {
+        }
+    }
+    void unlock() noexcept { state.fetch_and( ~kWriter, std::memory_order_release ); }
+};
+}
+}
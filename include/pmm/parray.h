@@ -13,14 +13,16 @@ namespace pmm
 ## pmm-parray
 req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
 */
-template <typename T, typename ManagerT> struct parray
+template <typename T, typename ManagerT, size_t GrowNum = 2, size_t GrowDen = 1> struct parray
 {
     static_assert( std::is_trivially_copyable_v<T>, "" );
+    static_assert( GrowDen >= 1 && GrowNum > GrowDen, "parray: growth factor must be greater than 1" );
     using manager_type = ManagerT;
     using index_type   = typename ManagerT::index_type;
     using value_type   = T;
-    uint32_t   _size;
-    uint32_t   _capacity;
+    using size_type    = std::conditional_t<( sizeof( index_type ) > sizeof( uint32_t ) ), uint64_t, uint32_t>;
+    size_type  _size;
+    size_type  _capacity;
     index_type _data_idx;
     parray() noexcept : _size( 0 ), _capacity( 0 ), _data_idx( detail::kNullIdx_v<typename ManagerT::address_traits> )
     {
@@ -82,15 +84,15 @@ template <typename T, typename ManagerT> struct parray
     }
     bool reserve( size_t n ) noexcept
     {
-        if ( n > static_cast<size_t>( std::numeric_limits<uint32_t>::max() ) )
+        if ( n > static_cast<size_t>( std::numeric_limits<size_type>::max() ) )
             return false;
-        return ensure_capacity( static_cast<uint32_t>( n ) );
+        return ensure_capacity( static_cast<size_type>( n ) );
     }
     bool resize( size_t n ) noexcept
     {
-        if ( n > static_cast<size_t>( std::numeric_limits<uint32_t>::max() ) )
+        if ( n > static_cast<size_t>( std::numeric_limits<size_type>::max() ) )
             return false;
-        auto new_size = static_cast<uint32_t>( n );
+        auto new_size = static_cast<size_type>( n );
         if ( new_size > _size )
         {
             if ( !ensure_capacity( new_size ) )
@@ -130,6 +132,73 @@ template <typename T, typename ManagerT> struct parray
         --_size;
         return true;
     }
+/*
+### pmm-parray-append_range
+*/
+    bool append_range( const T* src, size_t n ) noexcept
+    {
+        return insert_range( static_cast<size_t>( _size ), src, n );
+    }
+    bool assign( const T* src, size_t n ) noexcept
+    {
+        if ( n > static_cast<size_t>( std::numeric_limits<size_type>::max() ) )
+            return false;
+        size_t     src_off = 0;
+        const bool aliased = source_offset( src, n, src_off );
+        if ( !ensure_capacity( static_cast<size_type>( n ) ) )
+            return false;
+        T* d = resolve_data();
+        if ( n > 0 && d == nullptr )
+            return false;
+        if ( n > 0 )
+            std::memmove( d, aliased ? d + src_off : src, n * sizeof( T ) );
+        _size = static_cast<size_type>( n );
+        return true;
+    }
+    bool insert_range( size_t index, const T* src, size_t n ) noexcept
+    {
+        const size_t size = static_cast<size_t>( _size );
+        if ( index > size || n > static_cast<size_t>( std::numeric_limits<size_type>::max() ) - size )
+            return false;
+        if ( n == 0 )
+            return true;
+        size_t     src_off = 0;
+        const bool aliased = source_offset( src, n, src_off );
+        if ( !ensure_capacity( static_cast<size_type>( size + n ) ) )
+            return false;
+        T* d = resolve_data();
+        if ( d == nullptr )
+            return false;
+        if ( index < size )
+            std::memmove( d + index + n, d + index, ( size - index ) * sizeof( T ) );
+        if ( !aliased )
+        {
+            std::memcpy( d + index, src, n * sizeof( T ) );
+        }
+        else
+        {
+            const size_t head = src_off < index ? ( index - src_off < n ? index - src_off : n ) : 0;
+            std::memmove( d + index, d + src_off, head * sizeof( T ) );
+            std::memmove( d + index + head, d + ( src_off + head < index ? src_off + head : src_off + head + n ),
+                          ( n - head ) * sizeof( T ) );
+        }
+        _size = static_cast<size_type>( size + n );
+        return true;
+    }
+    bool erase_range( size_t index, size_t n ) noexcept
+    {
+        const size_t size = static_cast<size_t>( _size );
+        if ( index > size || n > size - index )
+            return false;
+        if ( n == 0 )
+            return true;
+        T* d = resolve_data();
+        if ( d == nullptr )
+            return false;
+        std::memmove( d + index, d + index + n, ( size - index - n ) * sizeof( T ) );
+        _size = static_cast<size_type>( size - n );
+        return true;
+    }
     void clear() noexcept { _size = 0; }
     void free_data() noexcept
     {
@@ -159,11 +228,21 @@ template <typename T, typename ManagerT> struct parray
 
   private:
     T*   resolve_data() const noexcept { return pmm::pptr<T, ManagerT>( _data_idx ).resolve_unchecked(); }
-    bool ensure_capacity( uint32_t required ) noexcept
+    bool source_offset( const T* src, size_t n, size_t& off ) const noexcept
+    {
+        const T* d = resolve_data();
+        if ( d == nullptr || n == 0 || src < d || src >= d + _size )
+            return false;
+        off = static_cast<size_t>( src - d );
+        return true;
+    }
+    bool ensure_capacity( size_type required ) noexcept
     {
         if ( required <= _capacity )
             return true;
-        uint32_t new_cap = _capacity * 2;
+        size_type new_cap = _capacity > std::numeric_limits<size_type>::max() / GrowNum
+                                ? std::numeric_limits<size_type>::max()
+                                : static_cast<size_type>( _capacity * GrowNum / GrowDen );
         if ( new_cap < required )
             new_cap = required;
         if ( new_cap < 4 )
@@ -180,7 +259,8 @@ template <typename T, typename ManagerT> struct parray
         return true;
     }
 };
-template <typename T, typename ManagerT> struct node_type_for<parray<T, ManagerT>>
+template <typename T, typename ManagerT, size_t GrowNum, size_t GrowDen>
+struct node_type_for<parray<T, ManagerT, GrowNum, GrowDen>>
 {
     static constexpr NodeType value = NodeType::PArray;
 };
@@ -0,0 +1,727 @@
+#pragma once
+#include "pmm/parray.h"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define PMM_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+namespace pmm
+{
+enum class SimdLevel : uint8_t
+{
+    Scalar = 0,
+    Avx2   = 1,
+    Avx512 = 2,
+};
+enum class CompareOp : uint8_t
+{
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Equal,
+    NotEqual,
+};
+/*
+## pmm-kerneloptions
+req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
+*/
+struct KernelOptions
+{
+    SimdLevel max_level = SimdLevel::Avx512;
+    size_t    threads   = 1;
+    size_t    min_chunk = size_t{ 1 } << 16;
+};
+inline SimdLevel simd_level_supported() noexcept
+{
+#if defined( PMM_KERNELS_X86 )
+    static const SimdLevel level = []
+    {
+        __builtin_cpu_init();
+        if ( __builtin_cpu_supports( "avx512f" ) )
+            return SimdLevel::Avx512;
+        if ( __builtin_cpu_supports( "avx2" ) )
+            return SimdLevel::Avx2;
+        return SimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+inline constexpr size_t bitmask_words( size_t n ) noexcept
+{
+    return ( n + 63 ) / 64;
+}
+namespace detail
+{
+inline constexpr size_t kKernelMaxThreads = 64;
+inline SimdLevel        kernel_level( const KernelOptions& opt ) noexcept
+{
+    const SimdLevel hw = simd_level_supported();
+    return opt.max_level < hw ? opt.max_level : hw;
+}
+template <typename FnT> size_t kernel_chunks( size_t n, const KernelOptions& opt, size_t align, FnT&& fn ) noexcept
+{
+    if ( n == 0 )
+        return 0;
+    size_t threads = opt.threads == 0 ? 1 : ( opt.threads > kKernelMaxThreads ? kKernelMaxThreads : opt.threads );
+    if ( opt.min_chunk > 0 && n / opt.min_chunk < threads )
+        threads = n / opt.min_chunk > 0 ? n / opt.min_chunk : 1;
+    size_t chunk = ( n + threads - 1 ) / threads;
+    chunk        = ( chunk + align - 1 ) / align * align;
+    const size_t count = ( n + chunk - 1 ) / chunk;
+    std::thread  workers[kKernelMaxThreads];
+    for ( size_t c = 1; c < count; ++c )
+    {
+        const size_t end = ( c + 1 ) * chunk < n ? ( c + 1 ) * chunk : n;
+        try
+        {
+            workers[c] = std::thread( std::ref( fn ), c, c * chunk, end );
+        }
+        catch ( ... )
+        {
+            fn( c, c * chunk, end );
+        }
+    }
+    fn( size_t{ 0 }, size_t{ 0 }, chunk < n ? chunk : n );
+    for ( size_t c = 1; c < count; ++c )
+    {
+        if ( workers[c].joinable() )
+            workers[c].join();
+    }
+    return count;
+}
+template <typename T> bool kernel_match( T x, CompareOp op, T v ) noexcept
+{
+    switch ( op )
+    {
+    case CompareOp::Less:
+        return x < v;
+    case CompareOp::LessEqual:
+        return x <= v;
+    case CompareOp::Greater:
+        return x > v;
+    case CompareOp::GreaterEqual:
+        return x >= v;
+    case CompareOp::Equal:
+        return x == v;
+    default:
+        return x != v;
+    }
+}
+template <typename T> T kernel_sum_scalar( const T* p, size_t n ) noexcept
+{
+    if constexpr ( std::is_integral_v<T> && std::is_signed_v<T> )
+    {
+        using U = std::make_unsigned_t<T>;
+        U acc   = 0;
+        for ( size_t i = 0; i < n; ++i )
+            acc = static_cast<U>( acc + static_cast<U>( p[i] ) );
+        return static_cast<T>( acc );
+    }
+    else
+    {
+        T acc = T{};
+        for ( size_t i = 0; i < n; ++i )
+            acc += p[i];
+        return acc;
+    }
+}
+template <typename T> void kernel_minmax_scalar( const T* p, size_t n, T& lo, T& hi ) noexcept
+{
+    for ( size_t i = 0; i < n; ++i )
+    {
+        if ( p[i] < lo )
+            lo = p[i];
+        if ( hi < p[i] )
+            hi = p[i];
+    }
+}
+template <typename T> uint64_t kernel_mask_scalar( const T* p, size_t n, CompareOp op, T v ) noexcept
+{
+    uint64_t bits = 0;
+    for ( size_t i = 0; i < n; ++i )
+        bits |= static_cast<uint64_t>( kernel_match( p[i], op, v ) ) << i;
+    return bits;
+}
+#if defined( PMM_KERNELS_X86 )
+/*
+#### pmm-detail-kernels-simd
+*/
+template <typename T, size_t Bytes> struct kernel_vec
+{
+    typedef T               type __attribute__( ( vector_size( Bytes ) ) );
+    static constexpr size_t lanes = Bytes / sizeof( T );
+};
+template <typename T, size_t Bytes>
+[[gnu::always_inline]] inline void kernel_load( typename kernel_vec<T, Bytes>::type& v, const T* p ) noexcept
+{
+    std::memcpy( &v, p, sizeof( v ) );
+}
+template <typename T, size_t Bytes> [[gnu::always_inline]] inline T kernel_sum_vec( const T* p, size_t n ) noexcept
+{
+    using A = typename std::conditional_t<std::is_integral_v<T>, std::make_unsigned<T>, std::type_identity<T>>::type;
+    constexpr size_t                    kW = kernel_vec<A, Bytes>::lanes;
+    typename kernel_vec<A, Bytes>::type a0{}, a1{}, v0, v1;
+    size_t                              i = 0;
+    for ( ; i + 2 * kW <= n; i += 2 * kW )
+    {
+        kernel_load<A, Bytes>( v0, reinterpret_cast<const A*>( p + i ) );
+        kernel_load<A, Bytes>( v1, reinterpret_cast<const A*>( p + i + kW ) );
+        a0 += v0;
+        a1 += v1;
+    }
+    T lanes[kW + 1];
+    for ( size_t l = 0; l < kW; ++l )
+        lanes[l] = static_cast<T>( a0[l] + a1[l] );
+    lanes[kW] = kernel_sum_scalar( p + i, n - i );
+    return kernel_sum_scalar( lanes, kW + 1 );
+}
+template <typename T, size_t Bytes>
+[[gnu::always_inline]] inline void kernel_minmax_vec( const T* p, size_t n, T& lo, T& hi ) noexcept
+{
+    constexpr size_t                    kW = kernel_vec<T, Bytes>::lanes;
+    typename kernel_vec<T, Bytes>::type vlo, vhi, v;
+    size_t                              i = 0;
+    if ( n >= kW )
+    {
+        kernel_load<T, Bytes>( vlo, p );
+        vhi = vlo;
+        for ( i = kW; i + kW <= n; i += kW )
+        {
+            kernel_load<T, Bytes>( v, p + i );
+            vlo = v < vlo ? v : vlo;
+            vhi = vhi < v ? v : vhi;
+        }
+        for ( size_t l = 0; l < kW; ++l )
+        {
+            const T l_lo = vlo[l], l_hi = vhi[l];
+            kernel_minmax_scalar( &l_lo, 1, lo, hi );
+            kernel_minmax_scalar( &l_hi, 1, lo, hi );
+        }
+    }
+    kernel_minmax_scalar( p + i, n - i, lo, hi );
+}
+template <CompareOp Op, typename T, size_t Bytes>
+[[gnu::always_inline]] inline uint64_t kernel_mask64_vec( const T* p, T v ) noexcept
+{
+    constexpr size_t                    kW = kernel_vec<T, Bytes>::lanes;
+    typename kernel_vec<T, Bytes>::type x, vv;
+    for ( size_t l = 0; l < kW; ++l )
+        vv[l] = v;
+    uint64_t bits = 0;
+    for ( size_t j = 0; j < 64; j += kW )
+    {
+        kernel_load<T, Bytes>( x, p + j );
+        auto m = x != vv;
+        if constexpr ( Op == CompareOp::Less )
+            m = x < vv;
+        else if constexpr ( Op == CompareOp::LessEqual )
+            m = x <= vv;
+        else if constexpr ( Op == CompareOp::Greater )
+            m = x > vv;
+        else if constexpr ( Op == CompareOp::GreaterEqual )
+            m = x >= vv;
+        else if constexpr ( Op == CompareOp::Equal )
+            m = x == vv;
+        for ( size_t l = 0; l < kW; ++l )
+            bits |= static_cast<uint64_t>( m[l] != 0 ) << ( j + l );
+    }
+    return bits;
+}
+template <typename T, size_t Bytes>
+[[gnu::always_inline]] inline uint64_t kernel_mask64_vec( const T* p, CompareOp op, T v ) noexcept
+{
+    switch ( op )
+    {
+    case CompareOp::Less:
+        return kernel_mask64_vec<CompareOp::Less, T, Bytes>( p, v );
+    case CompareOp::LessEqual:
+        return kernel_mask64_vec<CompareOp::LessEqual, T, Bytes>( p, v );
+    case CompareOp::Greater:
+        return kernel_mask64_vec<CompareOp::Greater, T, Bytes>( p, v );
+    case CompareOp::GreaterEqual:
+        return kernel_mask64_vec<CompareOp::GreaterEqual, T, Bytes>( p, v );
+    case CompareOp::Equal:
+        return kernel_mask64_vec<CompareOp::Equal, T, Bytes>( p, v );
+    default:
+        return kernel_mask64_vec<CompareOp::NotEqual, T, Bytes>( p, v );
+    }
+}
+template <typename T>
+[[gnu::always_inline]] inline void kernel_gather_loop( const T* p, const uint64_t* idx, size_t m, T* out ) noexcept
+{
+    for ( size_t i = 0; i < m; ++i )
+        out[i] = p[idx[i]];
+}
+template <size_t Bytes> struct kernel_isa;
+template <> struct kernel_isa<32>
+{
+    template <typename T> __attribute__( ( target( "avx2" ) ) ) static T sum( const T* p, size_t n ) noexcept
+    {
+        return kernel_sum_vec<T, 32>( p, n );
+    }
+    template <typename T>
+    __attribute__( ( target( "avx2" ) ) ) static void minmax( const T* p, size_t n, T& lo, T& hi ) noexcept
+    {
+        kernel_minmax_vec<T, 32>( p, n, lo, hi );
+    }
+    template <typename T>
+    __attribute__( ( target( "avx2" ) ) ) static uint64_t mask64( const T* p, CompareOp op, T v ) noexcept
+    {
+        return kernel_mask64_vec<T, 32>( p, op, v );
+    }
+    template <typename T>
+    __attribute__( ( target( "avx2" ) ) ) static void gather( const T* p, const uint64_t* idx, size_t m,
+                                                              T* out ) noexcept
+    {
+        size_t i = 0;
+        for ( ; i + 4 <= m; i += 4 )
+        {
+            const __m256i vi = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( idx + i ) );
+            if constexpr ( std::is_same_v<T, double> )
+                _mm256_storeu_pd( out + i, _mm256_i64gather_pd( p, vi, 8 ) );
+            else
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + i ),
+                                     _mm256_i64gather_epi64( reinterpret_cast<const long long*>( p ), vi, 8 ) );
+        }
+        kernel_gather_loop( p, idx + i, m - i, out + i );
+    }
+};
+template <> struct kernel_isa<64>
+{
+    template <typename T> __attribute__( ( target( "avx512f" ) ) ) static T sum( const T* p, size_t n ) noexcept
+    {
+        return kernel_sum_vec<T, 64>( p, n );
+    }
+    template <typename T>
+    __attribute__( ( target( "avx512f" ) ) ) static void minmax( const T* p, size_t n, T& lo, T& hi ) noexcept
+    {
+        kernel_minmax_vec<T, 64>( p, n, lo, hi );
+    }
+    template <typename T>
+    __attribute__( ( target( "avx512f" ) ) ) static uint64_t mask64( const T* p, CompareOp op, T v ) noexcept
+    {
+        return kernel_mask64_vec<T, 64>( p, op, v );
+    }
+    template <typename T>
+    __attribute__( ( target( "avx512f" ) ) ) static void gather( const T* p, const uint64_t* idx, size_t m,
+                                                                 T* out ) noexcept
+    {
+        size_t i = 0;
+        for ( ; i + 8 <= m; i += 8 )
+        {
+            const __m512i vi = _mm512_loadu_si512( idx + i );
+            if constexpr ( std::is_same_v<T, double> )
+                _mm512_storeu_pd( out + i, _mm512_i64gather_pd( vi, p, 8 ) );
+            else
+                _mm512_storeu_si512( out + i, _mm512_i64gather_epi64( vi, p, 8 ) );
+        }
+        kernel_gather_loop( p, idx + i, m - i, out + i );
+    }
+};
+#endif
+template <typename T> inline constexpr bool kKernelSimdType = std::is_same_v<T, double> || std::is_same_v<T, int64_t>;
+template <typename T> T kernel_sum( const T* p, size_t n, SimdLevel level ) noexcept
+{
+#if defined( PMM_KERNELS_X86 )
+    if constexpr ( kKernelSimdType<T> )
+    {
+        if ( level == SimdLevel::Avx512 )
+            return kernel_isa<64>::sum( p, n );
+        if ( level == SimdLevel::Avx2 )
+            return kernel_isa<32>::sum( p, n );
+    }
+#endif
+    (void)level;
+    return kernel_sum_scalar( p, n );
+}
+template <typename T> void kernel_minmax( const T* p, size_t n, SimdLevel level, T& lo, T& hi ) noexcept
+{
+#if defined( PMM_KERNELS_X86 )
+    if constexpr ( kKernelSimdType<T> )
+    {
+        if ( level == SimdLevel::Avx512 )
+            return kernel_isa<64>::minmax( p, n, lo, hi );
+        if ( level == SimdLevel::Avx2 )
+            return kernel_isa<32>::minmax( p, n, lo, hi );
+    }
+#endif
+    (void)level;
+    kernel_minmax_scalar( p, n, lo, hi );
+}
+template <typename T> uint64_t kernel_mask( const T* p, size_t n, CompareOp op, T v, SimdLevel level ) noexcept
+{
+#if defined( PMM_KERNELS_X86 )
+    if constexpr ( kKernelSimdType<T> )
+    {
+        if ( n == 64 && level == SimdLevel::Avx512 )
+            return kernel_isa<64>::mask64( p, op, v );
+        if ( n == 64 && level == SimdLevel::Avx2 )
+            return kernel_isa<32>::mask64( p, op, v );
+    }
+#endif
+    (void)level;
+    return kernel_mask_scalar( p, n, op, v );
+}
+template <typename T> void kernel_gather( const T* p, const uint64_t* idx, size_t m, T* out, SimdLevel level ) noexcept
+{
+#if defined( PMM_KERNELS_X86 )
+    if constexpr ( kKernelSimdType<T> )
+    {
+        if ( level == SimdLevel::Avx512 )
+            return kernel_isa<64>::gather( p, idx, m, out );
+        if ( level == SimdLevel::Avx2 )
+            return kernel_isa<32>::gather( p, idx, m, out );
+    }
+#endif
+    (void)level;
+    for ( size_t i = 0; i < m; ++i )
+        out[i] = p[idx[i]];
+}
+template <typename T> auto kernel_radix_key( T v ) noexcept
+{
+    using U = std::make_unsigned_t<T>;
+    U u     = static_cast<U>( v );
+    if constexpr ( std::is_signed_v<T> )
+        u ^= static_cast<U>( U{ 1 } << ( sizeof( T ) * 8 - 1 ) );
+    return u;
+}
+template <typename T> inline constexpr bool kKernelRadixType = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+/*
+### pmm-detail-kernel_radix_sort
+*/
+template <typename T> T* kernel_radix_sort( T* data, T* scratch, size_t n, const KernelOptions& opt ) noexcept
+{
+    size_t counts[kKernelMaxThreads][256];
+    T*     src = data;
+    T*     dst = scratch;
+    for ( size_t shift = 0; shift < sizeof( T ) * 8; shift += 8 )
+    {
+        auto hist = [&]( size_t c, size_t b, size_t e )
+        {
+            std::memset( counts[c], 0, sizeof( counts[c] ) );
+            for ( size_t i = b; i < e; ++i )
+                ++counts[c][( kernel_radix_key( src[i] ) >> shift ) & 0xFF];
+        };
+        const size_t chunks = kernel_chunks( n, opt, 64, hist );
+        size_t       offset = 0;
+        bool         skip   = false;
+        for ( size_t d = 0; d < 256 && !skip; ++d )
+        {
+            size_t total = 0;
+            for ( size_t c = 0; c < chunks; ++c )
+            {
+                const size_t cnt = counts[c][d];
+                counts[c][d]     = offset + total;
+                total += cnt;
+            }
+            skip = ( total == n );
+            offset += total;
+        }
+        if ( skip )
+            continue;
+        auto scatter = [&]( size_t c, size_t b, size_t e )
+        {
+            size_t* pos = counts[c];
+            for ( size_t i = b; i < e; ++i )
+                dst[pos[( kernel_radix_key( src[i] ) >> shift ) & 0xFF]++] = src[i];
+        };
+        kernel_chunks( n, opt, 64, scatter );
+        T* t = src;
+        src  = dst;
+        dst  = t;
+    }
+    return src;
+}
+/*
+### pmm-detail-kernel_merge_sort
+*/
+template <typename T> T* kernel_merge_sort( T* data, T* scratch, size_t n, const KernelOptions& opt ) noexcept
+{
+    size_t bounds[kKernelMaxThreads + 1]{};
+    auto   sort_chunk = [&]( size_t c, size_t b, size_t e )
+    {
+        std::sort( data + b, data + e );
+        bounds[c + 1] = e;
+    };
+    size_t        runs = kernel_chunks( n, opt, 64, sort_chunk );
+    T*            src  = data;
+    T*            dst  = scratch;
+    KernelOptions pairs_opt{ opt.max_level, opt.threads, 1 };
+    while ( runs > 1 )
+    {
+        auto merge_pairs = [&]( size_t, size_t b, size_t e )
+        {
+            for ( size_t r = b * 2; r < e * 2 && r < runs; r += 2 )
+            {
+                const size_t lo  = bounds[r];
+                const size_t mid = bounds[r + 1];
+                const size_t hi  = r + 2 <= runs ? bounds[r + 2] : mid;
+                std::merge( src + lo, src + mid, src + mid, src + hi, dst + lo );
+            }
+        };
+        kernel_chunks( ( runs + 1 ) / 2, pairs_opt, 1, merge_pairs );
+        size_t merged = 0;
+        for ( size_t r = 0; r < runs; r += 2 )
+            bounds[++merged] = bounds[r + 2 <= runs ? r + 2 : r + 1];
+        runs = merged;
+        T* t = src;
+        src  = dst;
+        dst  = t;
+    }
+    return src;
+}
+template <typename T> size_t kernel_lower_bound( const T* data, size_t n, T key ) noexcept
+{
+    if ( n == 0 )
+        return 0;
+    const T* base = data;
+    for ( size_t len = n; len > 1; )
+    {
+        const size_t half = len / 2;
+        base              = ( base[half] < key ) ? base + half : base;
+        len -= half;
+    }
+    return static_cast<size_t>( base - data ) + ( *base < key ? 1 : 0 );
+}
+}
+/*
+## pmm-array_sum
+req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
+*/
+template <typename T> T array_sum( const T* data, size_t n, const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    static_assert( std::is_arithmetic_v<T>, "array_sum: arithmetic element type required" );
+    const SimdLevel level = detail::kernel_level( opt );
+    T               partial[detail::kKernelMaxThreads]{};
+    auto            body = [&]( size_t c, size_t b, size_t e )
+    { partial[c] = detail::kernel_sum( data + b, e - b, level ); };
+    return detail::kernel_sum_scalar( partial, detail::kernel_chunks( n, opt, 64, body ) );
+}
+template <typename T>
+bool array_minmax( const T* data, size_t n, T& lo, T& hi, const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    static_assert( std::is_arithmetic_v<T>, "array_minmax: arithmetic element type required" );
+    if ( n == 0 || data == nullptr )
+        return false;
+    const SimdLevel level = detail::kernel_level( opt );
+    T               los[detail::kKernelMaxThreads];
+    T               his[detail::kKernelMaxThreads];
+    auto            body = [&]( size_t c, size_t b, size_t e )
+    {
+        los[c] = his[c] = data[b];
+        detail::kernel_minmax( data + b, e - b, level, los[c], his[c] );
+    };
+    const size_t count = detail::kernel_chunks( n, opt, 64, body );
+    lo                 = los[0];
+    hi                 = his[0];
+    for ( size_t c = 1; c < count; ++c )
+    {
+        detail::kernel_minmax_scalar( &los[c], 1, lo, hi );
+        detail::kernel_minmax_scalar( &his[c], 1, lo, hi );
+    }
+    return true;
+}
+template <typename T> void array_prefix_sum( T* data, size_t n, const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    static_assert( std::is_arithmetic_v<T>, "array_prefix_sum: arithmetic element type required" );
+    T      totals[detail::kKernelMaxThreads]{};
+    size_t bounds[detail::kKernelMaxThreads + 1]{};
+    auto   body = [&]( size_t c, size_t b, size_t e )
+    {
+        T acc = T{};
+        for ( size_t i = b; i < e; ++i )
+            data[i] = acc += data[i];
+        totals[c]     = acc;
+        bounds[c + 1] = e;
+    };
+    const size_t count = detail::kernel_chunks( n, opt, 64, body );
+    for ( size_t c = 1; c < count; ++c )
+    {
+        const T offset = totals[c - 1];
+        totals[c] += offset;
+        for ( size_t i = bounds[c]; i < bounds[c + 1]; ++i )
+            data[i] += offset;
+    }
+}
+template <typename T>
+size_t array_filter( const T* data, size_t n, CompareOp op, T value, uint64_t* mask,
+                     const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    static_assert( std::is_arithmetic_v<T>, "array_filter: arithmetic element type required" );
+    const SimdLevel level = detail::kernel_level( opt );
+    size_t          hits[detail::kKernelMaxThreads]{};
+    auto            body = [&]( size_t c, size_t b, size_t e )
+    {
+        for ( size_t i = b; i < e; i += 64 )
+        {
+            mask[i / 64] = detail::kernel_mask( data + i, e - i < 64 ? e - i : 64, op, value, level );
+            hits[c] += static_cast<size_t>( std::popcount( mask[i / 64] ) );
+        }
+    };
+    return detail::kernel_sum_scalar( hits, detail::kernel_chunks( n, opt, 64, body ) );
+}
+template <typename T>
+bool array_gather( const T* data, size_t n, const uint64_t* idx, size_t m, T* out,
+                   const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    for ( size_t i = 0; i < m; ++i )
+    {
+        if ( idx[i] >= n )
+            return false;
+    }
+    const SimdLevel level = detail::kernel_level( opt );
+    auto body = [&]( size_t, size_t b, size_t e ) { detail::kernel_gather( data, idx + b, e - b, out + b, level ); };
+    detail::kernel_chunks( m, opt, 64, body );
+    return true;
+}
+template <typename T, typename ManagerT, size_t GN, size_t GD>
+T array_sum( const parray<T, ManagerT, GN, GD>& a, const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    return a.empty() ? T{} : array_sum( a.data(), a.size(), opt );
+}
+template <typename T, typename ManagerT, size_t GN, size_t GD>
+bool array_minmax( const parray<T, ManagerT, GN, GD>& a, T& lo, T& hi,
+                   const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    return array_minmax( a.data(), a.size(), lo, hi, opt );
+}
+template <typename T, typename ManagerT, size_t GN, size_t GD>
+bool array_prefix_sum( parray<T, ManagerT, GN, GD>& a, const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    T* data = a.data();
+    if ( data == nullptr && !a.empty() )
+        return false;
+    array_prefix_sum( data, a.size(), opt );
+    return true;
+}
+template <typename T, typename ManagerT, size_t GN, size_t GD>
+size_t array_filter( const parray<T, ManagerT, GN, GD>& a, CompareOp op, T value, uint64_t* mask,
+                     const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    return a.empty() ? 0 : array_filter( a.data(), a.size(), op, value, mask, opt );
+}
+template <typename T, typename ManagerT, size_t GN, size_t GD>
+bool array_gather( const parray<T, ManagerT, GN, GD>& a, const uint64_t* idx, size_t m, T* out,
+                   const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    const T* data = a.data();
+    if ( data == nullptr && m > 0 )
+        return false;
+    return array_gather( data, a.size(), idx, m, out, opt );
+}
+/*
+## pmm-array_sort
+req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
+*/
+template <typename T>
+void array_sort( T* data, size_t n, T* scratch, const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    static_assert( std::is_arithmetic_v<T>, "array_sort: arithmetic element type required" );
+    if ( n < 2 )
+        return;
+    if ( scratch == nullptr )
+    {
+        std::sort( data, data + n );
+        return;
+    }
+    T* sorted;
+    if constexpr ( detail::kKernelRadixType<T> )
+        sorted = detail::kernel_radix_sort( data, scratch, n, opt );
+    else
+        sorted = detail::kernel_merge_sort( data, scratch, n, opt );
+    if ( sorted != data )
+        std::memcpy( data, sorted, n * sizeof( T ) );
+}
+template <typename T> size_t array_lower_bound( const T* data, size_t n, T key ) noexcept
+{
+    return detail::kernel_lower_bound( data, n, key );
+}
+template <typename T> bool array_binary_search( const T* data, size_t n, T key ) noexcept
+{
+    const size_t i = detail::kernel_lower_bound( data, n, key );
+    return i < n && !( key < data[i] );
+}
+/*
+### pmm-array_sort-lower_bound_batch
+*/
+template <typename T>
+void array_lower_bound_batch( const T* data, size_t n, const T* keys, size_t m, uint64_t* out,
+                              const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    constexpr size_t kLanes = 16;
+    auto             body   = [&]( size_t, size_t b, size_t e )
+    {
+        for ( size_t g = b; g < e; g += kLanes )
+        {
+            const size_t lanes = e - g < kLanes ? e - g : kLanes;
+            if ( n == 0 )
+            {
+                for ( size_t j = 0; j < lanes; ++j )
+                    out[g + j] = 0;
+                continue;
+            }
+            const T* base[kLanes];
+            for ( size_t j = 0; j < lanes; ++j )
+                base[j] = data;
+            for ( size_t len = n; len > 1; )
+            {
+                const size_t half = len / 2;
+                len -= half;
+                for ( size_t j = 0; j < lanes; ++j )
+                {
+                    base[j] = ( base[j][half] < keys[g + j] ) ? base[j] + half : base[j];
+#if defined( PMM_KERNELS_X86 )
+                    __builtin_prefetch( base[j] + len / 2 );
+#endif
+                }
+            }
+            for ( size_t j = 0; j < lanes; ++j )
+                out[g + j] = static_cast<uint64_t>( base[j] - data ) + ( *base[j] < keys[g + j] ? 1 : 0 );
+        }
+    };
+    detail::kernel_chunks( m, opt, kLanes, body );
+}
+template <typename T, typename ManagerT, size_t GN, size_t GD>
+bool array_sort( parray<T, ManagerT, GN, GD>& a, const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    const size_t                 n = a.size();
+    const pmm::pptr<T, ManagerT> data_p( a._data_idx );
+    if ( n < 2 )
+        return true;
+    pmm::pptr<T, ManagerT> scratch_p = ManagerT::template allocate_typed<T>( n );
+    T*                     data      = data_p.resolve_unchecked();
+    if ( data == nullptr )
+        return false;
+    array_sort( data, n, scratch_p.is_null() ? nullptr : scratch_p.resolve_unchecked(), opt );
+    if ( !scratch_p.is_null() )
+        ManagerT::template deallocate_typed<T>( scratch_p );
+    return true;
+}
+template <typename T, typename ManagerT, size_t GN, size_t GD>
+size_t array_lower_bound( const parray<T, ManagerT, GN, GD>& a, T key ) noexcept
+{
+    return a.empty() ? 0 : detail::kernel_lower_bound( a.data(), a.size(), key );
+}
+template <typename T, typename ManagerT, size_t GN, size_t GD>
+bool array_binary_search( const parray<T, ManagerT, GN, GD>& a, T key ) noexcept
+{
+    return !a.empty() && array_binary_search( a.data(), a.size(), key );
+}
+template <typename T, typename ManagerT, size_t GN, size_t GD>
+void array_lower_bound_batch( const parray<T, ManagerT, GN, GD>& a, const T* keys, size_t m, uint64_t* out,
+                              const KernelOptions& opt = KernelOptions{} ) noexcept
+{
+    array_lower_bound_batch( a.empty() ? nullptr : a.data(), a.size(), keys, m, out, opt );
+}
+}
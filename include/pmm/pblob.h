@@ -0,0 +1,181 @@
+#pragma once
+#include "pmm/pptr.h"
+#include "pmm/types.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+namespace pmm
+{
+/*
+## pmm-pblob
+req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
+*/
+template <typename ManagerT, size_t ChunkBytes = 65536> struct pblob
+{
+    static_assert( ChunkBytes >= 64 && ( ChunkBytes & ( ChunkBytes - 1 ) ) == 0,
+                   "pblob: ChunkBytes must be a power of two of at least 64" );
+    using manager_type                  = ManagerT;
+    using index_type                    = typename ManagerT::index_type;
+    static constexpr size_t chunk_bytes = ChunkBytes;
+    uint64_t   _size;
+    uint64_t   _chunks;
+    uint64_t   _table_capacity;
+    index_type _table_idx;
+    pblob() noexcept
+        : _size( 0 ), _chunks( 0 ), _table_capacity( 0 ),
+          _table_idx( detail::kNullIdx_v<typename ManagerT::address_traits> )
+    {
+    }
+    ~pblob() noexcept = default;
+    uint64_t size() const noexcept { return _size; }
+    bool     empty() const noexcept { return _size == 0; }
+    uint64_t capacity() const noexcept { return _chunks * ChunkBytes; }
+    size_t   chunk_count() const noexcept { return static_cast<size_t>( _chunks ); }
+/*
+### pmm-pblob-read
+*/
+    size_t read( uint64_t offset, void* buf, size_t n ) const noexcept
+    {
+        if ( offset >= _size )
+            return 0;
+        if ( n > _size - offset )
+            n = static_cast<size_t>( _size - offset );
+        uint8_t* out = static_cast<uint8_t*>( buf );
+        for ( size_t done = 0; done < n; )
+        {
+            const uint64_t at  = offset + done;
+            const size_t   in  = static_cast<size_t>( at % ChunkBytes );
+            const size_t   cnt = ( n - done < ChunkBytes - in ) ? n - done : ChunkBytes - in;
+            std::memcpy( out + done, chunk( static_cast<size_t>( at / ChunkBytes ) ) + in, cnt );
+            done += cnt;
+        }
+        return n;
+    }
+/*
+### pmm-pblob-write
+*/
+    bool write( uint64_t offset, const void* buf, size_t n ) noexcept
+    {
+        if ( offset > _size && !resize( offset ) )
+            return false;
+        if ( !reserve( offset + n ) )
+            return false;
+        const uint8_t* in = static_cast<const uint8_t*>( buf );
+        for ( size_t done = 0; done < n; )
+        {
+            const uint64_t at  = offset + done;
+            const size_t   pos = static_cast<size_t>( at % ChunkBytes );
+            const size_t   cnt = ( n - done < ChunkBytes - pos ) ? n - done : ChunkBytes - pos;
+            std::memcpy( chunk( static_cast<size_t>( at / ChunkBytes ) ) + pos, in + done, cnt );
+            done += cnt;
+        }
+        if ( offset + n > _size )
+            _size = offset + n;
+        return true;
+    }
+    bool append( const void* buf, size_t n ) noexcept { return write( _size, buf, n ); }
+    bool reserve( uint64_t n ) noexcept
+    {
+        while ( capacity() < n )
+        {
+            if ( !add_chunk() )
+                return false;
+        }
+        return true;
+    }
+    bool resize( uint64_t n ) noexcept
+    {
+        if ( n < _size )
+        {
+            _size = n;
+            release_chunks( static_cast<size_t>( ( n + ChunkBytes - 1 ) / ChunkBytes ) );
+            return true;
+        }
+        if ( !reserve( n ) )
+            return false;
+        for ( uint64_t i = _size; i < n; )
+        {
+            const size_t pos = static_cast<size_t>( i % ChunkBytes );
+            const size_t cnt = ( n - i < ChunkBytes - pos ) ? static_cast<size_t>( n - i ) : ChunkBytes - pos;
+            std::memset( chunk( static_cast<size_t>( i / ChunkBytes ) ) + pos, 0, cnt );
+            i += cnt;
+        }
+        _size = n;
+        return true;
+    }
+/*
+### pmm-pblob-span
+*/
+    std::span<uint8_t> span( size_t c ) noexcept
+    {
+        uint8_t* p = c < _chunks ? chunk( c ) : nullptr;
+        return p == nullptr ? std::span<uint8_t>() : std::span<uint8_t>( p, chunk_length( c ) );
+    }
+    std::span<const uint8_t> span( size_t c ) const noexcept
+    {
+        const uint8_t* p = c < _chunks ? chunk( c ) : nullptr;
+        return p == nullptr ? std::span<const uint8_t>() : std::span<const uint8_t>( p, chunk_length( c ) );
+    }
+    template <typename FnT> void for_each_chunk( FnT&& fn ) const
+    {
+        for ( size_t c = 0; c * ChunkBytes < _size; ++c )
+            fn( span( c ) );
+    }
+    void clear() noexcept { resize( 0 ); }
+    void free_data() noexcept
+    {
+        release_chunks( 0 );
+        if ( _table_idx != detail::kNullIdx_v<typename ManagerT::address_traits> )
+        {
+            ManagerT::template deallocate_typed<index_type>( pmm::pptr<index_type, ManagerT>( _table_idx ) );
+            _table_idx = detail::kNullIdx_v<typename ManagerT::address_traits>;
+        }
+        _size           = 0;
+        _table_capacity = 0;
+    }
+
+  private:
+    index_type* table() const noexcept { return pmm::pptr<index_type, ManagerT>( _table_idx ).resolve_unchecked(); }
+    uint8_t*    chunk( size_t c ) const noexcept
+    {
+        const index_type* t = table();
+        return ( t != nullptr ) ? pmm::pptr<uint8_t, ManagerT>( t[c] ).resolve_unchecked() : nullptr;
+    }
+    size_t chunk_length( size_t c ) const noexcept
+    {
+        const uint64_t begin = static_cast<uint64_t>( c ) * ChunkBytes;
+        if ( begin >= _size )
+            return 0;
+        return ( _size - begin < ChunkBytes ) ? static_cast<size_t>( _size - begin ) : ChunkBytes;
+    }
+    bool add_chunk() noexcept
+    {
+        if ( _chunks == _table_capacity )
+        {
+            const uint64_t                  new_cap = _table_capacity < 8 ? 8 : _table_capacity * 2;
+            pmm::pptr<index_type, ManagerT> old_p( _table_idx );
+            pmm::pptr<index_type, ManagerT> new_p = ManagerT::template reallocate_typed<index_type>(
+                old_p, static_cast<size_t>( _chunks ), static_cast<size_t>( new_cap ) );
+            if ( new_p.is_null() )
+                return false;
+            _table_idx      = new_p.offset();
+            _table_capacity = new_cap;
+        }
+        pmm::pptr<uint8_t, ManagerT> c = ManagerT::template allocate_typed<uint8_t>( ChunkBytes );
+        if ( c.is_null() )
+            return false;
+        table()[_chunks] = c.offset();
+        ++_chunks;
+        return true;
+    }
+    void release_chunks( size_t keep ) noexcept
+    {
+        while ( _chunks > keep )
+        {
+            --_chunks;
+            ManagerT::template deallocate_typed<uint8_t>( pmm::pptr<uint8_t, ManagerT>( table()[_chunks] ) );
+        }
+    }
+};
+}
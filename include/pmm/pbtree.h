@@ -0,0 +1,628 @@
+#pragma once
+#include "pmm/forest_registry.h"
+#include "pmm/pmap.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+namespace pmm
+{
+template <typename _K, typename _V, typename IndexT, size_t N> struct pbtree_leaf
+{
+    uint32_t count;
+    IndexT   prev;
+    IndexT   next;
+    _K       keys[N];
+    _V       values[N];
+};
+template <typename _K, typename IndexT, size_t N> struct pbtree_inner
+{
+    uint32_t count;
+    _K       keys[N];
+    IndexT   children[N + 1];
+};
+template <typename IndexT> struct pbtree_header
+{
+    uint64_t size;
+    uint64_t leaf_count;
+    uint64_t inner_count;
+    IndexT   root;
+    IndexT   first_leaf;
+    IndexT   last_leaf;
+    uint32_t height;
+};
+namespace detail
+{
+inline constexpr size_t   kPbtreeMaxHeight = 48;
+inline constexpr uint32_t kPbtreeTypeSalt  = 0x62747265u;
+constexpr size_t          pbtree_fanout( size_t node_bytes, size_t entry_bytes ) noexcept
+{
+    return node_bytes > 16 + 4 * entry_bytes ? ( node_bytes - 16 ) / entry_bytes : 4;
+}
+}
+template <typename _K, typename _V, typename ManagerT, size_t NodeBytes = 512>
+/*
+## pmm-pbtree
+req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
+*/
+class pbtree : public detail::pmap_domain_binding<ManagerT>
+{
+    using binding_type = detail::pmap_domain_binding<ManagerT>;
+
+  public:
+    using manager_type                     = ManagerT;
+    using index_type                       = typename ManagerT::index_type;
+    static constexpr size_t leaf_capacity  = detail::pbtree_fanout( NodeBytes, sizeof( _K ) + sizeof( _V ) );
+    static constexpr size_t inner_capacity = detail::pbtree_fanout( NodeBytes, sizeof( _K ) + sizeof( index_type ) );
+    using leaf_type                        = pbtree_leaf<_K, _V, index_type, leaf_capacity>;
+    using inner_type                       = pbtree_inner<_K, index_type, inner_capacity>;
+    using header_type                      = pbtree_header<index_type>;
+    static_assert( std::is_trivially_copyable_v<_K> && std::is_trivially_copyable_v<_V>,
+                   "pbtree: keys and values must be trivially copyable" );
+    static_assert( std::is_default_constructible_v<_K>, "pbtree: keys must be default constructible" );
+    class iterator
+    {
+      public:
+        iterator() noexcept = default;
+        const _K& key() const noexcept { return leaf_at( _leaf )->keys[_pos]; }
+        _V&       value() const noexcept { return leaf_at( _leaf )->values[_pos]; }
+        bool      operator==( const iterator& other ) const noexcept
+        {
+            return _leaf == other._leaf && _pos == other._pos;
+        }
+        bool      operator!=( const iterator& other ) const noexcept { return !( *this == other ); }
+        iterator& operator++() noexcept
+        {
+            const leaf_type* leaf = leaf_at( _leaf );
+            if ( leaf == nullptr )
+                return *this;
+            if ( ++_pos >= leaf->count )
+            {
+                _leaf = leaf->next;
+                _pos  = 0;
+            }
+            return *this;
+        }
+
+      private:
+        friend class pbtree;
+        iterator( index_type leaf, uint32_t pos ) noexcept : _leaf( leaf ), _pos( pos ) {}
+        index_type _leaf = 0;
+        uint32_t   _pos  = 0;
+    };
+    pbtree() noexcept { bind( nullptr ); }
+    explicit pbtree( const char* domain_key ) noexcept { bind( domain_key ); }
+    pbtree( const pbtree& )            = delete;
+    pbtree& operator=( const pbtree& ) = delete;
+    using binding_type::root_index;
+    size_t size() const noexcept
+    {
+        const header_type* h = header();
+        return h == nullptr ? 0 : static_cast<size_t>( h->size );
+    }
+    bool   empty() const noexcept { return size() == 0; }
+    size_t height() const noexcept
+    {
+        const header_type* h = header();
+        return h == nullptr ? 0 : h->height;
+    }
+    size_t leaf_count() const noexcept
+    {
+        const header_type* h = header();
+        return h == nullptr ? 0 : static_cast<size_t>( h->leaf_count );
+    }
+    size_t inner_count() const noexcept
+    {
+        const header_type* h = header();
+        return h == nullptr ? 0 : static_cast<size_t>( h->inner_count );
+    }
+/*
+### pmm-pbtree-find
+*/
+    _V* find( const _K& key ) noexcept
+    {
+        leaf_type* leaf = leaf_at( descend( key, nullptr, nullptr ) );
+        if ( leaf == nullptr )
+            return nullptr;
+        uint32_t pos = lower_pos( leaf, key );
+        return pos < leaf->count && leaf->keys[pos] == key ? &leaf->values[pos] : nullptr;
+    }
+    const _V* find( const _K& key ) const noexcept { return const_cast<pbtree*>( this )->find( key ); }
+    bool     contains( const _K& key ) const noexcept { return find( key ) != nullptr; }
+    iterator begin() const noexcept
+    {
+        const header_type* h = header();
+        return h == nullptr ? iterator() : iterator( h->first_leaf, 0 );
+    }
+    iterator end() const noexcept { return iterator(); }
+/*
+### pmm-pbtree-lower_bound
+*/
+    iterator lower_bound( const _K& key ) const noexcept
+    {
+        index_type       idx  = descend( key, nullptr, nullptr );
+        const leaf_type* leaf = leaf_at( idx );
+        if ( leaf == nullptr )
+            return iterator();
+        uint32_t pos = lower_pos( leaf, key );
+        if ( pos < leaf->count )
+            return iterator( idx, pos );
+        return iterator( leaf->next, 0 );
+    }
+    iterator upper_bound( const _K& key ) const noexcept
+    {
+        iterator it = lower_bound( key );
+        if ( it != end() && it.key() == key )
+            ++it;
+        return it;
+    }
+/*
+### pmm-pbtree-for_each_range
+*/
+    template <typename FnT> size_t for_each_range( const _K& lo, const _K& hi, FnT&& fn ) const
+    {
+        iterator start = lower_bound( lo );
+        size_t   count = 0;
+        uint32_t pos   = start._pos;
+        for ( index_type idx = start._leaf; idx != static_cast<index_type>( 0 ); pos = 0 )
+        {
+            const leaf_type* leaf = leaf_at( idx );
+            const _K*        last = leaf->keys + leaf->count;
+            const _K*        stop = std::lower_bound( leaf->keys + pos, last, hi );
+            for ( const _K* k = leaf->keys + pos; k < stop; ++k, ++count )
+                fn( *k, leaf->values[k - leaf->keys] );
+            if ( stop != last )
+                break;
+            idx = leaf->next;
+        }
+        return count;
+    }
+    template <typename FnT> size_t for_each( FnT&& fn ) const
+    {
+        size_t             count = 0;
+        const header_type* h     = header();
+        for ( index_type idx = h == nullptr ? 0 : h->first_leaf; idx != static_cast<index_type>( 0 ); )
+        {
+            const leaf_type* leaf = leaf_at( idx );
+            for ( uint32_t pos = 0; pos < leaf->count; ++pos, ++count )
+                fn( leaf->keys[pos], leaf->values[pos] );
+            idx = leaf->next;
+        }
+        return count;
+    }
+/*
+### pmm-pbtree-insert
+*/
+    bool insert( const _K& key, const _V& val ) noexcept
+    {
+        header_type* h = ensure_header();
+        if ( h == nullptr )
+            return false;
+        if ( h->root == static_cast<index_type>( 0 ) )
+        {
+            index_type idx = allocate_leaf();
+            if ( idx == static_cast<index_type>( 0 ) )
+                return false;
+            h             = header();
+            h->root       = idx;
+            h->first_leaf = idx;
+            h->last_leaf  = idx;
+            h->height     = 1;
+        }
+        path_entry path[detail::kPbtreeMaxHeight];
+        uint32_t   depth    = 0;
+        index_type leaf_idx = descend( key, path, &depth );
+        leaf_type* leaf     = leaf_at( leaf_idx );
+        uint32_t   pos      = lower_pos( leaf, key );
+        if ( pos < leaf->count && leaf->keys[pos] == key )
+        {
+            leaf->values[pos] = val;
+            return true;
+        }
+        if ( leaf->count < leaf_capacity )
+        {
+            insert_into_leaf( leaf, pos, key, val );
+            ++h->size;
+            return true;
+        }
+        uint32_t splits = 1;
+        while ( splits <= depth && inner_at( path[depth - splits].node )->count >= inner_capacity )
+            ++splits;
+        index_type fresh[detail::kPbtreeMaxHeight + 1]{};
+        if ( !allocate_split_nodes( fresh, splits, splits > depth ) )
+            return false;
+        split_and_insert( path, depth, leaf_idx, pos, key, val, fresh );
+        return true;
+    }
+/*
+### pmm-pbtree-erase
+*/
+    bool erase( const _K& key ) noexcept
+    {
+        header_type* h = header();
+        if ( h == nullptr || h->root == static_cast<index_type>( 0 ) )
+            return false;
+        path_entry path[detail::kPbtreeMaxHeight];
+        uint32_t   depth    = 0;
+        index_type leaf_idx = descend( key, path, &depth );
+        leaf_type* leaf     = leaf_at( leaf_idx );
+        uint32_t   pos      = lower_pos( leaf, key );
+        if ( pos >= leaf->count || !( leaf->keys[pos] == key ) )
+            return false;
+        std::copy( leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos );
+        std::copy( leaf->values + pos + 1, leaf->values + leaf->count, leaf->values + pos );
+        --leaf->count;
+        --h->size;
+        if ( depth == 0 )
+        {
+            if ( leaf->count == 0 )
+            {
+                free_leaf( leaf_idx );
+                h->root       = 0;
+                h->first_leaf = 0;
+                h->last_leaf  = 0;
+                h->height     = 0;
+            }
+            return true;
+        }
+        if ( leaf->count < leaf_capacity / 2 )
+            rebalance_leaf( path[depth - 1], leaf_idx );
+        for ( uint32_t level = depth; level-- > 0; )
+        {
+            inner_type* node = inner_at( path[level].node );
+            if ( level == 0 )
+            {
+                if ( node->count == 0 )
+                {
+                    h->root = node->children[0];
+                    --h->height;
+                    free_inner( path[level].node );
+                }
+                break;
+            }
+            if ( node->count >= inner_capacity / 2 )
+                break;
+            rebalance_inner( path[level - 1], path[level].node );
+        }
+        return true;
+    }
+    void clear() noexcept
+    {
+        header_type* h = header();
+        if ( h == nullptr )
+            return;
+        if ( h->root != static_cast<index_type>( 0 ) )
+            free_subtree( h->root, h->height );
+        ManagerT::template deallocate_typed<header_type>(
+            typename ManagerT::template pptr<header_type>( root_index() ) );
+        if ( index_type* root = root_slot() )
+            *root = static_cast<index_type>( 0 );
+    }
+
+  private:
+    struct path_entry
+    {
+        index_type node;
+        uint32_t   pos;
+    };
+    using binding_type::root_slot;
+    void bind( const char* domain_key ) noexcept
+    {
+        constexpr uint32_t kTypeHash =
+            detail::pmap_fnv1a( detail::pmap_fnv1a( detail::kPbtreeTypeSalt ^ static_cast<uint32_t>( NodeBytes ),
+                                                    detail::pmap_type_fp<_K>(), 4 ),
+                                detail::pmap_type_fp<_V>(), 4 );
+        this->bind_domain( kTypeHash, domain_key );
+    }
+    template <typename T> static T* resolve( index_type idx ) noexcept
+    {
+        return detail::pmap_resolve<T, ManagerT>( idx );
+    }
+    static leaf_type*  leaf_at( index_type idx ) noexcept { return resolve<leaf_type>( idx ); }
+    static inner_type* inner_at( index_type idx ) noexcept { return resolve<inner_type>( idx ); }
+    header_type*       header() const noexcept { return resolve<header_type>( root_index() ); }
+    header_type*       ensure_header() noexcept
+    {
+        if ( header_type* h = header() )
+            return h;
+        if ( root_slot() == nullptr )
+            return nullptr;
+        auto p = ManagerT::template allocate_typed<header_type>();
+        if ( p.is_null() )
+            return nullptr;
+        header_type* h = resolve<header_type>( p.offset() );
+        std::memset( h, 0, sizeof( header_type ) );
+        *root_slot() = p.offset();
+        return h;
+    }
+    static uint32_t lower_pos( const leaf_type* leaf, const _K& key ) noexcept
+    {
+        return static_cast<uint32_t>( std::lower_bound( leaf->keys, leaf->keys + leaf->count, key ) - leaf->keys );
+    }
+    static uint32_t child_pos( const inner_type* node, const _K& key ) noexcept
+    {
+        return static_cast<uint32_t>( std::upper_bound( node->keys, node->keys + node->count, key ) - node->keys );
+    }
+    index_type descend( const _K& key, path_entry* path, uint32_t* depth ) const noexcept
+    {
+        const header_type* h = header();
+        if ( h == nullptr || h->root == static_cast<index_type>( 0 ) )
+            return 0;
+        index_type cur = h->root;
+        for ( uint32_t level = h->height; level > 1; --level )
+        {
+            const inner_type* node = inner_at( cur );
+            uint32_t          pos  = child_pos( node, key );
+            if ( path != nullptr )
+                path[( *depth )++] = path_entry{ cur, pos };
+            cur = node->children[pos];
+        }
+        return cur;
+    }
+    index_type allocate_leaf() noexcept
+    {
+        auto p = ManagerT::template allocate_typed<leaf_type>();
+        if ( p.is_null() )
+            return 0;
+        leaf_type* leaf = leaf_at( p.offset() );
+        leaf->count     = 0;
+        leaf->prev      = 0;
+        leaf->next      = 0;
+        ++header()->leaf_count;
+        return p.offset();
+    }
+    index_type allocate_inner() noexcept
+    {
+        auto p = ManagerT::template allocate_typed<inner_type>();
+        if ( p.is_null() )
+            return 0;
+        inner_at( p.offset() )->count = 0;
+        ++header()->inner_count;
+        return p.offset();
+    }
+    void free_leaf( index_type idx ) noexcept
+    {
+        ManagerT::template deallocate_typed<leaf_type>( typename ManagerT::template pptr<leaf_type>( idx ) );
+        --header()->leaf_count;
+    }
+    void free_inner( index_type idx ) noexcept
+    {
+        ManagerT::template deallocate_typed<inner_type>( typename ManagerT::template pptr<inner_type>( idx ) );
+        --header()->inner_count;
+    }
+    void free_subtree( index_type idx, uint32_t level ) noexcept
+    {
+        if ( level <= 1 )
+        {
+            free_leaf( idx );
+            return;
+        }
+        const inner_type* node = inner_at( idx );
+        for ( uint32_t i = 0; i <= node->count; ++i )
+            free_subtree( node->children[i], level - 1 );
+        free_inner( idx );
+    }
+    bool allocate_split_nodes( index_type* fresh, uint32_t splits, bool new_root ) noexcept
+    {
+        uint32_t total = splits + ( new_root ? 1 : 0 );
+        for ( uint32_t i = 0; i < total; ++i )
+        {
+            fresh[i] = i == 0 ? allocate_leaf() : allocate_inner();
+            if ( fresh[i] != static_cast<index_type>( 0 ) )
+                continue;
+            for ( uint32_t j = 0; j < i; ++j )
+            {
+                if ( j == 0 )
+                    free_leaf( fresh[j] );
+                else
+                    free_inner( fresh[j] );
+            }
+            return false;
+        }
+        return true;
+    }
+    static void insert_into_leaf( leaf_type* leaf, uint32_t pos, const _K& key, const _V& val ) noexcept
+    {
+        std::copy_backward( leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1 );
+        std::copy_backward( leaf->values + pos, leaf->values + leaf->count, leaf->values + leaf->count + 1 );
+        leaf->keys[pos]   = key;
+        leaf->values[pos] = val;
+        ++leaf->count;
+    }
+    static void insert_into_inner( inner_type* node, uint32_t pos, const _K& key, index_type right ) noexcept
+    {
+        std::copy_backward( node->keys + pos, node->keys + node->count, node->keys + node->count + 1 );
+        std::copy_backward( node->children + pos + 1, node->children + node->count + 1,
+                            node->children + node->count + 2 );
+        node->keys[pos]         = key;
+        node->children[pos + 1] = right;
+        ++node->count;
+    }
+    static void remove_from_inner( inner_type* node, uint32_t pos ) noexcept
+    {
+        std::copy( node->keys + pos + 1, node->keys + node->count, node->keys + pos );
+        std::copy( node->children + pos + 2, node->children + node->count + 1, node->children + pos + 1 );
+        --node->count;
+    }
+/*
+### pmm-pbtree-split
+*/
+    void split_and_insert( const path_entry* path, uint32_t depth, index_type leaf_idx, uint32_t pos, const _K& key,
+                           const _V& val, const index_type* fresh ) noexcept
+    {
+        header_type* h           = header();
+        leaf_type*   leaf        = leaf_at( leaf_idx );
+        index_type   right_idx   = fresh[0];
+        leaf_type*   right       = leaf_at( right_idx );
+        const bool   append_leaf = leaf_idx == h->last_leaf && pos == leaf->count;
+        uint32_t     keep        = append_leaf ? static_cast<uint32_t>( leaf_capacity ) : ( leaf->count + 1 ) / 2;
+        if ( pos < keep )
+        {
+            --keep;
+            right->count = leaf->count - keep;
+            std::copy( leaf->keys + keep, leaf->keys + leaf->count, right->keys );
+            std::copy( leaf->values + keep, leaf->values + leaf->count, right->values );
+            leaf->count = keep;
+            insert_into_leaf( leaf, pos, key, val );
+        }
+        else
+        {
+            right->count = leaf->count - keep;
+            std::copy( leaf->keys + keep, leaf->keys + leaf->count, right->keys );
+            std::copy( leaf->values + keep, leaf->values + leaf->count, right->values );
+            leaf->count = keep;
+            insert_into_leaf( right, pos - keep, key, val );
+        }
+        right->prev = leaf_idx;
+        right->next = leaf->next;
+        if ( leaf->next != static_cast<index_type>( 0 ) )
+            leaf_at( leaf->next )->prev = right_idx;
+        else
+            h->last_leaf = right_idx;
+        leaf->next = right_idx;
+        ++h->size;
+        _K         sep       = right->keys[0];
+        index_type new_child = right_idx;
+        for ( uint32_t i = 1;; ++i )
+        {
+            if ( i > depth )
+            {
+                inner_type* root  = inner_at( fresh[i] );
+                root->count       = 1;
+                root->keys[0]     = sep;
+                root->children[0] = h->root;
+                root->children[1] = new_child;
+                h->root           = fresh[i];
+                ++h->height;
+                return;
+            }
+            const path_entry& at   = path[depth - i];
+            inner_type*       node = inner_at( at.node );
+            if ( node->count < inner_capacity )
+            {
+                insert_into_inner( node, at.pos, sep, new_child );
+                return;
+            }
+            inner_type* sibling = inner_at( fresh[i] );
+            _K          keys[inner_capacity + 1];
+            index_type  children[inner_capacity + 2];
+            std::copy( node->keys, node->keys + at.pos, keys );
+            keys[at.pos] = sep;
+            std::copy( node->keys + at.pos, node->keys + node->count, keys + at.pos + 1 );
+            std::copy( node->children, node->children + at.pos + 1, children );
+            children[at.pos + 1] = new_child;
+            std::copy( node->children + at.pos + 1, node->children + node->count + 1, children + at.pos + 2 );
+            const bool     append = append_leaf && at.pos == node->count;
+            const uint32_t total  = static_cast<uint32_t>( inner_capacity ) + 1;
+            const uint32_t mid    = append ? total - 2 : total / 2;
+            node->count           = mid;
+            std::copy( keys, keys + mid, node->keys );
+            std::copy( children, children + mid + 1, node->children );
+            sibling->count = total - mid - 1;
+            std::copy( keys + mid + 1, keys + total, sibling->keys );
+            std::copy( children + mid + 1, children + total + 1, sibling->children );
+            sep       = keys[mid];
+            new_child = fresh[i];
+        }
+    }
+/*
+### pmm-pbtree-rebalance
+*/
+    void rebalance_leaf( const path_entry& parent_at, index_type leaf_idx ) noexcept
+    {
+        inner_type*    parent = inner_at( parent_at.node );
+        leaf_type*     leaf   = leaf_at( leaf_idx );
+        const uint32_t pos    = parent_at.pos;
+        const uint32_t min    = static_cast<uint32_t>( leaf_capacity / 2 );
+        leaf_type*     left   = pos > 0 ? leaf_at( parent->children[pos - 1] ) : nullptr;
+        leaf_type*     right  = pos < parent->count ? leaf_at( parent->children[pos + 1] ) : nullptr;
+        if ( left != nullptr && left->count > min )
+        {
+            insert_into_leaf( leaf, 0, left->keys[left->count - 1], left->values[left->count - 1] );
+            --left->count;
+            parent->keys[pos - 1] = leaf->keys[0];
+            return;
+        }
+        if ( right != nullptr && right->count > min )
+        {
+            leaf->keys[leaf->count]   = right->keys[0];
+            leaf->values[leaf->count] = right->values[0];
+            ++leaf->count;
+            std::copy( right->keys + 1, right->keys + right->count, right->keys );
+            std::copy( right->values + 1, right->values + right->count, right->values );
+            --right->count;
+            parent->keys[pos] = right->keys[0];
+            return;
+        }
+        if ( left != nullptr )
+            merge_leaves( parent, pos - 1 );
+        else if ( right != nullptr )
+            merge_leaves( parent, pos );
+    }
+    void merge_leaves( inner_type* parent, uint32_t pos ) noexcept
+    {
+        index_type left_idx  = parent->children[pos];
+        index_type right_idx = parent->children[pos + 1];
+        leaf_type* left      = leaf_at( left_idx );
+        leaf_type* right     = leaf_at( right_idx );
+        std::copy( right->keys, right->keys + right->count, left->keys + left->count );
+        std::copy( right->values, right->values + right->count, left->values + left->count );
+        left->count += right->count;
+        left->next = right->next;
+        if ( right->next != static_cast<index_type>( 0 ) )
+            leaf_at( right->next )->prev = left_idx;
+        else
+            header()->last_leaf = left_idx;
+        remove_from_inner( parent, pos );
+        free_leaf( right_idx );
+    }
+    void rebalance_inner( const path_entry& parent_at, index_type node_idx ) noexcept
+    {
+        inner_type*    parent = inner_at( parent_at.node );
+        inner_type*    node   = inner_at( node_idx );
+        const uint32_t pos    = parent_at.pos;
+        const uint32_t min    = static_cast<uint32_t>( inner_capacity / 2 );
+        inner_type*    left   = pos > 0 ? inner_at( parent->children[pos - 1] ) : nullptr;
+        inner_type*    right  = pos < parent->count ? inner_at( parent->children[pos + 1] ) : nullptr;
+        if ( left != nullptr && left->count > min )
+        {
+            std::copy_backward( node->keys, node->keys + node->count, node->keys + node->count + 1 );
+            std::copy_backward( node->children, node->children + node->count + 1, node->children + node->count + 2 );
+            node->keys[0]         = parent->keys[pos - 1];
+            node->children[0]     = left->children[left->count];
+            parent->keys[pos - 1] = left->keys[left->count - 1];
+            --left->count;
+            ++node->count;
+            return;
+        }
+        if ( right != nullptr && right->count > min )
+        {
+            node->keys[node->count]         = parent->keys[pos];
+            node->children[node->count + 1] = right->children[0];
+            parent->keys[pos]               = right->keys[0];
+            ++node->count;
+            std::copy( right->keys + 1, right->keys + right->count, right->keys );
+            std::copy( right->children + 1, right->children + right->count + 1, right->children );
+            --right->count;
+            return;
+        }
+        if ( left != nullptr )
+            merge_inner( parent, pos - 1 );
+        else if ( right != nullptr )
+            merge_inner( parent, pos );
+    }
+    void merge_inner( inner_type* parent, uint32_t pos ) noexcept
+    {
+        index_type  right_idx   = parent->children[pos + 1];
+        inner_type* left        = inner_at( parent->children[pos] );
+        inner_type* right       = inner_at( right_idx );
+        left->keys[left->count] = parent->keys[pos];
+        std::copy( right->keys, right->keys + right->count, left->keys + left->count + 1 );
+        std::copy( right->children, right->children + right->count + 1, left->children + left->count + 1 );
+        left->count += right->count + 1;
+        remove_from_inner( parent, pos );
+        free_inner( right_idx );
+    }
+};
+}
@@ -0,0 +1,183 @@
+#pragma once
+#include "pmm/phashmap.h"
+#include "pmm/pmap.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+namespace pmm
+{
+template <typename _K, typename _V, typename ManagerT, size_t Stripes = 8, typename HashT = phashmap_hash<_K>>
+/*
+## pmm-pconcurrent_map
+req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
+*/
+class pconcurrent_map
+{
+  public:
+    using manager_type                   = ManagerT;
+    using index_type                     = typename ManagerT::index_type;
+    using stripe_type                    = pmap<_K, _V, ManagerT>;
+    using node_type                      = typename stripe_type::node_type;
+    using node_pptr                      = typename stripe_type::node_pptr;
+    static constexpr size_t stripe_count = Stripes;
+    static_assert( Stripes > 0, "pconcurrent_map: Stripes must be positive" );
+    pconcurrent_map() noexcept { bind( nullptr ); }
+    explicit pconcurrent_map( const char* domain_key ) noexcept { bind( domain_key ); }
+    pconcurrent_map( const pconcurrent_map& )            = delete;
+    pconcurrent_map& operator=( const pconcurrent_map& ) = delete;
+    bool is_bound() const noexcept { return _bound; }
+/*
+### pmm-pconcurrent_map-insert
+*/
+    bool insert( const _K& key, const _V& val ) noexcept
+    {
+        stripe&                             s = stripe_for( key );
+        std::unique_lock<std::shared_mutex> lock( s.mutex );
+        if ( !_bound )
+            return false;
+        {
+            auto read = ManagerT::read_lock();
+            if ( !stripe_bound_unlocked( s ) )
+                return false;
+            auto p = s.map.find( key );
+            if ( !p.is_null() )
+            {
+                ManagerT::template resolve_unchecked<node_type>( p )->value = val;
+                return true;
+            }
+        }
+        node_pptr fresh  = ManagerT::template allocate_typed<node_type>();
+        bool      linked = false;
+        if ( !fresh.is_null() )
+        {
+            auto read = ManagerT::read_lock();
+            linked    = !s.map.link_node( fresh, key, val ).is_null();
+        }
+        if ( !linked )
+            ManagerT::template deallocate_typed<node_type>( fresh );
+        return linked;
+    }
+    template <typename Fn> bool update( const _K& key, Fn&& fn ) noexcept
+    {
+        stripe&                             s    = stripe_for( key );
+        std::unique_lock<std::shared_mutex> lock( s.mutex );
+        auto                                read = ManagerT::read_lock();
+        auto                                p    = s.map.find( key );
+        if ( p.is_null() )
+            return false;
+        fn( ManagerT::template resolve_unchecked<node_type>( p )->value );
+        return true;
+    }
+/*
+### pmm-pconcurrent_map-find
+*/
+    bool find( const _K& key, _V& out ) const noexcept
+    {
+        const stripe&                       s    = stripe_for( key );
+        std::shared_lock<std::shared_mutex> lock( s.mutex );
+        auto                                read = ManagerT::read_lock();
+        auto                                p    = s.map.find( key );
+        if ( p.is_null() )
+            return false;
+        out = ManagerT::template resolve_unchecked<node_type>( p )->value;
+        return true;
+    }
+    bool contains( const _K& key ) const noexcept
+    {
+        const stripe&                       s    = stripe_for( key );
+        std::shared_lock<std::shared_mutex> lock( s.mutex );
+        auto                                read = ManagerT::read_lock();
+        return s.map.contains( key );
+    }
+    bool erase( const _K& key ) noexcept
+    {
+        stripe&                             s = stripe_for( key );
+        std::unique_lock<std::shared_mutex> lock( s.mutex );
+        node_pptr                           gone;
+        {
+            auto read = ManagerT::read_lock();
+            gone      = s.map.unlink( key );
+        }
+        ManagerT::template deallocate_typed<node_type>( gone );
+        return !gone.is_null();
+    }
+    void clear() noexcept
+    {
+        for ( stripe& s : _stripes )
+        {
+            std::unique_lock<std::shared_mutex> lock( s.mutex );
+            node_pptr                           root;
+            {
+                auto read = ManagerT::read_lock();
+                root      = s.map.detach_all();
+            }
+            stripe_type::free_subtree( root );
+        }
+    }
+    size_t size() const noexcept
+    {
+        size_t total = 0;
+        for ( const stripe& s : _stripes )
+        {
+            std::shared_lock<std::shared_mutex> lock( s.mutex );
+            auto                                read = ManagerT::read_lock();
+            total += s.map.size();
+        }
+        return total;
+    }
+    template <typename Fn> void for_each( Fn&& fn ) const
+    {
+        for ( const stripe& s : _stripes )
+        {
+            std::shared_lock<std::shared_mutex> lock( s.mutex );
+            auto                                read = ManagerT::read_lock();
+            for ( auto c = s.map.first(); c.valid(); ++c )
+            {
+                const auto* obj = ManagerT::template resolve_unchecked<node_type>( *c );
+                fn( obj->key, obj->value );
+            }
+        }
+    }
+    size_t stripe_of( const _K& key ) const noexcept { return static_cast<size_t>( HashT{}( key ) % Stripes ); }
+
+  private:
+    struct stripe
+    {
+        stripe_type               map;
+        mutable std::shared_mutex mutex;
+    };
+    static constexpr size_t kStripeKeyCapacity = 128;
+    stripe                  _stripes[Stripes];
+    bool                    _bound = false;
+    stripe&       stripe_for( const _K& key ) noexcept { return _stripes[stripe_of( key )]; }
+    const stripe& stripe_for( const _K& key ) const noexcept { return _stripes[stripe_of( key )]; }
+    static bool   stripe_bound_unlocked( const stripe& s ) noexcept
+    {
+        auto domain = s.map.forest_domain_view_ops().domain;
+        return domain.root_index_ptr() != nullptr;
+    }
+    void bind( const char* domain_key ) noexcept
+    {
+        _bound = true;
+        for ( size_t i = 0; i < Stripes; ++i )
+        {
+            if ( domain_key != nullptr && domain_key[0] != '\0' )
+            {
+                char name[kStripeKeyCapacity];
+                int  len = std::snprintf( name, sizeof( name ), "%s/stripe/%zu", domain_key, i );
+                if ( len < 0 || static_cast<size_t>( len ) >= sizeof( name ) )
+                {
+                    _bound = false;
+                    return;
+                }
+                _stripes[i].map = stripe_type( name );
+            }
+            (void)_stripes[i].map.forest_domain_ops();
+            auto read = ManagerT::read_lock();
+            _bound    = _bound && stripe_bound_unlocked( _stripes[i] );
+        }
+    }
+};
+}
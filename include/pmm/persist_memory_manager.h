@@ -6,6 +6,7 @@
 #elif __cplusplus < 202002L
 #error "pmm.h requires C++20 or later. Please compile with -std=c++20."
 #endif
+#include "pmm/alloc_scope.h"
 #include "pmm/allocator_policy.h"
 #include "pmm/arena_internals.h"
 #include "pmm/block.h"
@@ -15,6 +16,7 @@
 #include "pmm/layout.h"
 #include "pmm/logging_policy.h"
 #include "pmm/manager_configs.h"
+#include "pmm/page_watch.h"
 #include "pmm/pallocator.h"
 #include "pmm/parray.h"
 #include "pmm/pmap.h"
@@ -23,6 +25,7 @@
 #include "pmm/pstringview.h"
 #include "pmm/typed_manager_api.h"
 #include "pmm/types.h"
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstddef>
@@ -31,10 +34,12 @@
 #include <cstring>
 #include <limits>
 #include <new>
+#include <vector>
 namespace pmm
 {
 namespace detail
 {
+template <typename MgrT, typename Fn> bool with_shared_image( Fn&& fn );
 template <typename C, typename = void> struct config_logging_policy
 {
     using type = logging::NoLogging;
@@ -61,15 +66,20 @@ class PersistMemoryManager : public detail::PersistMemoryTypedApi<PersistMemoryM
     static_assert( ConfigT::grow_denominator >= 1, "ConfigT must define grow_denominator >= 1" );
     static_assert( ConfigT::grow_numerator >= ConfigT::grow_denominator,
                    "ConfigT::grow_numerator must be >= grow_denominator" );
-    using allocator       = AllocatorPolicy<free_block_tree, address_traits>;
-    using index_type      = typename address_traits::index_type;
-    using forest_registry = detail::ForestDomainRegistry<address_traits>;
-    using forest_domain   = detail::ForestDomainRecord<address_traits>;
-    using manager_type    = PersistMemoryManager<ConfigT, InstanceId>;
+    using allocator         = AllocatorPolicy<free_block_tree, address_traits>;
+    using index_type        = typename address_traits::index_type;
+    using forest_registry   = detail::ForestDomainRegistry<address_traits>;
+    using forest_domain     = detail::ForestDomainRecord<address_traits>;
+    using domain_root_cache = detail::DomainRootCache<address_traits>;
+    using manager_type      = PersistMemoryManager<ConfigT, InstanceId>;
     template <typename> friend struct pstringview;
     template <typename, typename, typename> friend struct pmap;
+    template <typename, typename, typename, typename> friend class phashmap;
+    template <typename, typename, typename, size_t> friend class pbtree;
+    template <typename, size_t> friend class psymbol_arena;
+    template <typename> friend struct detail::pmap_domain_binding;
     friend class detail::PersistMemoryTypedApi<manager_type>;
-    template <typename> friend bool save_manager( const char* );
+    template <typename MgrT, typename Fn> friend bool detail::with_shared_image( Fn&& );
     template <typename T> using pptr               = pmm::pptr<T, manager_type>;
     using pstringview                              = pmm::pstringview<manager_type>;
     using pstring                                  = pmm::pstring<manager_type>;
@@ -112,6 +122,8 @@ req: fr-001, fr-026, ur-001, feat-001
             _last_error = PmmError::BackendError;
             return false;
         }
+        bump_domain_epoch();
+        detach_page_watches_unlocked();
         detail::InitGuard guard( _initialized );
         if ( !init_layout( _backend.base_ptr(), _backend.total_size() ) )
         {
@@ -141,6 +153,8 @@ req: fr-001, fr-026, ur-001, feat-001
             _last_error = ( _backend.base_ptr() == nullptr ) ? PmmError::BackendError : PmmError::InvalidSize;
             return false;
         }
+        bump_domain_epoch();
+        detach_page_watches_unlocked();
         detail::InitGuard guard( _initialized );
         if ( !init_layout( _backend.base_ptr(), _backend.total_size() ) )
         {
@@ -237,6 +251,8 @@ req: fr-002, fr-014, ur-005, feat-001, feat-004, qa-rec-001, qa-compat-001
         allocator::repair_linked_list( arena_mut );
         allocator::recompute_counters( arena_mut );
         allocator::rebuild_free_tree( arena_mut );
+        bump_domain_epoch();
+        _image_generation.fetch_add( 1, std::memory_order_acq_rel );
         _initialized = true;
         {
             VerifyResult forest_verify;
@@ -277,6 +293,8 @@ req: fr-003, ur-001
         typename thread_policy::unique_lock_type lock( _mutex );
         if ( !_initialized )
             return;
+        bump_domain_epoch();
+        detach_page_watches_unlocked();
         _initialized = false;
         logging_policy::on_destroy();
     }
@@ -286,10 +304,92 @@ req: fr-003, ur-001
         uint8_t*                                 base = _backend.base_ptr();
         if ( base != nullptr && _backend.total_size() >= detail::kMinMemorySize )
             get_header( base )->magic = 0;
+        bump_domain_epoch();
+        detach_page_watches_unlocked();
         _initialized = false;
         logging_policy::on_destroy();
     }
-    static bool is_initialized() noexcept { return _initialized.load( std::memory_order_acquire ); }
+    static bool     is_initialized() noexcept { return _initialized.load( std::memory_order_acquire ); }
+    static typename thread_policy::shared_lock_type read_lock() noexcept
+    {
+        return typename thread_policy::shared_lock_type( _mutex );
+    }
+    static uint64_t domain_epoch() noexcept { return _domain_epoch.load( std::memory_order_acquire ); }
+/*
+### pmm-persistmemorymanager-attach_page_watch
+req: feat-004, fr-014, qa-rec-001
+*/
+    static bool attach_page_watch( detail::PageWatch& watch ) noexcept
+    {
+        typename thread_policy::unique_lock_type lock( _mutex );
+        return attach_page_watch_unlocked( watch );
+    }
+    static void detach_page_watch( detail::PageWatch& watch ) noexcept
+    {
+        typename thread_policy::unique_lock_type lock( _mutex );
+        detach_page_watch_unlocked( watch );
+    }
+/*
+### pmm-persistmemorymanager-begin_alloc_scope
+req: feat-002, fr-004, qa-rec-001
+*/
+    static bool begin_alloc_scope( detail::AllocScope<index_type>& scope ) noexcept
+    {
+        if ( scope.active || !_initialized.load( std::memory_order_acquire ) )
+            return false;
+        scope.clear();
+        scope.outer      = _alloc_scope;
+        scope.generation = _image_generation.load( std::memory_order_acquire );
+        scope.active     = true;
+        _alloc_scope     = &scope;
+        return true;
+    }
+    static bool commit_alloc_scope( detail::AllocScope<index_type>& scope ) noexcept
+    {
+        if ( !scope.active || ( scope.outer != nullptr && !scope.merge_into( *scope.outer ) ) )
+            return false;
+        end_alloc_scope( scope );
+        if ( scope.outer == nullptr )
+        {
+            typename thread_policy::unique_lock_type lock( _mutex );
+            if ( _initialized && _image_generation.load( std::memory_order_relaxed ) == scope.generation )
+            {
+                for ( index_type idx : scope.released )
+                    deallocate_unlocked( _backend.base_ptr() + static_cast<size_t>( idx ) * address_traits::granule_size );
+            }
+        }
+        scope.clear();
+        return true;
+    }
+    static bool rollback_alloc_scope( detail::AllocScope<index_type>& scope ) noexcept
+    {
+        if ( !scope.active )
+            return true;
+        end_alloc_scope( scope );
+        typename thread_policy::unique_lock_type lock( _mutex );
+        bool                                     ok = !scope.failed;
+        if ( !_initialized || _image_generation.load( std::memory_order_relaxed ) != scope.generation )
+        {
+            _last_error = PmmError::NotInitialized;
+            scope.clear();
+            return false;
+        }
+        uint8_t* base = _backend.base_ptr();
+        for ( size_t i = scope.roots.size(); i > 0; --i )
+            std::memcpy( base + scope.roots[i - 1].first, &scope.roots[i - 1].second, sizeof( index_type ) );
+        for ( size_t i = scope.allocated.size(); i > 0; --i )
+        {
+            if ( scope.allocated[i - 1] != 0 )
+                deallocate_unlocked( base + static_cast<size_t>( scope.allocated[i - 1] ) * address_traits::granule_size );
+        }
+        if ( !ok )
+        {
+            _last_error = PmmError::OutOfMemory;
+            logging_policy::on_corruption_detected( PmmError::OutOfMemory );
+        }
+        scope.clear();
+        return ok;
+    }
 /*
 ### pmm-persistmemorymanager-allocate
 req: fr-004, fr-021, fr-022, ur-002, feat-002
@@ -297,12 +397,13 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
     static void* allocate( size_t user_size ) noexcept
     {
         typename thread_policy::unique_lock_type lock( _mutex );
-        return allocate_unlocked( user_size );
+        return scope_track_unlocked( allocate_unlocked( user_size ) );
     }
     static void deallocate( void* ptr ) noexcept
     {
         typename thread_policy::unique_lock_type lock( _mutex );
-        deallocate_unlocked( ptr );
+        if ( !scope_defer_free_unlocked( ptr ) )
+            deallocate_unlocked( ptr );
     }
     static bool lock_block_permanent( void* ptr ) noexcept
     {
@@ -324,8 +425,9 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
         typename thread_policy::unique_lock_type lock( _mutex );
         if ( !_initialized )
             return;
-        set_forest_domain_root_index_unlocked( find_domain_by_name_unlocked( detail::kServiceNameDomainRoot ),
-                                               p.is_null() ? static_cast<index_type>( 0 ) : p.offset() );
+        forest_domain* rec = find_domain_by_name_unlocked( detail::kServiceNameDomainRoot );
+        scope_record_root_unlocked( forest_domain_root_index_ptr_unlocked( rec ) );
+        set_forest_domain_root_index_unlocked( rec, p.is_null() ? static_cast<index_type>( 0 ) : p.offset() );
     }
     template <typename T> static pptr<T> get_root() noexcept
     {
@@ -419,9 +521,26 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
         if ( !_initialized )
             return false;
         forest_domain* rec = find_domain_by_name_unlocked( name );
+        scope_record_root_unlocked( forest_domain_root_index_ptr_unlocked( rec ) );
         return set_forest_domain_root_index_unlocked( rec,
                                                       root.is_null() ? static_cast<index_type>( 0 ) : root.offset() );
     }
+    static bool set_domain_roots( const char* const* names, const index_type* roots, size_t count ) noexcept
+    {
+        typename thread_policy::unique_lock_type lock( _mutex );
+        if ( !_initialized || ( count != 0 && ( names == nullptr || roots == nullptr ) ) )
+            return false;
+        for ( size_t i = 0; i < count; ++i )
+            if ( forest_domain_root_index_ptr_unlocked( find_domain_by_name_unlocked( names[i] ) ) == nullptr )
+                return false;
+        for ( size_t i = 0; i < count; ++i )
+        {
+            forest_domain* rec = find_domain_by_name_unlocked( names[i] );
+            scope_record_root_unlocked( forest_domain_root_index_ptr_unlocked( rec ) );
+            set_forest_domain_root_index_unlocked( rec, roots[i] );
+        }
+        return true;
+    }
 
   private:
     template <typename T> static void* try_checked_block_from_pptr( pptr<T> p ) noexcept
@@ -632,8 +751,163 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
   private:
     static inline storage_backend                    _backend{};
     static inline std::atomic<bool>                  _initialized{ false };
+    static inline std::atomic<uint64_t>              _domain_epoch{ 1 };
     static inline typename thread_policy::mutex_type _mutex{};
     static inline thread_local PmmError              _last_error{ PmmError::Ok };
+    static inline std::atomic<detail::PageWatch*>    _page_watch{ nullptr };
+    static inline detail::PageWatchLatch             _page_watch_latch{};
+    static inline std::atomic<uint64_t>              _image_generation{ 0 };
+    static inline thread_local detail::AllocScope<index_type>* _alloc_scope = nullptr;
+    static bool touch_range_unlocked( size_t begin, size_t end ) noexcept
+    {
+        if ( _page_watch.load( std::memory_order_acquire ) == nullptr )
+            return true;
+        bool ok = true;
+        _page_watch_latch.lock_shared();
+        for ( detail::PageWatch* w = _page_watch.load( std::memory_order_acquire ); w != nullptr; w = w->next )
+            ok = w->touch( _backend.base_ptr(), _backend.total_size(), begin, std::min( end, _backend.total_size() ) ) &&
+                 ok;
+        _page_watch_latch.unlock_shared();
+        return ok;
+    }
+    static void touch_block_unlocked( index_type idx, index_type data_gran ) noexcept
+    {
+        if ( _page_watch.load( std::memory_order_acquire ) == nullptr )
+            return;
+        constexpr size_t kGranSz = address_traits::granule_size;
+        const uint8_t*   base    = _backend.base_ptr();
+        const index_type next    = BlockStateBase<address_traits>::get_next_offset( detail::block_at<address_traits>( base, idx ) );
+        const index_type around[] = {
+            BlockStateBase<address_traits>::get_prev_offset( detail::block_at<address_traits>( base, idx ) ), next,
+            next == address_traits::no_block
+                ? next
+                : BlockStateBase<address_traits>::get_next_offset( detail::block_at<address_traits>( base, next ) ) };
+        for ( index_type n : around )
+        {
+            if ( n != address_traits::no_block )
+                touch_range_unlocked( static_cast<size_t>( n ) * kGranSz,
+                                      static_cast<size_t>( n ) * kGranSz + kBlockHdrByteSize );
+        }
+        touch_range_unlocked( static_cast<size_t>( idx ) * kGranSz,
+                              ( static_cast<size_t>( idx ) + kBlockHdrGranules + data_gran ) * kGranSz +
+                                  kBlockHdrByteSize );
+    }
+    static bool attach_page_watch_unlocked( detail::PageWatch& watch ) noexcept
+    {
+        if ( _backend.base_ptr() == nullptr || watch.detach != nullptr || watch.check_page == nullptr )
+            return false;
+        _page_watch_latch.lock();
+        watch.detach = &detach_page_watch;
+        watch.next   = _page_watch.load( std::memory_order_relaxed );
+        _page_watch.store( &watch, std::memory_order_release );
+        _page_watch_latch.unlock();
+        return true;
+    }
+    static void detach_page_watch_unlocked( detail::PageWatch& watch ) noexcept
+    {
+        _page_watch_latch.lock();
+        detail::PageWatch* head = _page_watch.load( std::memory_order_relaxed );
+        if ( head == &watch )
+            _page_watch.store( watch.next, std::memory_order_release );
+        for ( detail::PageWatch* w = head; w != nullptr; w = w->next )
+        {
+            if ( w->next == &watch )
+                w->next = watch.next;
+        }
+        watch.detach = nullptr;
+        watch.next   = nullptr;
+        _page_watch_latch.unlock();
+    }
+    static void detach_page_watches_unlocked() noexcept
+    {
+        _image_generation.fetch_add( 1, std::memory_order_acq_rel );
+        _page_watch_latch.lock();
+        for ( detail::PageWatch* w = _page_watch.exchange( nullptr ); w != nullptr; )
+        {
+            detail::PageWatch* next = w->next;
+            w->detach               = nullptr;
+            w->next                 = nullptr;
+            w                       = next;
+        }
+        _page_watch_latch.unlock();
+    }
+    static void end_alloc_scope( detail::AllocScope<index_type>& scope ) noexcept
+    {
+        for ( detail::AllocScope<index_type>** link = &_alloc_scope; *link != nullptr; link = &( *link )->outer )
+        {
+            if ( *link == &scope )
+            {
+                *link = scope.outer;
+                break;
+            }
+        }
+        scope.active = false;
+    }
+    static index_type scope_user_index_unlocked( const void* ptr ) noexcept
+    {
+        return static_cast<index_type>( static_cast<size_t>( static_cast<const uint8_t*>( ptr ) - _backend.base_ptr() ) /
+                                        address_traits::granule_size );
+    }
+    static bool scope_reserve_unlocked( size_t count ) noexcept
+    {
+        return _alloc_scope == nullptr || _alloc_scope->rolling_back || _alloc_scope->reserve( count );
+    }
+    static void* scope_track_unlocked( void* raw ) noexcept
+    {
+        detail::AllocScope<index_type>* scope = _alloc_scope;
+        if ( raw == nullptr || scope == nullptr || scope->rolling_back ||
+             scope->track( scope_user_index_unlocked( raw ) ) )
+            return raw;
+        deallocate_unlocked( raw );
+        _last_error = PmmError::OutOfMemory;
+        return nullptr;
+    }
+    static bool scope_defer_free_unlocked( const void* ptr ) noexcept
+    {
+        detail::AllocScope<index_type>* scope = _alloc_scope;
+        if ( ptr == nullptr || scope == nullptr || !_initialized )
+            return false;
+        if ( !scope->rolling_back )
+            return scope->defer( scope_user_index_unlocked( ptr ) );
+        scope->forget( scope_user_index_unlocked( ptr ) );
+        return false;
+    }
+    static void scope_record_root_unlocked( const index_type* slot ) noexcept
+    {
+        detail::AllocScope<index_type>* scope = _alloc_scope;
+        if ( slot != nullptr && scope != nullptr && !scope->rolling_back )
+            scope->record_root( static_cast<size_t>( reinterpret_cast<const uint8_t*>( slot ) - _backend.base_ptr() ),
+                                *slot );
+    }
+    static void* allocate_from_block_unlocked( index_type idx, index_type data_gran ) noexcept
+    {
+        uint8_t* base = _backend.base_ptr();
+        touch_block_unlocked( idx, data_gran );
+        return allocator::allocate_from_block( detail::ArenaView<address_traits>{ base, get_header( base ) }, idx,
+                                               data_gran );
+    }
+    static void release_block_unlocked( pmm::Block<address_traits>* blk ) noexcept
+    {
+        const pmm::NodeType nt = BlockStateBase<address_traits>::get_node_type( blk );
+        if ( !pmm::is_allocated( nt ) || !pmm::can_be_deleted_from_pap( nt ) )
+            return;
+        index_type freed = BlockStateBase<address_traits>::get_weight( blk );
+        if ( freed == 0 )
+            return;
+        uint8_t*                               base       = _backend.base_ptr();
+        detail::ManagerHeader<address_traits>* hdr        = get_header( base );
+        index_type                             blk_idx    = detail::block_idx_t<address_traits>( base, blk );
+        index_type                             total_gran = detail::physical_block_total_granules<address_traits>(
+            base, hdr, detail::block_at<address_traits>( base, blk_idx ) );
+        touch_block_unlocked( blk_idx, 0 );
+        AllocatedBlock<address_traits> alloc = AllocatedBlock<address_traits>::cast_from_raw( blk );
+        alloc.mark_as_free( total_gran );
+        hdr->alloc_count--;
+        hdr->free_count++;
+        if ( hdr->used_size >= freed )
+            hdr->used_size -= freed;
+        allocator::coalesce( detail::ArenaView<address_traits>{ base, hdr }, blk_idx );
+    }
     static bool is_valid_user_offset_unlocked( index_type off, size_t size_bytes ) noexcept
     {
         if ( off == 0 || _backend.base_ptr() == nullptr || _backend.total_size() == 0 )
@@ -684,7 +958,7 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
         if ( idx != address_traits::no_block )
         {
             _last_error = PmmError::Ok;
-            return allocator::allocate_from_block( detail::ArenaView<address_traits>{ base, hdr }, idx, data_gran );
+            return allocate_from_block_unlocked( idx, data_gran );
         }
         if ( !do_expand( data_gran ) )
         {
@@ -698,7 +972,7 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
         if ( idx != address_traits::no_block )
         {
             _last_error = PmmError::Ok;
-            return allocator::allocate_from_block( detail::ArenaView<address_traits>{ base, hdr }, idx, data_gran );
+            return allocate_from_block_unlocked( idx, data_gran );
         }
         _last_error = PmmError::OutOfMemory;
         logging_policy::on_allocation_failure( user_size, PmmError::OutOfMemory );
@@ -709,26 +983,8 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
         if ( !_initialized || ptr == nullptr )
             return;
         pmm::Block<address_traits>* blk = find_block_from_user_ptr( ptr );
-        if ( blk == nullptr )
-            return;
-        const pmm::NodeType nt = BlockStateBase<address_traits>::get_node_type( blk );
-        if ( !pmm::is_allocated( nt ) || !pmm::can_be_deleted_from_pap( nt ) )
-            return;
-        index_type freed = BlockStateBase<address_traits>::get_weight( blk );
-        if ( freed == 0 )
-            return;
-        uint8_t*                               base       = _backend.base_ptr();
-        detail::ManagerHeader<address_traits>* hdr        = get_header( base );
-        index_type                             blk_idx    = detail::block_idx_t<address_traits>( base, blk );
-        index_type                             total_gran = detail::physical_block_total_granules<address_traits>(
-            base, hdr, detail::block_at<address_traits>( base, blk_idx ) );
-        AllocatedBlock<address_traits> alloc = AllocatedBlock<address_traits>::cast_from_raw( blk );
-        alloc.mark_as_free( total_gran );
-        hdr->alloc_count--;
-        hdr->free_count++;
-        if ( hdr->used_size >= freed )
-            hdr->used_size -= freed;
-        allocator::coalesce( detail::ArenaView<address_traits>{ base, hdr }, blk_idx );
+        if ( blk != nullptr )
+            release_block_unlocked( blk );
     }
     static bool lock_block_permanent_unlocked( void* ptr ) noexcept
     {
@@ -740,6 +996,9 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
         const pmm::NodeType nt = BlockStateBase<address_traits>::get_node_type( blk );
         if ( !pmm::is_allocated( nt ) )
             return false;
+        touch_range_unlocked( static_cast<size_t>( reinterpret_cast<uint8_t*>( blk ) - _backend.base_ptr() ),
+                              static_cast<size_t>( reinterpret_cast<uint8_t*>( blk ) - _backend.base_ptr() ) +
+                                  kBlockHdrByteSize );
         BlockStateBase<address_traits>::set_node_type_of( blk, pmm::NodeType::ReadOnlyLocked );
         return true;
     }
@@ -802,7 +1061,18 @@ req: fr-004, fr-021, fr-022, ur-002, feat-002
     }
     static bool do_expand( index_type data_gran ) noexcept
     {
-        return detail::ManagerLayoutOps<layout_access>::do_expand( _backend, _initialized, data_gran );
+        const size_t tail = _initialized ? static_cast<size_t>( get_header( _backend.base_ptr() )->last_block_offset ) *
+                                               address_traits::granule_size
+                                         : 0;
+        touch_range_unlocked( tail, tail + kBlockHdrByteSize );
+        _page_watch_latch.lock();
+        const bool expanded = detail::ManagerLayoutOps<layout_access>::do_expand( _backend, _initialized, data_gran );
+        _page_watch_latch.unlock();
+        if ( !expanded )
+            return false;
+        bump_domain_epoch();
+        return true;
     }
+    static void bump_domain_epoch() noexcept { _domain_epoch.fetch_add( 1, std::memory_order_acq_rel ); }
 };
 }
@@ -0,0 +1,419 @@
+#pragma once
+#include "pmm/forest_registry.h"
+#include "pmm/pmap.h"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#if defined( __SSE2__ ) || defined( _M_X64 ) || defined( _M_AMD64 )
+#include <emmintrin.h>
+#endif
+namespace pmm
+{
+template <typename _K, typename _V> struct phashmap_slot
+{
+    _K key;
+    _V value;
+};
+template <typename IndexT> struct phashmap_header
+{
+    uint64_t size;
+    uint64_t capacity;
+    uint64_t used;
+    uint64_t old_capacity;
+    uint64_t migrate_pos;
+    IndexT   ctrl;
+    IndexT   slots;
+    IndexT   old_ctrl;
+    IndexT   old_slots;
+};
+namespace detail
+{
+inline constexpr uint8_t kPhashEmpty       = 0x80;
+inline constexpr uint8_t kPhashDeleted     = 0xFE;
+inline constexpr size_t  kPhashGroupWidth  = 16;
+inline constexpr size_t  kPhashMigrateStep = 64;
+inline constexpr size_t  kPhashNotFound    = ~static_cast<size_t>( 0 );
+inline uint64_t          phash_mix( uint64_t x ) noexcept
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+#if defined( __SSE2__ ) || defined( _M_X64 ) || defined( _M_AMD64 )
+inline uint32_t phash_group_match( const uint8_t* group, uint8_t h2 ) noexcept
+{
+    const __m128i ctrl = _mm_loadu_si128( reinterpret_cast<const __m128i*>( group ) );
+    return static_cast<uint32_t>(
+        _mm_movemask_epi8( _mm_cmpeq_epi8( ctrl, _mm_set1_epi8( static_cast<char>( h2 ) ) ) ) );
+}
+inline uint32_t phash_group_match_free( const uint8_t* group ) noexcept
+{
+    return static_cast<uint32_t>(
+        _mm_movemask_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( group ) ) ) );
+}
+#else
+inline uint32_t phash_group_match( const uint8_t* group, uint8_t h2 ) noexcept
+{
+    uint32_t mask = 0;
+    for ( size_t i = 0; i < kPhashGroupWidth; ++i )
+        mask |= static_cast<uint32_t>( group[i] == h2 ) << i;
+    return mask;
+}
+inline uint32_t phash_group_match_free( const uint8_t* group ) noexcept
+{
+    uint32_t mask = 0;
+    for ( size_t i = 0; i < kPhashGroupWidth; ++i )
+        mask |= static_cast<uint32_t>( group[i] >> 7 ) << i;
+    return mask;
+}
+#endif
+inline uint32_t phash_group_match_empty( const uint8_t* group ) noexcept
+{
+    return phash_group_match( group, kPhashEmpty );
+}
+inline uint64_t phash_capacity_for( uint64_t count ) noexcept
+{
+    uint64_t cap = kPhashGroupWidth;
+    while ( cap * 7 < count * 16 )
+        cap *= 2;
+    return cap;
+}
+inline uint64_t phash_max_load( uint64_t capacity ) noexcept
+{
+    return capacity - capacity / 8;
+}
+}
+template <typename T> struct phashmap_hash
+{
+    uint64_t operator()( const T& key ) const noexcept
+    {
+        static_assert( std::is_trivially_copyable_v<T>, "phashmap_hash<T>: specialize for non-trivial keys" );
+        if constexpr ( std::is_integral_v<T> || std::is_enum_v<T> )
+        {
+            return detail::phash_mix( static_cast<uint64_t>( key ) );
+        }
+        else
+        {
+            uint8_t bytes[sizeof( T )];
+            std::memcpy( bytes, &key, sizeof( T ) );
+            uint64_t h = 14695981039346656037ull;
+            for ( uint8_t b : bytes )
+            {
+                h ^= b;
+                h *= 1099511628211ull;
+            }
+            return detail::phash_mix( h );
+        }
+    }
+};
+template <typename _K, typename _V, typename ManagerT, typename HashT = phashmap_hash<_K>>
+/*
+## pmm-phashmap
+req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
+*/
+class phashmap : public detail::pmap_domain_binding<ManagerT>
+{
+    using binding_type = detail::pmap_domain_binding<ManagerT>;
+
+  public:
+    using manager_type = ManagerT;
+    using index_type   = typename ManagerT::index_type;
+    using slot_type    = phashmap_slot<_K, _V>;
+    using header_type  = phashmap_header<index_type>;
+    static_assert( std::is_trivially_copyable_v<_K> && std::is_trivially_copyable_v<_V>,
+                   "phashmap: keys and values must be trivially copyable" );
+    phashmap() noexcept { bind( nullptr ); }
+    explicit phashmap( const char* domain_key ) noexcept { bind( domain_key ); }
+    phashmap( const phashmap& )            = delete;
+    phashmap& operator=( const phashmap& ) = delete;
+    using binding_type::root_index;
+    size_t size() const noexcept
+    {
+        const header_type* h = header();
+        return h == nullptr ? 0 : static_cast<size_t>( h->size );
+    }
+    bool   empty() const noexcept { return size() == 0; }
+    size_t capacity() const noexcept
+    {
+        const header_type* h = header();
+        return h == nullptr ? 0 : static_cast<size_t>( h->capacity );
+    }
+    bool rehash_in_progress() const noexcept
+    {
+        const header_type* h = header();
+        return h != nullptr && h->old_ctrl != static_cast<index_type>( 0 );
+    }
+/*
+### pmm-phashmap-find
+*/
+    _V* find( const _K& key ) noexcept
+    {
+        slot_type* s = find_slot( header(), key, HashT{}( key ) );
+        return s == nullptr ? nullptr : &s->value;
+    }
+    const _V* find( const _K& key ) const noexcept
+    {
+        const slot_type* s = find_slot( header(), key, HashT{}( key ) );
+        return s == nullptr ? nullptr : &s->value;
+    }
+    bool contains( const _K& key ) const noexcept { return find( key ) != nullptr; }
+/*
+### pmm-phashmap-insert
+*/
+    bool insert( const _K& key, const _V& val ) noexcept
+    {
+        header_type* h = ensure_header();
+        if ( h == nullptr )
+            return false;
+        const uint64_t hash = HashT{}( key );
+        if ( slot_type* s = find_slot( h, key, hash ) )
+        {
+            s->value = val;
+            migrate( detail::kPhashMigrateStep );
+            return true;
+        }
+        if ( h->used + 1 > detail::phash_max_load( h->capacity ) )
+        {
+            if ( !grow( h->size + 1 ) )
+                return false;
+            h = header();
+        }
+        place( h, slot_type{ key, val }, hash );
+        ++h->size;
+        migrate( detail::kPhashMigrateStep );
+        return true;
+    }
+/*
+### pmm-phashmap-erase
+*/
+    bool erase( const _K& key ) noexcept
+    {
+        header_type* h = header();
+        if ( h == nullptr )
+            return false;
+        const uint64_t hash    = HashT{}( key );
+        bool           removed = erase_from( ctrl_at( h->ctrl ), slots_at( h->slots ), h->capacity, key, hash,
+                                             &h->used );
+        if ( !removed && h->old_ctrl != static_cast<index_type>( 0 ) )
+            removed =
+                erase_from( ctrl_at( h->old_ctrl ), slots_at( h->old_slots ), h->old_capacity, key, hash, nullptr );
+        if ( !removed )
+            return false;
+        --h->size;
+        migrate( detail::kPhashMigrateStep );
+        return true;
+    }
+    bool reserve( size_t count ) noexcept
+    {
+        header_type* h = ensure_header();
+        if ( h == nullptr )
+            return false;
+        return detail::phash_capacity_for( count ) <= h->capacity || grow( count );
+    }
+    void clear() noexcept
+    {
+        header_type* h = header();
+        if ( h == nullptr )
+            return;
+        release_arrays( h->ctrl, h->slots );
+        release_arrays( h->old_ctrl, h->old_slots );
+        ManagerT::template deallocate_typed<header_type>(
+            typename ManagerT::template pptr<header_type>( root_index() ) );
+        if ( index_type* root = root_slot() )
+            *root = static_cast<index_type>( 0 );
+    }
+    template <typename FnT> void for_each( FnT&& fn ) const
+    {
+        const header_type* h = header();
+        if ( h == nullptr )
+            return;
+        visit( ctrl_at( h->ctrl ), slots_at( h->slots ), h->capacity, fn );
+        if ( h->old_ctrl != static_cast<index_type>( 0 ) )
+            visit( ctrl_at( h->old_ctrl ), slots_at( h->old_slots ), h->old_capacity, fn );
+    }
+
+  private:
+    using binding_type::root_slot;
+    void bind( const char* domain_key ) noexcept
+    {
+        constexpr uint32_t kTypeHash = detail::pmap_fnv1a(
+            detail::pmap_fnv1a( 0x68617368u, detail::pmap_type_fp<_K>(), 4 ), detail::pmap_type_fp<_V>(), 4 );
+        this->bind_domain( kTypeHash, domain_key );
+    }
+    template <typename T> static T* resolve( index_type idx ) noexcept
+    {
+        return detail::pmap_resolve<T, ManagerT>( idx );
+    }
+    static uint8_t*   ctrl_at( index_type idx ) noexcept { return resolve<uint8_t>( idx ); }
+    static slot_type* slots_at( index_type idx ) noexcept { return resolve<slot_type>( idx ); }
+    header_type*      header() const noexcept { return resolve<header_type>( root_index() ); }
+    header_type*      ensure_header() noexcept
+    {
+        if ( header_type* h = header() )
+            return h;
+        if ( root_slot() == nullptr )
+            return nullptr;
+        auto p = ManagerT::template allocate_typed<header_type>();
+        if ( p.is_null() )
+            return nullptr;
+        header_type* h = resolve<header_type>( p.offset() );
+        std::memset( h, 0, sizeof( header_type ) );
+        *root_slot() = p.offset();
+        return h;
+    }
+    static size_t locate( const uint8_t* ctrl, const slot_type* slots, uint64_t capacity, const _K& key,
+                          uint64_t hash ) noexcept
+    {
+        if ( capacity == 0 )
+            return detail::kPhashNotFound;
+        const size_t  mask  = static_cast<size_t>( capacity / detail::kPhashGroupWidth ) - 1;
+        const uint8_t h2    = static_cast<uint8_t>( hash & 0x7f );
+        size_t        group = static_cast<size_t>( hash >> 7 ) & mask;
+        for ( size_t step = 1; step <= mask + 1; ++step )
+        {
+            const uint8_t* g = ctrl + group * detail::kPhashGroupWidth;
+            for ( uint32_t m = detail::phash_group_match( g, h2 ); m != 0; m &= m - 1 )
+            {
+                size_t i = group * detail::kPhashGroupWidth + static_cast<size_t>( std::countr_zero( m ) );
+                if ( slots[i].key == key )
+                    return i;
+            }
+            if ( detail::phash_group_match_empty( g ) != 0 )
+                break;
+            group = ( group + step ) & mask;
+        }
+        return detail::kPhashNotFound;
+    }
+    static slot_type* find_slot( const header_type* h, const _K& key, uint64_t hash ) noexcept
+    {
+        if ( h == nullptr )
+            return nullptr;
+        slot_type* slots = slots_at( h->slots );
+        size_t     i     = locate( ctrl_at( h->ctrl ), slots, h->capacity, key, hash );
+        if ( i != detail::kPhashNotFound )
+            return slots + i;
+        if ( h->old_ctrl == static_cast<index_type>( 0 ) )
+            return nullptr;
+        slots = slots_at( h->old_slots );
+        i     = locate( ctrl_at( h->old_ctrl ), slots, h->old_capacity, key, hash );
+        return i == detail::kPhashNotFound ? nullptr : slots + i;
+    }
+    static void place( header_type* h, const slot_type& slot, uint64_t hash ) noexcept
+    {
+        uint8_t*     ctrl  = ctrl_at( h->ctrl );
+        const size_t mask  = static_cast<size_t>( h->capacity / detail::kPhashGroupWidth ) - 1;
+        size_t       group = static_cast<size_t>( hash >> 7 ) & mask;
+        for ( size_t step = 1;; ++step )
+        {
+            uint32_t m = detail::phash_group_match_free( ctrl + group * detail::kPhashGroupWidth );
+            if ( m != 0 )
+            {
+                size_t i = group * detail::kPhashGroupWidth + static_cast<size_t>( std::countr_zero( m ) );
+                if ( ctrl[i] == detail::kPhashEmpty )
+                    ++h->used;
+                ctrl[i]                 = static_cast<uint8_t>( hash & 0x7f );
+                slots_at( h->slots )[i] = slot;
+                return;
+            }
+            group = ( group + step ) & mask;
+        }
+    }
+    static bool erase_from( uint8_t* ctrl, const slot_type* slots, uint64_t capacity, const _K& key, uint64_t hash,
+                            uint64_t* used ) noexcept
+    {
+        size_t i = locate( ctrl, slots, capacity, key, hash );
+        if ( i == detail::kPhashNotFound )
+            return false;
+        const uint8_t* g = ctrl + ( i / detail::kPhashGroupWidth ) * detail::kPhashGroupWidth;
+        if ( used != nullptr && detail::phash_group_match_empty( g ) != 0 )
+        {
+            ctrl[i] = detail::kPhashEmpty;
+            --*used;
+        }
+        else
+        {
+            ctrl[i] = detail::kPhashDeleted;
+        }
+        return true;
+    }
+    static void release_arrays( index_type ctrl, index_type slots ) noexcept
+    {
+        if ( ctrl != static_cast<index_type>( 0 ) )
+            ManagerT::template deallocate_typed<uint8_t>( typename ManagerT::template pptr<uint8_t>( ctrl ) );
+        if ( slots != static_cast<index_type>( 0 ) )
+            ManagerT::template deallocate_typed<slot_type>( typename ManagerT::template pptr<slot_type>( slots ) );
+    }
+/*
+### pmm-phashmap-grow
+*/
+    bool grow( uint64_t needed ) noexcept
+    {
+        migrate( ~static_cast<size_t>( 0 ) );
+        header_type*   h       = header();
+        const uint64_t new_cap = std::max( detail::phash_capacity_for( needed ), h->capacity );
+        auto           ctrl    = ManagerT::template allocate_typed<uint8_t>( static_cast<size_t>( new_cap ) );
+        if ( ctrl.is_null() )
+            return false;
+        auto slots = ManagerT::template allocate_typed<slot_type>( static_cast<size_t>( new_cap ) );
+        if ( slots.is_null() )
+        {
+            ManagerT::template deallocate_typed<uint8_t>( ctrl );
+            return false;
+        }
+        std::memset( ctrl_at( ctrl.offset() ), detail::kPhashEmpty, static_cast<size_t>( new_cap ) );
+        h               = header();
+        h->old_ctrl     = h->ctrl;
+        h->old_slots    = h->slots;
+        h->old_capacity = h->capacity;
+        h->migrate_pos  = 0;
+        h->ctrl         = ctrl.offset();
+        h->slots        = slots.offset();
+        h->capacity     = new_cap;
+        h->used         = 0;
+        if ( h->old_ctrl == static_cast<index_type>( 0 ) )
+            h->old_capacity = 0;
+        return true;
+    }
+/*
+### pmm-phashmap-migrate
+*/
+    void migrate( size_t budget ) noexcept
+    {
+        header_type* h = header();
+        if ( h == nullptr || h->old_ctrl == static_cast<index_type>( 0 ) )
+            return;
+        uint8_t*         old_ctrl  = ctrl_at( h->old_ctrl );
+        const slot_type* old_slots = slots_at( h->old_slots );
+        for ( ; budget > 0 && h->migrate_pos < h->old_capacity; --budget, ++h->migrate_pos )
+        {
+            const size_t i = static_cast<size_t>( h->migrate_pos );
+            if ( ( old_ctrl[i] & detail::kPhashEmpty ) != 0 )
+                continue;
+            old_ctrl[i] = detail::kPhashDeleted;
+            place( h, old_slots[i], HashT{}( old_slots[i].key ) );
+        }
+        if ( h->migrate_pos < h->old_capacity )
+            return;
+        release_arrays( h->old_ctrl, h->old_slots );
+        h->old_ctrl     = 0;
+        h->old_slots    = 0;
+        h->old_capacity = 0;
+        h->migrate_pos  = 0;
+    }
+    template <typename FnT>
+    static void visit( const uint8_t* ctrl, const slot_type* slots, uint64_t capacity, FnT& fn )
+    {
+        for ( uint64_t i = 0; i < capacity; ++i )
+        {
+            if ( ( ctrl[i] & detail::kPhashEmpty ) == 0 )
+                fn( slots[i].key, slots[i].value );
+        }
+    }
+};
+}
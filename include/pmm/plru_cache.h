@@ -0,0 +1,379 @@
+#pragma once
+#include "pmm/phashmap.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+namespace pmm
+{
+enum class CachePolicy : uint8_t
+{
+    Lru   = 0,
+    Clock = 1,
+};
+template <typename IndexT> struct plru_header
+{
+    uint64_t count;
+    uint64_t bytes;
+    uint64_t capacity_bytes;
+    uint64_t bucket_count;
+    IndexT   buckets;
+    IndexT   head;
+    IndexT   tail;
+};
+template <typename K, typename V, typename IndexT> struct plru_entry
+{
+    K        key;
+    V        value;
+    uint64_t hash;
+    IndexT   chain;
+    IndexT   prev;
+    IndexT   next;
+    uint8_t  referenced;
+};
+template <typename K, typename V, typename ManagerT, CachePolicy Policy = CachePolicy::Lru,
+          typename HashT = phashmap_hash<K>>
+/*
+## pmm-plru_cache
+req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
+*/
+class plru_cache
+{
+  public:
+    static_assert( std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                   "plru_cache: keys and values must be trivially copyable" );
+    using manager_type   = ManagerT;
+    using index_type     = typename ManagerT::index_type;
+    using header_type    = plru_header<index_type>;
+    using entry_type     = plru_entry<K, V, index_type>;
+    using evict_callback = void ( * )( const K& key, const V& value, void* context );
+    static constexpr CachePolicy policy = Policy;
+    static constexpr size_t      entry_charge =
+        detail::manager_header_offset_bytes_v<typename ManagerT::address_traits> +
+        ( sizeof( entry_type ) + ManagerT::address_traits::granule_size - 1 ) /
+            ManagerT::address_traits::granule_size * ManagerT::address_traits::granule_size;
+    explicit plru_cache( const char* domain_key = nullptr, size_t capacity_bytes = size_t{ 1 } << 20 ) noexcept
+    {
+        bind( domain_key, capacity_bytes );
+    }
+    plru_cache( const plru_cache& )            = delete;
+    plru_cache& operator=( const plru_cache& ) = delete;
+    bool        is_bound() const noexcept { return _header != static_cast<index_type>( 0 ); }
+    index_type  root_index() const noexcept { return _header; }
+    void        set_eviction_callback( evict_callback fn, void* context = nullptr ) noexcept
+    {
+        std::unique_lock<std::shared_mutex> lock( *_mutex );
+        _on_evict = fn;
+        _context  = context;
+    }
+    size_t size() const noexcept
+    {
+        std::shared_lock<std::shared_mutex> lock( *_mutex );
+        const header_type*                  h = header();
+        return h == nullptr ? 0 : static_cast<size_t>( h->count );
+    }
+    bool   empty() const noexcept { return size() == 0; }
+    size_t bytes() const noexcept
+    {
+        std::shared_lock<std::shared_mutex> lock( *_mutex );
+        const header_type*                  h = header();
+        return h == nullptr ? 0 : static_cast<size_t>( h->bytes );
+    }
+    size_t capacity_bytes() const noexcept
+    {
+        std::shared_lock<std::shared_mutex> lock( *_mutex );
+        const header_type*                  h = header();
+        return h == nullptr ? 0 : static_cast<size_t>( h->capacity_bytes );
+    }
+    void set_capacity_bytes( size_t capacity ) noexcept
+    {
+        std::unique_lock<std::shared_mutex> lock( *_mutex );
+        if ( header_type* h = header() )
+        {
+            h->capacity_bytes = capacity;
+            evict_to_fit( 0 );
+        }
+    }
+/*
+### pmm-plru_cache-get
+*/
+    bool get( const K& key, V& out ) noexcept
+    {
+        if constexpr ( Policy == CachePolicy::Clock )
+        {
+            std::shared_lock<std::shared_mutex> lock( *_mutex );
+            entry_type*                         e = find_entry( key, HashT{}( key ) );
+            if ( e == nullptr )
+                return false;
+            std::atomic_ref<uint8_t>( e->referenced ).store( 1, std::memory_order_relaxed );
+            out = e->value;
+            return true;
+        }
+        else
+        {
+            std::unique_lock<std::shared_mutex> lock( *_mutex );
+            const index_type                    idx = find_index( key, HashT{}( key ) );
+            if ( idx == static_cast<index_type>( 0 ) )
+                return false;
+            move_to_front( idx );
+            out = entry( idx )->value;
+            return true;
+        }
+    }
+    bool contains( const K& key ) const noexcept
+    {
+        std::shared_lock<std::shared_mutex> lock( *_mutex );
+        return find_index( key, HashT{}( key ) ) != static_cast<index_type>( 0 );
+    }
+/*
+### pmm-plru_cache-put
+*/
+    bool put( const K& key, const V& value ) noexcept
+    {
+        std::unique_lock<std::shared_mutex> lock( *_mutex );
+        header_type*                        h = header();
+        if ( h == nullptr )
+            return false;
+        const uint64_t hash = HashT{}( key );
+        if ( const index_type idx = find_index( key, hash ); idx != static_cast<index_type>( 0 ) )
+        {
+            entry( idx )->value = value;
+            move_to_front( idx );
+            return true;
+        }
+        if ( entry_charge > h->capacity_bytes )
+            return false;
+        evict_to_fit( entry_charge );
+        if ( header()->count + 1 > header()->bucket_count && !grow_buckets( header()->bucket_count * 2 ) )
+            return false;
+        auto p = ManagerT::template allocate_typed<entry_type>();
+        if ( p.is_null() )
+            return false;
+        const index_type idx = p.offset();
+        entry_type*      e   = entry( idx );
+        std::memset( static_cast<void*>( e ), 0, sizeof( entry_type ) );
+        e->key   = key;
+        e->value = value;
+        e->hash  = hash;
+        h        = header();
+        index_type& bucket = buckets( h )[hash & ( h->bucket_count - 1 )];
+        e->chain           = bucket;
+        bucket             = idx;
+        link_front( h, idx );
+        ++h->count;
+        h->bytes += entry_charge;
+        return true;
+    }
+/*
+### pmm-plru_cache-erase
+*/
+    bool erase( const K& key ) noexcept
+    {
+        std::unique_lock<std::shared_mutex> lock( *_mutex );
+        const index_type                    idx = find_index( key, HashT{}( key ) );
+        if ( idx == static_cast<index_type>( 0 ) )
+            return false;
+        remove( idx );
+        return true;
+    }
+    bool evict() noexcept
+    {
+        std::unique_lock<std::shared_mutex> lock( *_mutex );
+        return evict_one();
+    }
+    template <typename FnT> void for_each( FnT&& fn ) const
+    {
+        std::shared_lock<std::shared_mutex> lock( *_mutex );
+        const header_type*                  h = header();
+        for ( index_type i = h == nullptr ? static_cast<index_type>( 0 ) : h->head; i != static_cast<index_type>( 0 ); )
+        {
+            const entry_type* e = entry( i );
+            fn( e->key, e->value );
+            i = e->next;
+        }
+    }
+    void clear() noexcept
+    {
+        std::unique_lock<std::shared_mutex> lock( *_mutex );
+        header_type*                        h = header();
+        if ( h == nullptr )
+            return;
+        for ( index_type i = h->head; i != static_cast<index_type>( 0 ); )
+        {
+            const index_type next = entry( i )->next;
+            ManagerT::template deallocate_typed<entry_type>( typename ManagerT::template pptr<entry_type>( i ) );
+            i = next;
+        }
+        h = header();
+        std::memset( static_cast<void*>( buckets( h ) ), 0,
+                     static_cast<size_t>( h->bucket_count ) * sizeof( index_type ) );
+        h->head  = static_cast<index_type>( 0 );
+        h->tail  = static_cast<index_type>( 0 );
+        h->count = 0;
+        h->bytes = 0;
+    }
+
+  private:
+    static constexpr uint64_t       kMinBuckets = 16;
+    static constexpr size_t         kLockCount  = 16;
+    static inline std::shared_mutex _locks[kLockCount];
+    std::shared_mutex*              _mutex    = &_locks[0];
+    index_type                      _header   = 0;
+    evict_callback                  _on_evict = nullptr;
+    void*                           _context  = nullptr;
+    void                            bind( const char* domain_key, size_t capacity_bytes ) noexcept
+    {
+        constexpr uint32_t kTypeHash = detail::pmap_fnv1a(
+            detail::pmap_fnv1a( 0x6c727563u + static_cast<uint32_t>( Policy ), detail::pmap_type_fp<K>(), 4 ),
+            detail::pmap_type_fp<V>(), 4 );
+        char buf[detail::kForestDomainNameCapacity]{};
+        if ( !detail::pmap_bind_domain_name<ManagerT>( buf, kTypeHash, domain_key ) )
+            return;
+        uint32_t lock_hash = kTypeHash;
+        for ( const char* c = buf; *c != '\0'; ++c )
+            lock_hash = detail::pmap_fnv1a( lock_hash, static_cast<uint8_t>( *c ), 1 );
+        _mutex       = &_locks[lock_hash % kLockCount];
+        index_type h = ManagerT::get_domain_root_offset( buf );
+        if ( h == static_cast<index_type>( 0 ) )
+        {
+            auto p = ManagerT::template allocate_typed<header_type>();
+            if ( p.is_null() )
+                return;
+            header_type* hdr = resolve<header_type>( p.offset() );
+            std::memset( static_cast<void*>( hdr ), 0, sizeof( header_type ) );
+            hdr->capacity_bytes = capacity_bytes;
+            _header             = p.offset();
+            if ( !grow_buckets( kMinBuckets ) || !ManagerT::set_domain_root( buf, p ) )
+            {
+                _header = 0;
+                return;
+            }
+            h = p.offset();
+        }
+        _header = h;
+    }
+    template <typename T> static T* resolve( index_type idx ) noexcept
+    {
+        return detail::pmap_resolve<T, ManagerT>( idx );
+    }
+    header_type*       header() const noexcept { return resolve<header_type>( _header ); }
+    static entry_type* entry( index_type idx ) noexcept { return resolve<entry_type>( idx ); }
+    static index_type* buckets( const header_type* h ) noexcept { return resolve<index_type>( h->buckets ); }
+    index_type         find_index( const K& key, uint64_t hash ) const noexcept
+    {
+        const header_type* h = header();
+        if ( h == nullptr )
+            return 0;
+        index_type i = buckets( h )[hash & ( h->bucket_count - 1 )];
+        while ( i != static_cast<index_type>( 0 ) )
+        {
+            const entry_type* e = entry( i );
+            if ( e->hash == hash && e->key == key )
+                return i;
+            i = e->chain;
+        }
+        return 0;
+    }
+    entry_type* find_entry( const K& key, uint64_t hash ) const noexcept { return entry( find_index( key, hash ) ); }
+    void        unlink( header_type* h, index_type idx ) noexcept
+    {
+        entry_type* e = entry( idx );
+        if ( e->prev != static_cast<index_type>( 0 ) )
+            entry( e->prev )->next = e->next;
+        else
+            h->head = e->next;
+        if ( e->next != static_cast<index_type>( 0 ) )
+            entry( e->next )->prev = e->prev;
+        else
+            h->tail = e->prev;
+        e->prev = e->next = static_cast<index_type>( 0 );
+    }
+    void link_front( header_type* h, index_type idx ) noexcept
+    {
+        entry_type* e = entry( idx );
+        e->prev       = static_cast<index_type>( 0 );
+        e->next       = h->head;
+        if ( h->head != static_cast<index_type>( 0 ) )
+            entry( h->head )->prev = idx;
+        else
+            h->tail = idx;
+        h->head = idx;
+    }
+    void move_to_front( index_type idx ) noexcept
+    {
+        header_type* h = header();
+        if ( h->head == idx )
+            return;
+        unlink( h, idx );
+        link_front( h, idx );
+    }
+    void remove( index_type idx ) noexcept
+    {
+        header_type* h    = header();
+        entry_type*  e    = entry( idx );
+        index_type*  link = &buckets( h )[e->hash & ( h->bucket_count - 1 )];
+        while ( *link != idx )
+            link = &entry( *link )->chain;
+        *link = e->chain;
+        unlink( h, idx );
+        --h->count;
+        h->bytes -= entry_charge;
+        ManagerT::template deallocate_typed<entry_type>( typename ManagerT::template pptr<entry_type>( idx ) );
+    }
+/*
+### pmm-plru_cache-evict_one
+*/
+    bool evict_one() noexcept
+    {
+        header_type* h = header();
+        if ( h == nullptr || h->tail == static_cast<index_type>( 0 ) )
+            return false;
+        index_type victim = h->tail;
+        if constexpr ( Policy == CachePolicy::Clock )
+        {
+            for ( uint64_t spins = 0; spins < h->count && entry( victim )->referenced != 0; ++spins )
+            {
+                entry( victim )->referenced = 0;
+                unlink( h, victim );
+                link_front( h, victim );
+                victim = h->tail;
+            }
+        }
+        if ( _on_evict != nullptr )
+            _on_evict( entry( victim )->key, entry( victim )->value, _context );
+        remove( victim );
+        return true;
+    }
+    void evict_to_fit( size_t incoming ) noexcept
+    {
+        while ( header()->count > 0 && header()->bytes + incoming > header()->capacity_bytes )
+            evict_one();
+    }
+    bool grow_buckets( uint64_t count ) noexcept
+    {
+        auto fresh = ManagerT::template allocate_typed<index_type>( static_cast<size_t>( count ) );
+        if ( fresh.is_null() )
+            return false;
+        std::memset( static_cast<void*>( resolve<index_type>( fresh.offset() ) ), 0,
+                     static_cast<size_t>( count ) * sizeof( index_type ) );
+        header_type* h    = header();
+        index_type*  slot = resolve<index_type>( fresh.offset() );
+        for ( index_type i = h->head; i != static_cast<index_type>( 0 ); i = entry( i )->next )
+        {
+            entry_type* e = entry( i );
+            index_type& b = slot[e->hash & ( count - 1 )];
+            e->chain      = b;
+            b             = i;
+        }
+        if ( h->buckets != static_cast<index_type>( 0 ) )
+            ManagerT::template deallocate_typed<index_type>(
+                typename ManagerT::template pptr<index_type>( h->buckets ) );
+        h->buckets      = fresh.offset();
+        h->bucket_count = count;
+        return true;
+    }
+};
+}
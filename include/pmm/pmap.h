@@ -1,20 +1,27 @@
 #pragma once
 #include "pmm/avl_tree_mixin.h"
 #include "pmm/forest_registry.h"
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <type_traits>
+#include <utility>
+#include <vector>
 namespace pmm
 {
 template <typename _K, typename _V, typename ManagerT> struct pmap;
+template <typename _K, typename _V, typename ManagerT, size_t Stripes, typename HashT> class pconcurrent_map;
 template <typename T> struct pmap_type_identity
 {
     static constexpr const char* tag = "";
 };
 template <typename _K, typename _V> struct pmap_node
 {
-    _K key;
-    _V value;
+    _K       key;
+    _V       value;
+    uint64_t subtree_count;
 };
 namespace detail
 {
@@ -78,6 +85,67 @@ inline bool pmap_write_name( char ( &out )[kForestDomainNameCapacity], uint32_t
     out[p] = '\0';
     return true;
 }
+inline std::atomic<uint64_t> pmap_anon_domain_seq{ 1 };
+template <typename ManagerT>
+bool pmap_bind_domain_name( char ( &out )[kForestDomainNameCapacity], uint32_t type_fp,
+                            const char* domain_key ) noexcept
+{
+    if ( !ManagerT::is_initialized() )
+        return false;
+    if ( domain_key != nullptr && domain_key[0] != '\0' )
+    {
+        if ( !pmap_write_name( out, type_fp, 'n', pmap_key_hash( domain_key ), 16 ) )
+            return false;
+    }
+    else
+    {
+        do
+        {
+            if ( !pmap_write_name( out, type_fp, 'g', pmap_anon_domain_seq.fetch_add( 1, std::memory_order_relaxed ),
+                                   8 ) )
+                return false;
+        } while ( ManagerT::has_domain( out ) );
+    }
+    return ManagerT::has_domain( out ) || ManagerT::register_domain( out );
+}
+template <typename T, typename ManagerT> T* pmap_resolve( typename ManagerT::index_type idx ) noexcept
+{
+    return idx == static_cast<typename ManagerT::index_type>( 0 )
+               ? nullptr
+               : ManagerT::template resolve_unchecked<T>( typename ManagerT::template pptr<T>( idx ) );
+}
+template <typename ManagerT> struct pmap_domain_binding
+{
+    using index_type = typename ManagerT::index_type;
+    const char* domain_name() const noexcept
+    {
+        const auto* d = ManagerT::find_domain_by_binding_unlocked( _binding_id );
+        return d != nullptr ? d->name : "";
+    }
+    bool       is_bound() const noexcept { return _binding_id != 0; }
+    index_type root_index() const noexcept
+    {
+        const index_type* root = root_slot();
+        return root != nullptr ? *root : static_cast<index_type>( 0 );
+    }
+
+  protected:
+    index_type                                   _binding_id = 0;
+    mutable typename ManagerT::domain_root_cache _root_cache{};
+    bool                                         bind_domain( uint32_t type_fp, const char* domain_key ) noexcept
+    {
+        char buf[kForestDomainNameCapacity]{};
+        if ( !pmap_bind_domain_name<ManagerT>( buf, type_fp, domain_key ) )
+            return false;
+        _binding_id = ManagerT::find_domain_by_name( buf );
+        _root_cache = {};
+        return _binding_id != 0;
+    }
+    index_type* root_slot() const noexcept
+    {
+        return ManagerT::cached_domain_root_ptr_unlocked( _binding_id, _root_cache );
+    }
+};
 }
 /*
 ## pmm-pmap
@@ -96,8 +164,13 @@ template <typename _K, typename _V, typename ManagerT> struct pmap
         using index_type = typename ManagerT::index_type;
         using node_type  = pmap_node<_K, _V>;
         using node_pptr  = typename ManagerT::template pptr<node_type>;
-        index_type binding_id;
-        constexpr explicit forest_domain_descriptor( index_type id = 0 ) noexcept : binding_id( id ) {}
+        using root_cache = typename ManagerT::domain_root_cache;
+        index_type  binding_id;
+        root_cache* cache;
+        constexpr explicit forest_domain_descriptor( index_type id = 0, root_cache* rc = nullptr ) noexcept
+            : binding_id( id ), cache( rc )
+        {
+        }
         const char* name() const noexcept
         {
             const auto* d = ManagerT::find_domain_by_binding_unlocked( binding_id );
@@ -105,14 +178,19 @@ template <typename _K, typename _V, typename ManagerT> struct pmap
         }
         index_type root_index() const noexcept
         {
-            return ManagerT::forest_domain_root_index_unlocked(
-                ManagerT::find_domain_by_binding_unlocked( binding_id ) );
+            if ( cache == nullptr )
+                return ManagerT::forest_domain_root_index_unlocked(
+                    ManagerT::find_domain_by_binding_unlocked( binding_id ) );
+            const index_type* root = ManagerT::cached_domain_root_ptr_unlocked( binding_id, *cache );
+            return root != nullptr ? *root : static_cast<index_type>( 0 );
         }
         index_type* root_index_ptr() noexcept
         {
-            return binding_id == 0 ? nullptr
-                                   : ManagerT::forest_domain_root_index_ptr_unlocked(
-                                         ManagerT::find_domain_by_binding_unlocked( binding_id ) );
+            if ( binding_id == 0 )
+                return nullptr;
+            return cache != nullptr ? ManagerT::cached_domain_root_ptr_unlocked( binding_id, *cache )
+                                    : ManagerT::forest_domain_root_index_ptr_unlocked(
+                                          ManagerT::find_domain_by_binding_unlocked( binding_id ) );
         }
         static node_type* resolve_node( node_pptr p ) noexcept { return ManagerT::template resolve<node_type>( p ); }
         static int        compare_key( const _K& key, node_pptr cur ) noexcept
@@ -133,32 +211,109 @@ template <typename _K, typename _V, typename ManagerT> struct pmap
     static constexpr index_type no_block = ManagerT::address_traits::no_block;
 
   private:
-    index_type _binding_id;
-    bool       bind( const char* domain_key ) noexcept
+    index_type                                   _binding_id;
+    mutable typename ManagerT::domain_root_cache _root_cache{};
+    bool                                         bind( const char* domain_key ) noexcept
     {
-        if ( !ManagerT::is_initialized() )
-            return false;
         char buf[detail::kForestDomainNameCapacity]{};
-        if ( domain_key != nullptr && domain_key[0] != '\0' )
+        if ( !detail::pmap_bind_domain_name<ManagerT>( buf, domain_type_hash, domain_key ) )
+            return false;
+        _binding_id = ManagerT::find_domain_by_name( buf );
+        _root_cache = {};
+        return _binding_id != 0;
+    }
+    forest_domain_descriptor descriptor() const noexcept
+    {
+        return forest_domain_descriptor( _binding_id, &_root_cache );
+    }
+    static uint64_t          subtree_count( node_pptr p ) noexcept
+    {
+        return p.is_null() ? 0 : ManagerT::template resolve_unchecked<node_type>( p )->subtree_count;
+    }
+    template <typename It>
+    static index_type link_balanced( It first, const node_pptr* nodes, size_t lo, size_t hi, node_pptr parent ) noexcept
+    {
+        if ( lo >= hi )
+            return detail::pptr_no_block<node_pptr>();
+        const size_t mid = lo + ( hi - lo ) / 2;
+        node_pptr    p   = nodes[mid];
+        node_type*   obj = ManagerT::template resolve_unchecked<node_type>( p );
+        obj->key         = ( *std::next( first, static_cast<std::ptrdiff_t>( mid ) ) ).first;
+        obj->value       = ( *std::next( first, static_cast<std::ptrdiff_t>( mid ) ) ).second;
+        auto& tn         = p.tree_node_unchecked();
+        tn.parent_offset = parent.is_null() ? detail::pptr_no_block<node_pptr>() : parent.offset();
+        tn.left_offset   = link_balanced( first, nodes, lo, mid, p );
+        tn.right_offset  = link_balanced( first, nodes, mid + 1, hi, p );
+        update_subtree_count{}( p );
+        return p.offset();
+    }
+    template <typename It> bool bulk_link( It first, size_t count ) noexcept
+    {
+        std::vector<node_pptr> nodes;
+        try
         {
-            if ( !detail::pmap_write_name( buf, domain_type_hash, 'n', detail::pmap_key_hash( domain_key ), 16 ) )
-                return false;
+            nodes.resize( count );
         }
-        else
+        catch ( ... )
         {
-            static uint64_t seq = 1;
-            do
-            {
-                if ( !detail::pmap_write_name( buf, domain_type_hash, 'g', seq++, 8 ) )
-                    return false;
-            } while ( ManagerT::has_domain( buf ) );
+            return false;
         }
-        if ( !ManagerT::has_domain( buf ) && !ManagerT::register_domain( buf ) )
+        if ( !ManagerT::template allocate_typed_batch<node_type>( count, nodes.data() ) )
             return false;
-        _binding_id = ManagerT::find_domain_by_name( buf );
-        return _binding_id != 0;
+        index_type* root = forest_domain_ops().root_index_ptr();
+        if ( root == nullptr )
+        {
+            for ( node_pptr p : nodes )
+                ManagerT::template deallocate_typed<node_type>( p );
+            return false;
+        }
+        *root = link_balanced( first, nodes.data(), 0, count, node_pptr() );
+        return true;
     }
-    forest_domain_descriptor descriptor() const noexcept { return forest_domain_descriptor( _binding_id ); }
+    template <typename It> bool insert_each( It first, It last ) noexcept
+    {
+        std::vector<node_pptr>                added;
+        std::vector<std::pair<node_pptr, _V>> replaced;
+        bool                                  ok = true;
+        for ( ; ok && first != last; ++first )
+        {
+            node_pptr existing = find( ( *first ).first );
+            try
+            {
+                if ( existing.is_null() )
+                    added.reserve( added.size() + 1 );
+                else
+                    replaced.emplace_back( existing, ManagerT::template resolve_unchecked<node_type>( existing )->value );
+            }
+            catch ( ... )
+            {
+                ok = false;
+                break;
+            }
+            node_pptr p = insert( ( *first ).first, ( *first ).second );
+            ok          = !p.is_null();
+            if ( ok && existing.is_null() )
+                added.push_back( p );
+        }
+        if ( ok )
+            return true;
+        for ( auto it = replaced.rbegin(); it != replaced.rend(); ++it )
+            ManagerT::template resolve_unchecked<node_type>( it->first )->value = it->second;
+        for ( auto it = added.rbegin(); it != added.rend(); ++it )
+            erase( ManagerT::template resolve_unchecked<node_type>( *it )->key );
+        return false;
+    }
+    struct update_subtree_count
+    {
+        void operator()( node_pptr p ) const noexcept
+        {
+            if ( p.is_null() )
+                return;
+            detail::avl_update_height( p );
+            ManagerT::template resolve_unchecked<node_type>( p )->subtree_count =
+                1 + subtree_count( detail::pptr_get_left( p ) ) + subtree_count( detail::pptr_get_right( p ) );
+        }
+    };
 
   public:
     pmap() noexcept : _binding_id( 0 ) {}
@@ -167,7 +322,7 @@ template <typename _K, typename _V, typename ManagerT> struct pmap
     index_type           root_index() const noexcept { return descriptor().root_index(); }
     forest_domain_policy forest_domain_ops() noexcept
     {
-        if ( _binding_id == 0 || ManagerT::find_domain_by_binding_unlocked( _binding_id ) == nullptr )
+        if ( _binding_id == 0 || ManagerT::cached_domain_root_ptr_unlocked( _binding_id, _root_cache ) == nullptr )
             bind( nullptr );
         return forest_domain_policy( descriptor() );
     }
@@ -182,7 +337,59 @@ template <typename _K, typename _V, typename ManagerT> struct pmap
     size_t size() const noexcept
     {
         const index_type root = root_index();
-        return root == static_cast<index_type>( 0 ) ? 0 : detail::avl_subtree_count( node_pptr( root ) );
+        return root == static_cast<index_type>( 0 ) ? 0 : static_cast<size_t>( subtree_count( node_pptr( root ) ) );
+    }
+/*
+### pmm-pmap-nth
+*/
+    node_pptr nth( size_t i ) const noexcept
+    {
+        const index_type root = root_index();
+        node_pptr        cur  = root == static_cast<index_type>( 0 ) ? node_pptr() : node_pptr( root );
+        while ( !cur.is_null() )
+        {
+            node_pptr left       = detail::pptr_get_left( cur );
+            uint64_t  left_count = subtree_count( left );
+            if ( i == left_count )
+                return cur;
+            if ( i < left_count )
+            {
+                cur = left;
+            }
+            else
+            {
+                i -= static_cast<size_t>( left_count ) + 1;
+                cur = detail::pptr_get_right( cur );
+            }
+        }
+        return node_pptr();
+    }
+/*
+### pmm-pmap-rank
+*/
+    size_t rank( const _K& key ) const noexcept
+    {
+        const index_type root  = root_index();
+        node_pptr        cur   = root == static_cast<index_type>( 0 ) ? node_pptr() : node_pptr( root );
+        size_t           below = 0;
+        while ( !cur.is_null() )
+        {
+            const node_type* obj = ManagerT::template resolve_unchecked<node_type>( cur );
+            if ( obj->key < key )
+            {
+                below += static_cast<size_t>( subtree_count( detail::pptr_get_left( cur ) ) ) + 1;
+                cur = detail::pptr_get_right( cur );
+            }
+            else
+            {
+                cur = detail::pptr_get_left( cur );
+            }
+        }
+        return below;
+    }
+    size_t count_range( const _K& lo, const _K& hi ) const noexcept
+    {
+        return lo < hi ? rank( hi ) - rank( lo ) : 0;
     }
 /*
 ### pmm-pmap-insert
@@ -199,14 +406,12 @@ template <typename _K, typename _V, typename ManagerT> struct pmap
                 obj->value = val;
             return existing;
         }
-        node_pptr  new_node = ManagerT::template allocate_typed<node_type>();
-        node_type* obj      = new_node.is_null() ? nullptr : ManagerT::template resolve<node_type>( new_node );
-        if ( obj == nullptr )
+        node_pptr new_node = ManagerT::template allocate_typed<node_type>();
+        if ( new_node.is_null() || link_node( new_node, key, val ).is_null() )
+        {
+            ManagerT::template deallocate_typed<node_type>( new_node );
             return node_pptr();
-        obj->key   = key;
-        obj->value = val;
-        detail::avl_init_node( new_node );
-        ops.insert( new_node );
+        }
         return new_node;
     }
     node_pptr find( const _K& key ) const noexcept { return forest_domain_view_ops().find( key ); }
@@ -216,28 +421,54 @@ template <typename _K, typename _V, typename ManagerT> struct pmap
 */
     bool erase( const _K& key ) noexcept
     {
-        auto        ops  = forest_domain_policy( descriptor() );
-        index_type* root = ops.root_index_ptr();
-        node_pptr   t    = root == nullptr ? node_pptr() : ops.find( key );
-        if ( t.is_null() )
-            return false;
-        detail::avl_remove( t, *root );
+        node_pptr t = unlink( key );
         ManagerT::template deallocate_typed<node_type>( t );
-        return true;
+        return !t.is_null();
     }
 /*
 ### pmm-pmap-clear
 */
-    void clear() noexcept
+    void clear() noexcept { free_subtree( detach_all() ); }
+/*
+### pmm-pmap-bulk_load
+*/
+    template <typename InputIt> bool bulk_load( InputIt first, InputIt last ) noexcept
     {
-        auto        ops  = forest_domain_policy( descriptor() );
-        index_type* root = ops.root_index_ptr();
-        if ( root == nullptr )
-            return;
-        if ( *root != static_cast<index_type>( 0 ) )
-            detail::avl_clear_subtree( node_pptr( *root ),
-                                       []( node_pptr p ) { ManagerT::template deallocate_typed<node_type>( p ); } );
-        *root = static_cast<index_type>( 0 );
+        if ( !empty() )
+            return insert_each( first, last );
+        auto key_less = []( const auto& a, const auto& b ) { return a.first < b.first; };
+        if constexpr ( std::is_base_of_v<std::random_access_iterator_tag,
+                                         typename std::iterator_traits<InputIt>::iterator_category> )
+        {
+            auto not_increasing = [&]( const auto& a, const auto& b ) { return !key_less( a, b ); };
+            if ( std::adjacent_find( first, last, not_increasing ) == last )
+                return first == last || bulk_link( first, static_cast<size_t>( last - first ) );
+        }
+        std::vector<std::pair<_K, _V>> sorted;
+        try
+        {
+            for ( ; first != last; ++first )
+                sorted.emplace_back( ( *first ).first, ( *first ).second );
+            std::stable_sort( sorted.begin(), sorted.end(), key_less );
+            size_t kept = 0;
+            for ( size_t i = 0; i < sorted.size(); ++i )
+            {
+                if ( kept > 0 && !key_less( sorted[kept - 1], sorted[i] ) )
+                    sorted[kept - 1] = sorted[i];
+                else
+                    sorted[kept++] = sorted[i];
+            }
+            sorted.resize( kept );
+        }
+        catch ( ... )
+        {
+            return false;
+        }
+        return sorted.empty() || bulk_link( sorted.begin(), sorted.size() );
+    }
+    template <typename RangeT> bool bulk_load( const RangeT& range ) noexcept
+    {
+        return bulk_load( std::begin( range ), std::end( range ) );
     }
     void reset() noexcept { forest_domain_policy( descriptor() ).reset_root(); }
     using iterator = detail::AvlInorderIterator<node_pptr>;
@@ -252,6 +483,139 @@ template <typename _K, typename _V, typename ManagerT> struct pmap
         return iterator( detail::avl_min_node( node_pptr( root ) ).offset() );
     }
     iterator end() const noexcept { return iterator( static_cast<index_type>( 0 ) ); }
+    using reverse_iterator = detail::AvlReverseInorderIterator<node_pptr>;
+    reverse_iterator rbegin() const noexcept
+    {
+        const index_type root = root_index();
+        if ( root == static_cast<index_type>( 0 ) )
+            return reverse_iterator();
+        return reverse_iterator( detail::avl_max_node( node_pptr( root ) ).offset() );
+    }
+    reverse_iterator rend() const noexcept { return reverse_iterator( static_cast<index_type>( 0 ) ); }
+/*
+### pmm-pmap-lower_bound
+*/
+    iterator lower_bound( const _K& key ) const noexcept { return iterator( bound_index( key, false ) ); }
+    iterator upper_bound( const _K& key ) const noexcept { return iterator( bound_index( key, true ) ); }
+    std::pair<iterator, iterator> equal_range( const _K& key ) const noexcept
+    {
+        return { lower_bound( key ), upper_bound( key ) };
+    }
+    using cursor = detail::AvlStackCursor<node_pptr>;
+/*
+### pmm-pmap-seek
+*/
+    cursor seek( const _K& key ) const noexcept
+    {
+        cursor           c;
+        const index_type root = root_index();
+        node_pptr        cur  = root == static_cast<index_type>( 0 ) ? node_pptr() : node_pptr( root );
+        while ( !cur.is_null() )
+        {
+            if ( ManagerT::template resolve_unchecked<node_type>( cur )->key < key )
+            {
+                cur = detail::pptr_get_right( cur );
+            }
+            else
+            {
+                if ( !c.push( cur ) )
+                    break;
+                cur = detail::pptr_get_left( cur );
+            }
+        }
+        c.prefetch_next();
+        return c;
+    }
+    cursor first() const noexcept
+    {
+        cursor           c;
+        const index_type root = root_index();
+        if ( root != static_cast<index_type>( 0 ) )
+            c.push_left_spine( node_pptr( root ) );
+        return c;
+    }
+/*
+### pmm-pmap-for_each_range
+*/
+    template <typename Fn> size_t for_each_range( const _K& lo, const _K& hi, Fn&& fn ) const noexcept
+    {
+        size_t visited = 0;
+        for ( cursor c = seek( lo ); c.valid(); ++c )
+        {
+            const node_type* obj = ManagerT::template resolve_unchecked<node_type>( *c );
+            if ( !( obj->key < hi ) )
+                break;
+            fn( obj->key, obj->value );
+            ++visited;
+        }
+        return visited;
+    }
+
+  private:
+    template <typename, typename, typename, size_t, typename> friend class pconcurrent_map;
+    node_pptr link_node( node_pptr new_node, const _K& key, const _V& val ) noexcept
+    {
+        auto        ops  = forest_domain_policy( descriptor() );
+        index_type* root = ops.root_index_ptr();
+        node_type*  obj  = new_node.is_null() ? nullptr : ManagerT::template resolve<node_type>( new_node );
+        if ( root == nullptr || obj == nullptr )
+            return node_pptr();
+        obj->key           = key;
+        obj->value         = val;
+        obj->subtree_count = 1;
+        detail::avl_init_node( new_node );
+        detail::avl_insert(
+            new_node, *root,
+            [obj]( node_pptr cur ) -> bool
+            { return obj->key < ManagerT::template resolve_unchecked<node_type>( cur )->key; },
+            []( node_pptr p ) -> node_type* { return ManagerT::template resolve<node_type>( p ); },
+            update_subtree_count{} );
+        return new_node;
+    }
+    node_pptr unlink( const _K& key ) noexcept
+    {
+        auto        ops  = forest_domain_policy( descriptor() );
+        index_type* root = ops.root_index_ptr();
+        node_pptr   t    = root == nullptr ? node_pptr() : ops.find( key );
+        if ( !t.is_null() )
+            detail::avl_remove( t, *root, update_subtree_count{} );
+        return t;
+    }
+    node_pptr detach_all() noexcept
+    {
+        auto        ops  = forest_domain_policy( descriptor() );
+        index_type* root = ops.root_index_ptr();
+        if ( root == nullptr || *root == static_cast<index_type>( 0 ) )
+            return node_pptr();
+        node_pptr old( *root );
+        *root = static_cast<index_type>( 0 );
+        return old;
+    }
+    static void free_subtree( node_pptr root ) noexcept
+    {
+        detail::avl_clear_subtree( root, []( node_pptr p ) { ManagerT::template deallocate_typed<node_type>( p ); } );
+    }
+    index_type bound_index( const _K& key, bool strict ) const noexcept
+    {
+        const index_type root  = root_index();
+        node_pptr        cur   = root == static_cast<index_type>( 0 ) ? node_pptr() : node_pptr( root );
+        index_type       found = static_cast<index_type>( 0 );
+        while ( !cur.is_null() )
+        {
+            const node_type* obj   = ManagerT::template resolve_unchecked<node_type>( cur );
+            const bool       after = strict ? key < obj->key : !( obj->key < key );
+            if ( after )
+            {
+                found = cur.offset();
+                cur   = detail::pptr_get_left( cur );
+            }
+            else
+            {
+                cur = detail::pptr_get_right( cur );
+            }
+        }
+        return found;
+    }
 };
 template <typename _K, typename _V, typename ManagerT> struct node_type_for<pmap<_K, _V, ManagerT>>
 {
@@ -0,0 +1,647 @@
+#pragma once
+#include "pmm/forest_registry.h"
+#include "pmm/pmap.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+namespace pmm
+{
+template <typename _K, typename _V, typename IndexT> struct pmvcc_node
+{
+    _K       key;
+    _V       value;
+    IndexT   left;
+    IndexT   right;
+    uint32_t height;
+};
+template <typename _K, typename _V, typename ManagerT>
+/*
+## pmm-pmvcc_map
+req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
+*/
+class pmvcc_map
+{
+  public:
+    using manager_type = ManagerT;
+    using index_type   = typename ManagerT::index_type;
+    using node_type    = pmvcc_node<_K, _V, index_type>;
+    using node_pptr    = typename ManagerT::template pptr<node_type>;
+    class snapshot
+    {
+      public:
+        snapshot() noexcept = default;
+        snapshot( const snapshot& )            = delete;
+        snapshot& operator=( const snapshot& ) = delete;
+        snapshot( snapshot&& other ) noexcept : _map( other._map ), _root( other._root ), _version( other._version )
+        {
+            other._map = nullptr;
+        }
+        snapshot& operator=( snapshot&& other ) noexcept
+        {
+            if ( this != &other )
+            {
+                release();
+                _map       = other._map;
+                _root      = other._root;
+                _version   = other._version;
+                other._map = nullptr;
+            }
+            return *this;
+        }
+        ~snapshot() { release(); }
+        void release() noexcept
+        {
+            if ( _map != nullptr )
+                _map->unpin( _version );
+            _map = nullptr;
+        }
+        bool find( const _K& key, _V& out ) const noexcept
+        {
+            auto             lock = ManagerT::read_lock();
+            const node_type* n    = find_unlocked( key );
+            if ( n != nullptr )
+                out = n->value;
+            return n != nullptr;
+        }
+        bool contains( const _K& key ) const noexcept
+        {
+            auto lock = ManagerT::read_lock();
+            return find_unlocked( key ) != nullptr;
+        }
+        bool empty() const noexcept { return _root == static_cast<index_type>( 0 ); }
+        template <typename FnT> void for_each( FnT&& fn ) const
+        {
+            auto                    lock = ManagerT::read_lock();
+            std::vector<index_type> stack;
+            index_type              cur = _root;
+            while ( cur != static_cast<index_type>( 0 ) || !stack.empty() )
+            {
+                for ( ; cur != static_cast<index_type>( 0 ); cur = resolve( cur )->left )
+                    stack.push_back( cur );
+                const node_type* n = resolve( stack.back() );
+                stack.pop_back();
+                fn( n->key, n->value );
+                cur = n->right;
+            }
+        }
+        size_t size() const
+        {
+            size_t count = 0;
+            for_each( [&count]( const _K&, const _V& ) { ++count; } );
+            return count;
+        }
+        index_type root_index() const noexcept { return _root; }
+        uint64_t   version() const noexcept { return _version; }
+
+      private:
+        friend class pmvcc_map;
+        const node_type* find_unlocked( const _K& key ) const noexcept
+        {
+            index_type cur = _root;
+            while ( cur != static_cast<index_type>( 0 ) )
+            {
+                const node_type* n = resolve( cur );
+                if ( n == nullptr )
+                    return nullptr;
+                if ( key == n->key )
+                    return n;
+                cur = ( key < n->key ) ? n->left : n->right;
+            }
+            return nullptr;
+        }
+        snapshot( pmvcc_map* map, index_type root, uint64_t version ) noexcept
+            : _map( map ), _root( root ), _version( version )
+        {
+        }
+        pmvcc_map* _map     = nullptr;
+        index_type _root    = 0;
+        uint64_t   _version = 0;
+    };
+    pmvcc_map() noexcept { bind( nullptr ); }
+    explicit pmvcc_map( const char* domain_key ) noexcept { bind( domain_key ); }
+    pmvcc_map( const pmvcc_map& )            = delete;
+    pmvcc_map& operator=( const pmvcc_map& ) = delete;
+    ~pmvcc_map()
+    {
+        release_retired();
+        unbind();
+    }
+    const char* domain_name() const noexcept { return _name; }
+    bool        is_bound() const noexcept { return _name[0] != '\0'; }
+    index_type  root_index() const noexcept { return ManagerT::get_domain_root_offset( _name ); }
+/*
+### pmm-pmvcc_map-pin
+*/
+    snapshot pin() noexcept
+    {
+        std::lock_guard<std::mutex> lock( _state_mutex );
+        try
+        {
+            _pins.push_back( _version );
+        }
+        catch ( ... )
+        {
+            return snapshot();
+        }
+        return snapshot( this, root_index(), _version );
+    }
+/*
+### pmm-pmvcc_map-insert
+*/
+    bool insert( const _K& key, const _V& val ) noexcept
+    {
+        std::lock_guard<std::mutex> lock( _writer_mutex );
+        if ( !is_bound() )
+            return false;
+        write_scope scope;
+        index_type  root = insert_rec( scope, root_index(), key, val );
+        if ( root == static_cast<index_type>( 0 ) )
+        {
+            discard( scope );
+            return false;
+        }
+        return publish( scope, root );
+    }
+/*
+### pmm-pmvcc_map-erase
+*/
+    bool erase( const _K& key ) noexcept
+    {
+        std::lock_guard<std::mutex> lock( _writer_mutex );
+        if ( !is_bound() )
+            return false;
+        write_scope scope;
+        bool        found = false;
+        index_type  root  = erase_rec( scope, root_index(), key, found );
+        if ( !found || scope.failed )
+        {
+            discard( scope );
+            return false;
+        }
+        return publish( scope, root );
+    }
+    bool clear() noexcept
+    {
+        std::lock_guard<std::mutex> lock( _writer_mutex );
+        if ( !is_bound() )
+            return false;
+        write_scope scope;
+        scope.failed = !collect_subtree( root_index(), scope.retired );
+        return publish( scope, static_cast<index_type>( 0 ) );
+    }
+/*
+### pmm-pmvcc_map-collect
+*/
+    size_t collect() noexcept
+    {
+        std::lock_guard<std::mutex> lock( _state_mutex );
+        return reclaim_unlocked();
+    }
+    uint64_t version() const noexcept
+    {
+        std::lock_guard<std::mutex> lock( _state_mutex );
+        return _version;
+    }
+    size_t pinned_count() const noexcept
+    {
+        std::lock_guard<std::mutex> lock( _state_mutex );
+        return _pins.size();
+    }
+    size_t retired_count() const noexcept
+    {
+        std::lock_guard<std::mutex> lock( _state_mutex );
+        size_t                      count = 0;
+        for ( const retired_batch& b : _retired )
+            count += b.count;
+        return count;
+    }
+
+  private:
+    struct retired_batch
+    {
+        index_type block;
+        size_t     count;
+        uint64_t   retired_at;
+    };
+    struct write_scope
+    {
+        std::vector<index_type> fresh;
+        std::vector<index_type> retired;
+        bool                    failed = false;
+        bool                    keep( std::vector<index_type>& list, index_type idx ) noexcept
+        {
+            try
+            {
+                list.push_back( idx );
+            }
+            catch ( ... )
+            {
+                failed = true;
+            }
+            return !failed;
+        }
+    };
+    static inline std::mutex  _bound_mutex;
+    static inline pmvcc_map*  _bound_head = nullptr;
+    pmvcc_map*                _bound_next = nullptr;
+    char                       _name[detail::kForestDomainNameCapacity]{};
+    char                       _retired_name[detail::kForestDomainNameCapacity]{};
+    mutable std::mutex         _state_mutex;
+    std::mutex                 _writer_mutex;
+    uint64_t                   _version = 1;
+    std::vector<uint64_t>      _pins;
+    std::vector<retired_batch> _retired;
+    using batch_pptr                          = typename ManagerT::template pptr<index_type>;
+    static constexpr size_t kBatchHeaderWords = 2;
+    void                    bind( const char* domain_key ) noexcept
+    {
+        constexpr uint32_t kTypeHash = detail::pmap_fnv1a(
+            detail::pmap_fnv1a( 0x6d766363u, detail::pmap_type_fp<_K>(), 4 ), detail::pmap_type_fp<_V>(), 4 );
+        char buf[detail::kForestDomainNameCapacity]{};
+        if ( !detail::pmap_bind_domain_name<ManagerT>( buf, kTypeHash, domain_key ) )
+            return;
+        std::lock_guard<std::mutex> lock( _bound_mutex );
+        for ( const pmvcc_map* m = _bound_head; m != nullptr; m = m->_bound_next )
+        {
+            if ( std::strncmp( m->_name, buf, detail::kForestDomainNameCapacity ) == 0 )
+                return;
+        }
+        char   retired[detail::kForestDomainNameCapacity]{};
+        size_t len = std::strlen( buf );
+        if ( len + 3 > detail::kForestDomainNameCapacity )
+            return;
+        std::memcpy( retired, buf, len );
+        std::memcpy( retired + len, "/r", 3 );
+        if ( !ManagerT::has_domain( retired ) && !ManagerT::register_domain( retired ) )
+            return;
+        std::copy( buf, buf + detail::kForestDomainNameCapacity, _name );
+        std::copy( retired, retired + detail::kForestDomainNameCapacity, _retired_name );
+        _bound_next = _bound_head;
+        _bound_head = this;
+        reclaim_orphans();
+    }
+    void reclaim_orphans() noexcept
+    {
+        index_type head = ManagerT::get_domain_root_offset( _retired_name );
+        if ( head == static_cast<index_type>( 0 ) )
+            return;
+        std::vector<index_type> live;
+        std::vector<index_type> orphans;
+        std::vector<index_type> batches;
+        const size_t            limit = ManagerT::block_count();
+        if ( !collect_subtree( root_index(), live ) )
+            return;
+        try
+        {
+            while ( head != static_cast<index_type>( 0 ) && batches.size() < limit )
+            {
+                const index_type* words = ManagerT::template resolve_checked<index_type>( batch_pptr( head ) );
+                if ( words == nullptr )
+                    break;
+                batches.push_back( head );
+                for ( size_t i = 0; i < static_cast<size_t>( words[1] ) && i < limit; ++i )
+                    orphans.push_back( words[kBatchHeaderWords + i] );
+                head = words[0];
+            }
+        }
+        catch ( ... )
+        {
+            return;
+        }
+        std::sort( live.begin(), live.end() );
+        std::sort( orphans.begin(), orphans.end() );
+        orphans.erase( std::unique( orphans.begin(), orphans.end() ), orphans.end() );
+        (void)ManagerT::set_domain_root( _retired_name, batch_pptr() );
+        for ( index_type node : orphans )
+            if ( !std::binary_search( live.begin(), live.end(), node ) )
+                ManagerT::template deallocate_typed<node_type>( node_pptr( node ) );
+        for ( index_type block : batches )
+            ManagerT::template deallocate_typed<index_type>( batch_pptr( block ) );
+    }
+    void unbind() noexcept
+    {
+        std::lock_guard<std::mutex> lock( _bound_mutex );
+        for ( pmvcc_map** link = &_bound_head; *link != nullptr; link = &( *link )->_bound_next )
+        {
+            if ( *link == this )
+            {
+                *link = _bound_next;
+                break;
+            }
+        }
+    }
+    void release_retired() noexcept
+    {
+        std::lock_guard<std::mutex> lock( _state_mutex );
+        if ( ManagerT::is_initialized() && is_bound() )
+        {
+            (void)ManagerT::set_domain_root( _retired_name, batch_pptr() );
+            for ( const retired_batch& b : _retired )
+                free_batch( b );
+        }
+        _retired.clear();
+    }
+    static void free_batch( const retired_batch& b ) noexcept
+    {
+        const index_type* batch = ManagerT::template resolve_checked<index_type>( batch_pptr( b.block ) );
+        for ( size_t i = 0; batch != nullptr && i < b.count; ++i )
+            ManagerT::template deallocate_typed<node_type>( node_pptr( batch[kBatchHeaderWords + i] ) );
+        ManagerT::template deallocate_typed<index_type>( batch_pptr( b.block ) );
+    }
+    static node_type* resolve( index_type idx ) noexcept
+    {
+        return ManagerT::template resolve_unchecked<node_type>( node_pptr( idx ) );
+    }
+    static uint32_t height_of( index_type idx ) noexcept
+    {
+        return idx == static_cast<index_type>( 0 ) ? 0 : resolve( idx )->height;
+    }
+    static void update_height( node_type* n ) noexcept
+    {
+        n->height = 1 + std::max( height_of( n->left ), height_of( n->right ) );
+    }
+    index_type make_node( write_scope& scope, const _K& key, const _V& val, index_type left, index_type right ) noexcept
+    {
+        node_pptr  p = ManagerT::template allocate_typed<node_type>();
+        node_type* n = p.is_null() ? nullptr : resolve( p.offset() );
+        if ( n == nullptr )
+        {
+            scope.failed = true;
+            return 0;
+        }
+        n->key   = key;
+        n->value = val;
+        n->left  = left;
+        n->right = right;
+        update_height( n );
+        if ( !scope.keep( scope.fresh, p.offset() ) )
+        {
+            ManagerT::template deallocate_typed<node_type>( p );
+            return 0;
+        }
+        return p.offset();
+    }
+    index_type own( write_scope& scope, index_type idx ) noexcept
+    {
+        if ( std::find( scope.fresh.begin(), scope.fresh.end(), idx ) != scope.fresh.end() )
+            return idx;
+        node_type  src  = *resolve( idx );
+        index_type copy = make_node( scope, src.key, src.value, src.left, src.right );
+        if ( copy != static_cast<index_type>( 0 ) )
+            (void)scope.keep( scope.retired, idx );
+        return copy;
+    }
+    index_type rotate_right( write_scope& scope, index_type x ) noexcept
+    {
+        index_type y = own( scope, resolve( x )->left );
+        if ( y == static_cast<index_type>( 0 ) )
+            return x;
+        node_type* xn = resolve( x );
+        node_type* yn = resolve( y );
+        xn->left      = yn->right;
+        yn->right     = x;
+        update_height( xn );
+        update_height( yn );
+        return y;
+    }
+    index_type rotate_left( write_scope& scope, index_type x ) noexcept
+    {
+        index_type y = own( scope, resolve( x )->right );
+        if ( y == static_cast<index_type>( 0 ) )
+            return x;
+        node_type* xn = resolve( x );
+        node_type* yn = resolve( y );
+        xn->right     = yn->left;
+        yn->left      = x;
+        update_height( xn );
+        update_height( yn );
+        return y;
+    }
+    index_type rebalance( write_scope& scope, index_type x ) noexcept
+    {
+        node_type* xn = resolve( x );
+        update_height( xn );
+        int64_t bf = static_cast<int64_t>( height_of( xn->left ) ) - static_cast<int64_t>( height_of( xn->right ) );
+        if ( bf > 1 )
+        {
+            const node_type* l = resolve( xn->left );
+            if ( height_of( l->left ) < height_of( l->right ) )
+            {
+                index_type nl = own( scope, xn->left );
+                if ( nl == static_cast<index_type>( 0 ) )
+                    return x;
+                index_type sub     = rotate_left( scope, nl );
+                resolve( x )->left = sub;
+            }
+            return rotate_right( scope, x );
+        }
+        if ( bf < -1 )
+        {
+            const node_type* r = resolve( xn->right );
+            if ( height_of( r->right ) < height_of( r->left ) )
+            {
+                index_type nr = own( scope, xn->right );
+                if ( nr == static_cast<index_type>( 0 ) )
+                    return x;
+                index_type sub      = rotate_right( scope, nr );
+                resolve( x )->right = sub;
+            }
+            return rotate_left( scope, x );
+        }
+        return x;
+    }
+    index_type insert_rec( write_scope& scope, index_type cur, const _K& key, const _V& val ) noexcept
+    {
+        if ( cur == static_cast<index_type>( 0 ) )
+            return make_node( scope, key, val, 0, 0 );
+        index_type copy = own( scope, cur );
+        if ( copy == static_cast<index_type>( 0 ) )
+            return 0;
+        node_type* n = resolve( copy );
+        if ( key == n->key )
+        {
+            n->value = val;
+            return copy;
+        }
+        index_type child = insert_rec( scope, ( key < n->key ) ? n->left : n->right, key, val );
+        if ( child == static_cast<index_type>( 0 ) )
+            return 0;
+        n = resolve( copy );
+        ( key < n->key ? n->left : n->right ) = child;
+        return rebalance( scope, copy );
+    }
+    index_type erase_min( write_scope& scope, index_type cur, index_type& min_node ) noexcept
+    {
+        const node_type* n = resolve( cur );
+        if ( n->left == static_cast<index_type>( 0 ) )
+        {
+            min_node = cur;
+            (void)scope.keep( scope.retired, cur );
+            return n->right;
+        }
+        index_type copy = own( scope, cur );
+        if ( copy == static_cast<index_type>( 0 ) )
+            return cur;
+        resolve( copy )->left = erase_min( scope, resolve( copy )->left, min_node );
+        return rebalance( scope, copy );
+    }
+    index_type erase_rec( write_scope& scope, index_type cur, const _K& key, bool& found ) noexcept
+    {
+        if ( cur == static_cast<index_type>( 0 ) || scope.failed )
+            return cur;
+        const node_type* n = resolve( cur );
+        if ( key == n->key )
+        {
+            found = true;
+            if ( n->left == static_cast<index_type>( 0 ) || n->right == static_cast<index_type>( 0 ) )
+            {
+                (void)scope.keep( scope.retired, cur );
+                return n->left != static_cast<index_type>( 0 ) ? n->left : n->right;
+            }
+            index_type min_node = 0;
+            index_type right    = erase_min( scope, n->right, min_node );
+            if ( scope.failed )
+                return cur;
+            node_type  m    = *resolve( min_node );
+            index_type repl = make_node( scope, m.key, m.value, resolve( cur )->left, right );
+            if ( repl == static_cast<index_type>( 0 ) )
+                return cur;
+            (void)scope.keep( scope.retired, cur );
+            return rebalance( scope, repl );
+        }
+        bool       go_left = key < n->key;
+        index_type child   = erase_rec( scope, go_left ? n->left : n->right, key, found );
+        if ( !found || scope.failed )
+            return cur;
+        index_type copy = own( scope, cur );
+        if ( copy == static_cast<index_type>( 0 ) )
+            return cur;
+        ( go_left ? resolve( copy )->left : resolve( copy )->right ) = child;
+        return rebalance( scope, copy );
+    }
+    static bool collect_subtree( index_type cur, std::vector<index_type>& out ) noexcept
+    {
+        try
+        {
+            std::vector<index_type> stack;
+            if ( cur != static_cast<index_type>( 0 ) )
+                stack.push_back( cur );
+            while ( !stack.empty() )
+            {
+                index_type       idx = stack.back();
+                const node_type* n   = resolve( idx );
+                stack.pop_back();
+                out.push_back( idx );
+                if ( n->left != static_cast<index_type>( 0 ) )
+                    stack.push_back( n->left );
+                if ( n->right != static_cast<index_type>( 0 ) )
+                    stack.push_back( n->right );
+            }
+        }
+        catch ( ... )
+        {
+            return false;
+        }
+        return true;
+    }
+    static void discard( write_scope& scope ) noexcept
+    {
+        for ( index_type idx : scope.fresh )
+            ManagerT::template deallocate_typed<node_type>( node_pptr( idx ) );
+        scope.fresh.clear();
+        scope.retired.clear();
+    }
+    bool publish( write_scope& scope, index_type root ) noexcept
+    {
+        if ( scope.failed )
+        {
+            discard( scope );
+            return false;
+        }
+        std::sort( scope.retired.begin(), scope.retired.end() );
+        scope.retired.erase( std::unique( scope.retired.begin(), scope.retired.end() ), scope.retired.end() );
+        auto dead = std::partition( scope.retired.begin(), scope.retired.end(), [&]( index_type idx )
+                                    { return std::find( scope.fresh.begin(), scope.fresh.end(), idx ) == scope.fresh.end(); } );
+        const size_t kept = static_cast<size_t>( dead - scope.retired.begin() );
+        batch_pptr   batch;
+        if ( kept != 0 )
+        {
+            batch = ManagerT::template allocate_typed<index_type>( kBatchHeaderWords + kept );
+            if ( batch.is_null() )
+            {
+                discard( scope );
+                return false;
+            }
+        }
+        std::lock_guard<std::mutex> lock( _state_mutex );
+        try
+        {
+            _retired.reserve( _retired.size() + 1 );
+        }
+        catch ( ... )
+        {
+            if ( !batch.is_null() )
+                ManagerT::template deallocate_typed<index_type>( batch );
+            discard( scope );
+            return false;
+        }
+        index_type prev_head = ManagerT::get_domain_root_offset( _retired_name );
+        if ( !batch.is_null() )
+        {
+            index_type* words = ManagerT::template resolve_checked<index_type>( batch );
+            words[0]          = prev_head;
+            words[1]          = static_cast<index_type>( kept );
+            std::copy( scope.retired.begin(), dead, words + kBatchHeaderWords );
+        }
+        const char*      names[] = { _name, _retired_name };
+        const index_type roots[] = { root, batch.is_null() ? prev_head : batch.offset() };
+        if ( !ManagerT::set_domain_roots( names, roots, 2 ) )
+        {
+            if ( !batch.is_null() )
+                ManagerT::template deallocate_typed<index_type>( batch );
+            discard( scope );
+            return false;
+        }
+        ++_version;
+        for ( auto it = dead; it != scope.retired.end(); ++it )
+            ManagerT::template deallocate_typed<node_type>( node_pptr( *it ) );
+        if ( !batch.is_null() )
+            _retired.push_back( { batch.offset(), kept, _version } );
+        reclaim_unlocked();
+        return true;
+    }
+    void unpin( uint64_t version ) noexcept
+    {
+        std::lock_guard<std::mutex> lock( _state_mutex );
+        auto                        it = std::find( _pins.begin(), _pins.end(), version );
+        if ( it != _pins.end() )
+            _pins.erase( it );
+        reclaim_unlocked();
+    }
+    size_t reclaim_unlocked() noexcept
+    {
+        uint64_t horizon = _pins.empty() ? _version : *std::min_element( _pins.begin(), _pins.end() );
+        size_t   done    = 0;
+        while ( done < _retired.size() && _retired[done].retired_at <= horizon )
+            ++done;
+        if ( done == 0 )
+            return 0;
+        if ( done == _retired.size() )
+            (void)ManagerT::set_domain_root( _retired_name, batch_pptr() );
+        else
+            ManagerT::template resolve_checked<index_type>( batch_pptr( _retired[done].block ) )[0] = 0;
+        size_t freed = 0;
+        for ( size_t i = 0; i < done; ++i )
+        {
+            free_batch( _retired[i] );
+            freed += _retired[i].count;
+        }
+        _retired.erase( _retired.begin(), _retired.begin() + static_cast<std::ptrdiff_t>( done ) );
+        return freed;
+    }
+};
+}
@@ -0,0 +1,779 @@
+#pragma once
+#include "pmm/pmap.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+namespace pmm
+{
+enum class RadixNodeType : uint8_t
+{
+    Leaf    = 0,
+    Node4   = 1,
+    Node16  = 2,
+    Node48  = 3,
+    Node256 = 4,
+};
+inline constexpr size_t kRadixPrefixMax = 8;
+template <typename IndexT> struct pradix_header
+{
+    uint64_t count;
+    IndexT   root;
+};
+template <typename V> struct pradix_leaf
+{
+    uint8_t  type;
+    uint32_t key_len;
+    V        value;
+};
+template <typename IndexT> struct pradix_node
+{
+    uint8_t  type;
+    uint16_t count;
+    uint32_t prefix_len;
+    uint8_t  prefix[kRadixPrefixMax];
+    IndexT   terminal;
+};
+template <typename IndexT> struct pradix_node4 : pradix_node<IndexT>
+{
+    uint8_t keys[4];
+    IndexT  children[4];
+};
+template <typename IndexT> struct pradix_node16 : pradix_node<IndexT>
+{
+    uint8_t keys[16];
+    IndexT  children[16];
+};
+template <typename IndexT> struct pradix_node48 : pradix_node<IndexT>
+{
+    uint8_t index[256];
+    IndexT  children[48];
+};
+template <typename IndexT> struct pradix_node256 : pradix_node<IndexT>
+{
+    IndexT children[256];
+};
+template <typename V, typename ManagerT>
+/*
+## pmm-pradix
+req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
+*/
+class pradix
+{
+  public:
+    static_assert( std::is_trivially_copyable_v<V>, "pradix: V must be trivially copyable" );
+    using manager_type = ManagerT;
+    using index_type   = typename ManagerT::index_type;
+    using value_type   = V;
+    using header_type  = pradix_header<index_type>;
+    using leaf_type    = pradix_leaf<V>;
+    using node_type    = pradix_node<index_type>;
+    using node4_type   = pradix_node4<index_type>;
+    using node16_type  = pradix_node16<index_type>;
+    using node48_type  = pradix_node48<index_type>;
+    using node256_type = pradix_node256<index_type>;
+    pradix() noexcept { bind( nullptr ); }
+    explicit pradix( const char* domain_key ) noexcept { bind( domain_key ); }
+    pradix( const pradix& )            = delete;
+    pradix& operator=( const pradix& ) = delete;
+    bool       is_bound() const noexcept { return _header != static_cast<index_type>( 0 ); }
+    index_type root_index() const noexcept { return _header; }
+    size_t     size() const noexcept
+    {
+        const header_type* h = header();
+        return h == nullptr ? 0 : static_cast<size_t>( h->count );
+    }
+    bool empty() const noexcept { return size() == 0; }
+/*
+### pmm-pradix-insert
+*/
+    bool insert( const char* key, size_t len, const V& value ) noexcept
+    {
+        if ( header() == nullptr || ( key == nullptr && len > 0 ) || len > UINT32_MAX )
+            return false;
+        const uint8_t* k     = reinterpret_cast<const uint8_t*>( key );
+        slot_ref       ref   = { 0, kRootSlot };
+        size_t         depth = 0;
+        for ( ;; )
+        {
+            const index_type idx = *slot( ref );
+            if ( idx == static_cast<index_type>( 0 ) )
+                return attach_leaf( ref, k, len, value );
+            if ( is_leaf( idx ) )
+            {
+                if ( leaf_equals( idx, k, len ) )
+                {
+                    leaf( idx )->value = value;
+                    return true;
+                }
+                return split_leaf( ref, idx, k, len, depth, value );
+            }
+            const node_type* n = node( idx );
+            if ( n->prefix_len > 0 )
+            {
+                const size_t mismatch = prefix_mismatch( idx, k, len, depth );
+                if ( mismatch < n->prefix_len )
+                    return split_prefix( ref, idx, k, len, depth, mismatch, value );
+                depth += n->prefix_len;
+            }
+            if ( depth == len )
+            {
+                if ( n->terminal != static_cast<index_type>( 0 ) )
+                {
+                    leaf( n->terminal )->value = value;
+                    return true;
+                }
+                return attach_leaf( slot_ref{ idx, kTerminalSlot }, k, len, value );
+            }
+            if ( child_ptr( node( idx ), k[depth] ) != nullptr )
+            {
+                ref = slot_ref{ idx, k[depth] };
+                ++depth;
+                continue;
+            }
+            return add_leaf_child( ref, idx, k, len, depth, value );
+        }
+    }
+    bool insert( const char* key, const V& value ) noexcept
+    {
+        return insert( key, key == nullptr ? 0 : std::strlen( key ), value );
+    }
+/*
+### pmm-pradix-find
+*/
+    bool find( const char* key, size_t len, V& out ) const noexcept
+    {
+        const index_type idx = lookup( reinterpret_cast<const uint8_t*>( key ), len );
+        if ( idx == static_cast<index_type>( 0 ) )
+            return false;
+        out = leaf( idx )->value;
+        return true;
+    }
+    bool find( const char* key, V& out ) const noexcept
+    {
+        return find( key, key == nullptr ? 0 : std::strlen( key ), out );
+    }
+    bool contains( const char* key, size_t len ) const noexcept
+    {
+        return lookup( reinterpret_cast<const uint8_t*>( key ), len ) != static_cast<index_type>( 0 );
+    }
+    bool contains( const char* key ) const noexcept { return contains( key, key == nullptr ? 0 : std::strlen( key ) ); }
+/*
+### pmm-pradix-erase
+*/
+    bool erase( const char* key, size_t len ) noexcept
+    {
+        if ( header() == nullptr || ( key == nullptr && len > 0 ) )
+            return false;
+        const uint8_t* k      = reinterpret_cast<const uint8_t*>( key );
+        slot_ref       parent = { 0, kRootSlot };
+        slot_ref       ref    = parent;
+        size_t         depth  = 0;
+        for ( ;; )
+        {
+            const index_type idx = *slot( ref );
+            if ( idx == static_cast<index_type>( 0 ) )
+                return false;
+            if ( is_leaf( idx ) )
+            {
+                if ( !leaf_equals( idx, k, len ) )
+                    return false;
+                detach( ref );
+                free_block( idx );
+                --header()->count;
+                if ( ref.node != static_cast<index_type>( 0 ) )
+                    compact( parent, ref.node );
+                return true;
+            }
+            const node_type* n = node( idx );
+            if ( n->prefix_len > 0 )
+            {
+                if ( prefix_mismatch( idx, k, len, depth ) < n->prefix_len )
+                    return false;
+                depth += n->prefix_len;
+            }
+            parent = ref;
+            if ( depth == len )
+                ref = slot_ref{ idx, kTerminalSlot };
+            else
+            {
+                if ( child_ptr( node( idx ), k[depth] ) == nullptr )
+                    return false;
+                ref = slot_ref{ idx, k[depth] };
+                ++depth;
+            }
+        }
+    }
+    bool erase( const char* key ) noexcept { return erase( key, key == nullptr ? 0 : std::strlen( key ) ); }
+/*
+### pmm-pradix-for_each_prefix
+*/
+    template <typename FnT> size_t for_each_prefix( const char* prefix, size_t len, FnT&& fn ) const
+    {
+        const header_type* h = header();
+        if ( h == nullptr || ( prefix == nullptr && len > 0 ) )
+            return 0;
+        const uint8_t* p     = reinterpret_cast<const uint8_t*>( prefix );
+        index_type     idx   = h->root;
+        size_t         depth = 0;
+        while ( idx != static_cast<index_type>( 0 ) )
+        {
+            if ( is_leaf( idx ) )
+                return walk( idx, p, len, fn );
+            const node_type* n     = node( idx );
+            const size_t     known = n->prefix_len < kRadixPrefixMax ? n->prefix_len : kRadixPrefixMax;
+            for ( size_t i = 0; i < known && depth + i < len; ++i )
+            {
+                if ( n->prefix[i] != p[depth + i] )
+                    return 0;
+            }
+            depth += n->prefix_len;
+            if ( depth >= len )
+                return walk( idx, p, len, fn );
+            idx = child_of( n, p[depth] );
+            ++depth;
+        }
+        return 0;
+    }
+    template <typename FnT> size_t for_each_prefix( const char* prefix, FnT&& fn ) const
+    {
+        return for_each_prefix( prefix, prefix == nullptr ? 0 : std::strlen( prefix ), fn );
+    }
+    template <typename FnT> size_t for_each( FnT&& fn ) const { return for_each_prefix( nullptr, 0, fn ); }
+    void                           clear() noexcept
+    {
+        header_type* h = header();
+        if ( h == nullptr )
+            return;
+        free_subtree( h->root );
+        h        = header();
+        h->root  = static_cast<index_type>( 0 );
+        h->count = 0;
+    }
+
+  private:
+    static constexpr int kRootSlot     = -2;
+    static constexpr int kTerminalSlot = -1;
+    struct slot_ref
+    {
+        index_type node;
+        int        byte;
+    };
+    index_type _header = 0;
+    void       bind( const char* domain_key ) noexcept
+    {
+        constexpr uint32_t kTypeHash = detail::pmap_fnv1a( 0x72616478u, detail::pmap_type_fp<V>(), 4 );
+        char               buf[detail::kForestDomainNameCapacity]{};
+        if ( !detail::pmap_bind_domain_name<ManagerT>( buf, kTypeHash, domain_key ) )
+            return;
+        index_type h = ManagerT::get_domain_root_offset( buf );
+        if ( h == static_cast<index_type>( 0 ) )
+        {
+            auto p = ManagerT::template allocate_typed<header_type>();
+            if ( p.is_null() )
+                return;
+            std::memset( static_cast<void*>( resolve<header_type>( p.offset() ) ), 0, sizeof( header_type ) );
+            if ( !ManagerT::set_domain_root( buf, p ) )
+                return;
+            h = p.offset();
+        }
+        _header = h;
+    }
+    template <typename T> static T* resolve( index_type idx ) noexcept
+    {
+        return detail::pmap_resolve<T, ManagerT>( idx );
+    }
+    header_type*      header() const noexcept { return resolve<header_type>( _header ); }
+    static bool       is_leaf( index_type idx ) noexcept { return *resolve<uint8_t>( idx ) == 0; }
+    static leaf_type* leaf( index_type idx ) noexcept { return resolve<leaf_type>( idx ); }
+    static node_type* node( index_type idx ) noexcept { return resolve<node_type>( idx ); }
+    static const uint8_t* leaf_key( const leaf_type* l ) noexcept
+    {
+        return reinterpret_cast<const uint8_t*>( l ) + sizeof( leaf_type );
+    }
+    static bool leaf_equals( index_type idx, const uint8_t* k, size_t len ) noexcept
+    {
+        const leaf_type* l = leaf( idx );
+        return l->key_len == len && ( len == 0 || std::memcmp( leaf_key( l ), k, len ) == 0 );
+    }
+    static size_t node_bytes( uint8_t type ) noexcept
+    {
+        switch ( static_cast<RadixNodeType>( type ) )
+        {
+        case RadixNodeType::Node4:
+            return sizeof( node4_type );
+        case RadixNodeType::Node16:
+            return sizeof( node16_type );
+        case RadixNodeType::Node48:
+            return sizeof( node48_type );
+        default:
+            return sizeof( node256_type );
+        }
+    }
+    static size_t node_capacity( uint8_t type ) noexcept
+    {
+        static constexpr size_t kCapacity[] = { 0, 4, 16, 48, 256 };
+        return kCapacity[type];
+    }
+    index_type* slot( const slot_ref& r ) const noexcept
+    {
+        if ( r.node == static_cast<index_type>( 0 ) )
+            return &header()->root;
+        node_type* n = node( r.node );
+        return r.byte == kTerminalSlot ? &n->terminal : child_ptr( n, static_cast<uint8_t>( r.byte ) );
+    }
+/*
+### pmm-pradix-child_ptr
+*/
+    static index_type* child_ptr( node_type* n, uint8_t c ) noexcept
+    {
+        switch ( static_cast<RadixNodeType>( n->type ) )
+        {
+        case RadixNodeType::Node4:
+        {
+            auto* n4 = static_cast<node4_type*>( n );
+            for ( size_t i = 0; i < n->count; ++i )
+            {
+                if ( n4->keys[i] == c )
+                    return &n4->children[i];
+            }
+            return nullptr;
+        }
+        case RadixNodeType::Node16:
+        {
+            auto* n16 = static_cast<node16_type*>( n );
+#if defined( __SSE2__ )
+            const __m128i eq = _mm_cmpeq_epi8( _mm_set1_epi8( static_cast<char>( c ) ),
+                                               _mm_loadu_si128( reinterpret_cast<const __m128i*>( n16->keys ) ) );
+            const unsigned bits =
+                static_cast<unsigned>( _mm_movemask_epi8( eq ) ) & ( ( 1u << n->count ) - 1u );
+            return bits != 0 ? &n16->children[__builtin_ctz( bits )] : nullptr;
+#else
+            for ( size_t i = 0; i < n->count; ++i )
+            {
+                if ( n16->keys[i] == c )
+                    return &n16->children[i];
+            }
+            return nullptr;
+#endif
+        }
+        case RadixNodeType::Node48:
+        {
+            auto* n48 = static_cast<node48_type*>( n );
+            return n48->index[c] != 0 ? &n48->children[n48->index[c] - 1] : nullptr;
+        }
+        default:
+        {
+            auto* n256 = static_cast<node256_type*>( n );
+            return n256->children[c] != static_cast<index_type>( 0 ) ? &n256->children[c] : nullptr;
+        }
+        }
+    }
+    static index_type child_of( const node_type* n, uint8_t c ) noexcept
+    {
+        const index_type* p = child_ptr( const_cast<node_type*>( n ), c );
+        return p == nullptr ? static_cast<index_type>( 0 ) : *p;
+    }
+    template <typename FnT> static void for_each_child( const node_type* n, FnT&& fn )
+    {
+        switch ( static_cast<RadixNodeType>( n->type ) )
+        {
+        case RadixNodeType::Node4:
+            for ( size_t i = 0; i < n->count; ++i )
+                fn( static_cast<const node4_type*>( n )->keys[i], static_cast<const node4_type*>( n )->children[i] );
+            break;
+        case RadixNodeType::Node16:
+            for ( size_t i = 0; i < n->count; ++i )
+                fn( static_cast<const node16_type*>( n )->keys[i], static_cast<const node16_type*>( n )->children[i] );
+            break;
+        case RadixNodeType::Node48:
+        {
+            const auto* n48 = static_cast<const node48_type*>( n );
+            for ( size_t c = 0; c < 256; ++c )
+            {
+                if ( n48->index[c] != 0 )
+                    fn( static_cast<uint8_t>( c ), n48->children[n48->index[c] - 1] );
+            }
+            break;
+        }
+        default:
+        {
+            const auto* n256 = static_cast<const node256_type*>( n );
+            for ( size_t c = 0; c < 256; ++c )
+            {
+                if ( n256->children[c] != static_cast<index_type>( 0 ) )
+                    fn( static_cast<uint8_t>( c ), n256->children[c] );
+            }
+        }
+        }
+    }
+    static void add_child( node_type* n, uint8_t c, index_type child ) noexcept
+    {
+        switch ( static_cast<RadixNodeType>( n->type ) )
+        {
+        case RadixNodeType::Node4:
+            insert_sorted( static_cast<node4_type*>( n )->keys, static_cast<node4_type*>( n )->children, n->count, c,
+                           child );
+            break;
+        case RadixNodeType::Node16:
+            insert_sorted( static_cast<node16_type*>( n )->keys, static_cast<node16_type*>( n )->children, n->count,
+                           c, child );
+            break;
+        case RadixNodeType::Node48:
+        {
+            auto*  n48 = static_cast<node48_type*>( n );
+            size_t pos = 0;
+            while ( n48->children[pos] != static_cast<index_type>( 0 ) )
+                ++pos;
+            n48->children[pos] = child;
+            n48->index[c]      = static_cast<uint8_t>( pos + 1 );
+            break;
+        }
+        default:
+            static_cast<node256_type*>( n )->children[c] = child;
+        }
+        ++n->count;
+    }
+    static void insert_sorted( uint8_t* keys, index_type* children, size_t count, uint8_t c, index_type child ) noexcept
+    {
+        size_t i = 0;
+        while ( i < count && keys[i] < c )
+            ++i;
+        std::memmove( keys + i + 1, keys + i, count - i );
+        std::memmove( children + i + 1, children + i, ( count - i ) * sizeof( index_type ) );
+        keys[i]     = c;
+        children[i] = child;
+    }
+    static void remove_child( node_type* n, uint8_t c ) noexcept
+    {
+        switch ( static_cast<RadixNodeType>( n->type ) )
+        {
+        case RadixNodeType::Node4:
+            remove_sorted( static_cast<node4_type*>( n )->keys, static_cast<node4_type*>( n )->children, n->count, c );
+            break;
+        case RadixNodeType::Node16:
+            remove_sorted( static_cast<node16_type*>( n )->keys, static_cast<node16_type*>( n )->children, n->count,
+                           c );
+            break;
+        case RadixNodeType::Node48:
+        {
+            auto* n48                        = static_cast<node48_type*>( n );
+            n48->children[n48->index[c] - 1] = static_cast<index_type>( 0 );
+            n48->index[c]                    = 0;
+            break;
+        }
+        default:
+            static_cast<node256_type*>( n )->children[c] = static_cast<index_type>( 0 );
+        }
+        --n->count;
+    }
+    static void remove_sorted( uint8_t* keys, index_type* children, size_t count, uint8_t c ) noexcept
+    {
+        size_t i = 0;
+        while ( keys[i] != c )
+            ++i;
+        std::memmove( keys + i, keys + i + 1, count - i - 1 );
+        std::memmove( children + i, children + i + 1, ( count - i - 1 ) * sizeof( index_type ) );
+    }
+    static index_type make_leaf( const uint8_t* k, size_t len, const V& value ) noexcept
+    {
+        auto p = ManagerT::template allocate_typed<uint8_t>( sizeof( leaf_type ) + len );
+        if ( p.is_null() )
+            return 0;
+        leaf_type* l = leaf( p.offset() );
+        std::memset( static_cast<void*>( l ), 0, sizeof( leaf_type ) );
+        l->type    = static_cast<uint8_t>( RadixNodeType::Leaf );
+        l->key_len = static_cast<uint32_t>( len );
+        l->value   = value;
+        if ( len > 0 )
+            std::memcpy( reinterpret_cast<uint8_t*>( l ) + sizeof( leaf_type ), k, len );
+        return p.offset();
+    }
+    static index_type make_node( RadixNodeType type ) noexcept
+    {
+        const size_t bytes = node_bytes( static_cast<uint8_t>( type ) );
+        auto         p     = ManagerT::template allocate_typed<uint8_t>( bytes );
+        if ( p.is_null() )
+            return 0;
+        std::memset( resolve<uint8_t>( p.offset() ), 0, bytes );
+        node( p.offset() )->type = static_cast<uint8_t>( type );
+        return p.offset();
+    }
+    static void free_block( index_type idx ) noexcept
+    {
+        ManagerT::template deallocate_typed<uint8_t>( typename ManagerT::template pptr<uint8_t>( idx ) );
+    }
+    static void set_prefix( node_type* n, const uint8_t* bytes, size_t len ) noexcept
+    {
+        n->prefix_len = static_cast<uint32_t>( len );
+        std::memcpy( n->prefix, bytes, len < kRadixPrefixMax ? len : kRadixPrefixMax );
+    }
+    static index_type min_leaf( index_type idx ) noexcept
+    {
+        while ( idx != static_cast<index_type>( 0 ) && !is_leaf( idx ) )
+        {
+            const node_type* n = node( idx );
+            if ( n->terminal != static_cast<index_type>( 0 ) )
+                return n->terminal;
+            index_type first = 0;
+            for_each_child( n,
+                            [&]( uint8_t, index_type child )
+                            {
+                                if ( first == static_cast<index_type>( 0 ) )
+                                    first = child;
+                            } );
+            idx = first;
+        }
+        return idx;
+    }
+    static size_t prefix_mismatch( index_type idx, const uint8_t* k, size_t len, size_t depth ) noexcept
+    {
+        const node_type* n     = node( idx );
+        const size_t     known = n->prefix_len < kRadixPrefixMax ? n->prefix_len : kRadixPrefixMax;
+        for ( size_t i = 0; i < known; ++i )
+        {
+            if ( depth + i >= len || n->prefix[i] != k[depth + i] )
+                return i;
+        }
+        if ( n->prefix_len > kRadixPrefixMax )
+        {
+            const uint8_t* lk = leaf_key( leaf( min_leaf( idx ) ) );
+            for ( size_t i = kRadixPrefixMax; i < n->prefix_len; ++i )
+            {
+                if ( depth + i >= len || lk[depth + i] != k[depth + i] )
+                    return i;
+            }
+        }
+        return n->prefix_len;
+    }
+    index_type lookup( const uint8_t* k, size_t len ) const noexcept
+    {
+        const header_type* h = header();
+        if ( h == nullptr || ( k == nullptr && len > 0 ) )
+            return 0;
+        index_type idx   = h->root;
+        size_t     depth = 0;
+        while ( idx != static_cast<index_type>( 0 ) )
+        {
+            if ( is_leaf( idx ) )
+                return leaf_equals( idx, k, len ) ? idx : static_cast<index_type>( 0 );
+            const node_type* n     = node( idx );
+            const size_t     known = n->prefix_len < kRadixPrefixMax ? n->prefix_len : kRadixPrefixMax;
+            if ( depth + n->prefix_len > len )
+                return 0;
+            for ( size_t i = 0; i < known; ++i )
+            {
+                if ( n->prefix[i] != k[depth + i] )
+                    return 0;
+            }
+            depth += n->prefix_len;
+            if ( depth == len )
+            {
+                const index_type t = n->terminal;
+                return t != static_cast<index_type>( 0 ) && leaf_equals( t, k, len ) ? t : static_cast<index_type>( 0 );
+            }
+            idx = child_of( n, k[depth] );
+            ++depth;
+        }
+        return 0;
+    }
+    bool attach_leaf( const slot_ref& ref, const uint8_t* k, size_t len, const V& value ) noexcept
+    {
+        const index_type l = make_leaf( k, len, value );
+        if ( l == static_cast<index_type>( 0 ) )
+            return false;
+        *slot( ref ) = l;
+        ++header()->count;
+        return true;
+    }
+    bool split_leaf( const slot_ref& ref, index_type old, const uint8_t* k, size_t len, size_t depth,
+                     const V& value ) noexcept
+    {
+        const index_type l = make_leaf( k, len, value );
+        if ( l == static_cast<index_type>( 0 ) )
+            return false;
+        const index_type inner = make_node( RadixNodeType::Node4 );
+        if ( inner == static_cast<index_type>( 0 ) )
+        {
+            free_block( l );
+            return false;
+        }
+        const leaf_type* o      = leaf( old );
+        const uint8_t*   ok     = leaf_key( o );
+        size_t           common = 0;
+        while ( depth + common < len && depth + common < o->key_len && ok[depth + common] == k[depth + common] )
+            ++common;
+        node_type* n = node( inner );
+        set_prefix( n, k + depth, common );
+        place( n, old, o->key_len, ok, depth + common );
+        place( n, l, len, k, depth + common );
+        *slot( ref ) = inner;
+        ++header()->count;
+        return true;
+    }
+    static void place( node_type* n, index_type child, size_t key_len, const uint8_t* key, size_t at ) noexcept
+    {
+        if ( key_len == at )
+            n->terminal = child;
+        else
+            add_child( n, key[at], child );
+    }
+    bool split_prefix( const slot_ref& ref, index_type idx, const uint8_t* k, size_t len, size_t depth,
+                       size_t mismatch, const V& value ) noexcept
+    {
+        const index_type l = make_leaf( k, len, value );
+        if ( l == static_cast<index_type>( 0 ) )
+            return false;
+        const index_type inner = make_node( RadixNodeType::Node4 );
+        if ( inner == static_cast<index_type>( 0 ) )
+        {
+            free_block( l );
+            return false;
+        }
+        node_type* n = node( idx );
+        uint8_t    branch;
+        if ( n->prefix_len <= kRadixPrefixMax )
+        {
+            branch        = n->prefix[mismatch];
+            n->prefix_len = static_cast<uint32_t>( n->prefix_len - mismatch - 1 );
+            std::memmove( n->prefix, n->prefix + mismatch + 1, n->prefix_len );
+        }
+        else
+        {
+            const uint8_t* lk = leaf_key( leaf( min_leaf( idx ) ) );
+            branch            = lk[depth + mismatch];
+            set_prefix( n, lk + depth + mismatch + 1, n->prefix_len - mismatch - 1 );
+        }
+        node_type* top = node( inner );
+        set_prefix( top, k + depth, mismatch );
+        add_child( top, branch, idx );
+        place( top, l, len, k, depth + mismatch );
+        *slot( ref ) = inner;
+        ++header()->count;
+        return true;
+    }
+    bool add_leaf_child( const slot_ref& ref, index_type idx, const uint8_t* k, size_t len, size_t depth,
+                         const V& value ) noexcept
+    {
+        const index_type l = make_leaf( k, len, value );
+        if ( l == static_cast<index_type>( 0 ) )
+            return false;
+        if ( node( idx )->count == node_capacity( node( idx )->type ) )
+        {
+            const index_type grown = retype( idx, static_cast<RadixNodeType>( node( idx )->type + 1 ) );
+            if ( grown == static_cast<index_type>( 0 ) )
+            {
+                free_block( l );
+                return false;
+            }
+            *slot( ref ) = grown;
+            idx          = grown;
+        }
+        add_child( node( idx ), k[depth], l );
+        ++header()->count;
+        return true;
+    }
+/*
+### pmm-pradix-retype
+*/
+    static index_type retype( index_type idx, RadixNodeType type ) noexcept
+    {
+        const index_type fresh = make_node( type );
+        if ( fresh == static_cast<index_type>( 0 ) )
+            return 0;
+        const node_type* old = node( idx );
+        node_type*       n   = node( fresh );
+        n->prefix_len        = old->prefix_len;
+        n->terminal          = old->terminal;
+        std::memcpy( n->prefix, old->prefix, kRadixPrefixMax );
+        for_each_child( old, [n]( uint8_t c, index_type child ) { add_child( n, c, child ); } );
+        free_block( idx );
+        return fresh;
+    }
+    void detach( const slot_ref& ref ) noexcept
+    {
+        if ( ref.node == static_cast<index_type>( 0 ) )
+            header()->root = static_cast<index_type>( 0 );
+        else if ( ref.byte == kTerminalSlot )
+            node( ref.node )->terminal = static_cast<index_type>( 0 );
+        else
+            remove_child( node( ref.node ), static_cast<uint8_t>( ref.byte ) );
+    }
+    void compact( const slot_ref& ref, index_type idx ) noexcept
+    {
+        node_type* n = node( idx );
+        if ( n->count == 0 )
+        {
+            *slot( ref ) = n->terminal;
+            free_block( idx );
+            return;
+        }
+        if ( n->count == 1 && n->terminal == static_cast<index_type>( 0 ) )
+        {
+            uint8_t    branch = 0;
+            index_type child  = 0;
+            for_each_child( n,
+                            [&]( uint8_t c, index_type ch )
+                            {
+                                branch = c;
+                                child  = ch;
+                            } );
+            if ( !is_leaf( child ) )
+            {
+                node_type* cn = node( child );
+                uint8_t    merged[kRadixPrefixMax];
+                size_t     used = n->prefix_len < kRadixPrefixMax ? n->prefix_len : kRadixPrefixMax;
+                std::memcpy( merged, n->prefix, used );
+                if ( used < kRadixPrefixMax )
+                    merged[used++] = branch;
+                for ( size_t i = 0; used < kRadixPrefixMax && i < cn->prefix_len && i < kRadixPrefixMax; ++i )
+                    merged[used++] = cn->prefix[i];
+                cn->prefix_len = n->prefix_len + 1 + cn->prefix_len;
+                std::memcpy( cn->prefix, merged, used );
+            }
+            *slot( ref ) = child;
+            free_block( idx );
+            return;
+        }
+        static constexpr size_t kShrinkAt[] = { 0, 0, 3, 12, 37 };
+        if ( n->type > static_cast<uint8_t>( RadixNodeType::Node4 ) && n->count <= kShrinkAt[n->type] )
+        {
+            const index_type smaller = retype( idx, static_cast<RadixNodeType>( n->type - 1 ) );
+            if ( smaller != static_cast<index_type>( 0 ) )
+                *slot( ref ) = smaller;
+        }
+    }
+    template <typename FnT> static size_t walk( index_type idx, const uint8_t* p, size_t len, FnT& fn )
+    {
+        if ( is_leaf( idx ) )
+        {
+            const leaf_type* l = leaf( idx );
+            if ( l->key_len < len || ( len > 0 && std::memcmp( leaf_key( l ), p, len ) != 0 ) )
+                return 0;
+            fn( reinterpret_cast<const char*>( leaf_key( l ) ), static_cast<size_t>( l->key_len ), l->value );
+            return 1;
+        }
+        const node_type* n       = node( idx );
+        size_t           visited = 0;
+        if ( n->terminal != static_cast<index_type>( 0 ) )
+            visited += walk( n->terminal, p, len, fn );
+        for_each_child( n, [&]( uint8_t, index_type child ) { visited += walk( child, p, len, fn ); } );
+        return visited;
+    }
+    static void free_subtree( index_type idx ) noexcept
+    {
+        if ( idx == static_cast<index_type>( 0 ) )
+            return;
+        if ( !is_leaf( idx ) )
+        {
+            const node_type* n = node( idx );
+            free_subtree( n->terminal );
+            for_each_child( n, []( uint8_t, index_type child ) { free_subtree( child ); } );
+        }
+        free_block( idx );
+    }
+};
+}
@@ -0,0 +1,287 @@
+#pragma once
+#include "pmm/pmap.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+namespace pmm
+{
+enum class RingMode : uint8_t
+{
+    Spsc = 1,
+    Mpsc = 2,
+};
+inline constexpr uint64_t kRingMagic    = 0x676e6972706d6d70ull;
+inline constexpr size_t   kRingLineSize = 64;
+struct pring_header
+{
+    uint64_t magic;
+    uint64_t capacity;
+    uint64_t slot_size;
+    uint64_t mode;
+    uint8_t  _pad0[kRingLineSize - 4 * sizeof( uint64_t )];
+    uint64_t head;
+    uint8_t  _pad1[kRingLineSize - sizeof( uint64_t )];
+    uint64_t tail;
+    uint8_t  _pad2[kRingLineSize - sizeof( uint64_t )];
+};
+static_assert( sizeof( pring_header ) == 3 * kRingLineSize, "pring_header: head and tail must sit on separate lines" );
+template <typename T> struct pring_seq_slot
+{
+    uint64_t seq;
+    T        value;
+};
+template <typename T, typename ManagerT, RingMode Mode = RingMode::Spsc>
+/*
+## pmm-pring
+req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
+*/
+class pring
+{
+  public:
+    static_assert( std::is_trivially_copyable_v<T>, "pring: T must be trivially copyable" );
+    static_assert( std::atomic_ref<uint64_t>::is_always_lock_free, "pring: 64-bit atomics must be lock-free" );
+    using manager_type = ManagerT;
+    using index_type   = typename ManagerT::index_type;
+    using value_type   = T;
+    using slot_type    = std::conditional_t<Mode == RingMode::Mpsc, pring_seq_slot<T>, T>;
+    static constexpr RingMode mode = Mode;
+    explicit pring( const char* domain_key = nullptr, size_t capacity = 1024 ) noexcept { bind( domain_key, capacity ); }
+    pring( const pring& )            = delete;
+    pring& operator=( const pring& ) = delete;
+    bool       is_bound() const noexcept { return _block != static_cast<index_type>( 0 ); }
+    bool       needs_recovery() const noexcept { return _torn; }
+    index_type root_index() const noexcept { return _block; }
+    size_t     capacity() const noexcept
+    {
+        const pring_header* h = header();
+        return h == nullptr ? 0 : static_cast<size_t>( h->capacity );
+    }
+    size_t size() const noexcept
+    {
+        const pring_header* h = header();
+        if ( h == nullptr )
+            return 0;
+        const uint64_t head = load( h->head, std::memory_order_acquire );
+        const uint64_t tail = load( h->tail, std::memory_order_acquire );
+        return tail > head ? static_cast<size_t>( tail - head ) : 0;
+    }
+    bool empty() const noexcept { return size() == 0; }
+/*
+### pmm-pring-try_push
+*/
+    bool try_push( const T& value ) noexcept
+    {
+        pring_header* h = header();
+        if ( h == nullptr || _torn )
+            return false;
+        if constexpr ( Mode == RingMode::Spsc )
+        {
+            const uint64_t tail = load( h->tail, std::memory_order_relaxed );
+            if ( tail - _cached_head >= h->capacity )
+            {
+                _cached_head = load( h->head, std::memory_order_acquire );
+                if ( tail - _cached_head >= h->capacity )
+                    return false;
+            }
+            slots( h )[tail & ( h->capacity - 1 )] = value;
+            store( h->tail, tail + 1, std::memory_order_release );
+            return true;
+        }
+        else
+        {
+            uint64_t pos = load( h->tail, std::memory_order_relaxed );
+            for ( ;; )
+            {
+                slot_type&    s    = slots( h )[pos & ( h->capacity - 1 )];
+                const int64_t diff = static_cast<int64_t>( load( s.seq, std::memory_order_acquire ) - pos );
+                if ( diff == 0 )
+                {
+                    if ( std::atomic_ref<uint64_t>( h->tail ).compare_exchange_weak( pos, pos + 1,
+                                                                                     std::memory_order_relaxed ) )
+                    {
+                        s.value = value;
+                        store( s.seq, pos + 1, std::memory_order_release );
+                        return true;
+                    }
+                }
+                else if ( diff < 0 )
+                    return false;
+                else
+                    pos = load( h->tail, std::memory_order_relaxed );
+            }
+        }
+    }
+/*
+### pmm-pring-try_pop
+*/
+    bool try_pop( T& out ) noexcept
+    {
+        pring_header* h = header();
+        if ( h == nullptr || _torn )
+            return false;
+        const uint64_t head = load( h->head, std::memory_order_relaxed );
+        slot_type&     s    = slots( h )[head & ( h->capacity - 1 )];
+        if constexpr ( Mode == RingMode::Spsc )
+        {
+            if ( head == _cached_tail )
+            {
+                _cached_tail = load( h->tail, std::memory_order_acquire );
+                if ( head == _cached_tail )
+                    return false;
+            }
+            out = s;
+        }
+        else
+        {
+            if ( load( s.seq, std::memory_order_acquire ) != head + 1 )
+                return false;
+            out = s.value;
+            store( s.seq, head + h->capacity, std::memory_order_release );
+        }
+        store( h->head, head + 1, std::memory_order_release );
+        return true;
+    }
+/*
+### pmm-pring-validate
+*/
+    bool validate() const noexcept
+    {
+        const pring_header* h = header();
+        if ( h == nullptr )
+            return false;
+        const uint64_t head = load( h->head, std::memory_order_acquire );
+        const uint64_t tail = load( h->tail, std::memory_order_acquire );
+        if ( tail < head || tail - head > h->capacity )
+            return false;
+        if constexpr ( Mode == RingMode::Mpsc )
+        {
+            const slot_type* s = slots( h );
+            for ( uint64_t i = 0; i < h->capacity; ++i )
+            {
+                const uint64_t pos  = head + i;
+                const uint64_t want = pos < tail ? pos + 1 : pos;
+                if ( load( s[pos & ( h->capacity - 1 )].seq, std::memory_order_acquire ) != want )
+                    return false;
+            }
+        }
+        return true;
+    }
+/*
+### pmm-pring-recover
+*/
+    bool recover() noexcept
+    {
+        pring_header* h = header();
+        if ( h == nullptr )
+            return false;
+        if ( validate() )
+        {
+            _torn = false;
+            return false;
+        }
+        const uint64_t head = h->head;
+        uint64_t       tail = h->tail;
+        if ( tail < head || tail - head > h->capacity )
+            tail = head;
+        if constexpr ( Mode == RingMode::Mpsc )
+        {
+            slot_type* s    = slots( h );
+            uint64_t   keep = head;
+            while ( keep < tail && s[keep & ( h->capacity - 1 )].seq == keep + 1 )
+                ++keep;
+            tail = keep;
+            for ( uint64_t pos = tail; pos < head + h->capacity; ++pos )
+                s[pos & ( h->capacity - 1 )].seq = pos;
+        }
+        store( h->tail, tail, std::memory_order_release );
+        _cached_head = head;
+        _cached_tail = tail;
+        _torn        = false;
+        return true;
+    }
+
+  private:
+    index_type _block       = 0;
+    uint64_t   _cached_head = 0;
+    uint64_t   _cached_tail = 0;
+    bool       _torn        = false;
+    static uint64_t load( const uint64_t& v, std::memory_order order ) noexcept
+    {
+        return std::atomic_ref<uint64_t>( const_cast<uint64_t&>( v ) ).load( order );
+    }
+    static void store( uint64_t& v, uint64_t value, std::memory_order order ) noexcept
+    {
+        std::atomic_ref<uint64_t>( v ).store( value, order );
+    }
+    pring_header* header() const noexcept
+    {
+        return _block == static_cast<index_type>( 0 )
+                   ? nullptr
+                   : ManagerT::template resolve_unchecked<pring_header>(
+                         typename ManagerT::template pptr<pring_header>( _block ) );
+    }
+    static slot_type* slots( pring_header* h ) noexcept { return reinterpret_cast<slot_type*>( h + 1 ); }
+    static const slot_type* slots( const pring_header* h ) noexcept
+    {
+        return reinterpret_cast<const slot_type*>( h + 1 );
+    }
+    static bool layout_matches( const pring_header* h ) noexcept
+    {
+        return h->magic == kRingMagic && h->slot_size == sizeof( slot_type ) &&
+               h->mode == static_cast<uint64_t>( Mode ) && h->capacity >= 2 &&
+               ( h->capacity & ( h->capacity - 1 ) ) == 0;
+    }
+    void bind( const char* domain_key, size_t capacity ) noexcept
+    {
+        constexpr uint32_t kTypeHash =
+            detail::pmap_fnv1a( 0x72696e67u + static_cast<uint32_t>( Mode ), detail::pmap_type_fp<T>(), 4 );
+        char buf[detail::kForestDomainNameCapacity]{};
+        if ( !detail::pmap_bind_domain_name<ManagerT>( buf, kTypeHash, domain_key ) )
+            return;
+        index_type block = ManagerT::get_domain_root_offset( buf );
+        if ( block == static_cast<index_type>( 0 ) )
+            block = create_block( buf, capacity );
+        if ( block == static_cast<index_type>( 0 ) )
+            return;
+        const pring_header* h = ManagerT::template resolve_unchecked<pring_header>(
+            typename ManagerT::template pptr<pring_header>( block ) );
+        if ( h == nullptr || !layout_matches( h ) )
+            return;
+        _block       = block;
+        _torn        = !validate();
+        _cached_head = h->head;
+        _cached_tail = h->tail;
+    }
+    static index_type create_block( const char* name, size_t capacity ) noexcept
+    {
+        uint64_t cap = 2;
+        while ( cap < capacity && cap < ( uint64_t{ 1 } << 40 ) )
+            cap <<= 1;
+        const size_t bytes = sizeof( pring_header ) + static_cast<size_t>( cap ) * sizeof( slot_type );
+        auto         p     = ManagerT::template allocate_typed<uint8_t>( bytes );
+        if ( p.is_null() )
+            return 0;
+        pring_header* h = ManagerT::template resolve_unchecked<pring_header>(
+            typename ManagerT::template pptr<pring_header>( p.offset() ) );
+        std::memset( static_cast<void*>( h ), 0, bytes );
+        h->magic     = kRingMagic;
+        h->capacity  = cap;
+        h->slot_size = sizeof( slot_type );
+        h->mode      = static_cast<uint64_t>( Mode );
+        if constexpr ( Mode == RingMode::Mpsc )
+        {
+            for ( uint64_t i = 0; i < cap; ++i )
+                slots( h )[i].seq = i;
+        }
+        if ( !ManagerT::set_domain_root( name, typename ManagerT::template pptr<pring_header>( p.offset() ) ) )
+        {
+            ManagerT::template deallocate_typed<uint8_t>( p );
+            return 0;
+        }
+        ManagerT::lock_block_permanent( h );
+        return p.offset();
+    }
+};
+}
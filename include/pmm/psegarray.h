@@ -0,0 +1,156 @@
+#pragma once
+#include "pmm/pptr.h"
+#include "pmm/types.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+namespace pmm
+{
+/*
+## pmm-psegarray
+req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
+*/
+template <typename T, typename ManagerT, size_t ChunkElems = 1024> struct psegarray
+{
+    static_assert( std::is_trivially_copyable_v<T>, "" );
+    static_assert( ChunkElems > 0 && ( ChunkElems & ( ChunkElems - 1 ) ) == 0,
+                   "psegarray: ChunkElems must be a power of two" );
+    using manager_type                  = ManagerT;
+    using index_type                    = typename ManagerT::index_type;
+    using value_type                    = T;
+    static constexpr size_t chunk_elems = ChunkElems;
+    uint64_t   _size;
+    uint64_t   _chunks;
+    uint64_t   _dir_capacity;
+    index_type _dir_idx;
+    psegarray() noexcept
+        : _size( 0 ), _chunks( 0 ), _dir_capacity( 0 ),
+          _dir_idx( detail::kNullIdx_v<typename ManagerT::address_traits> )
+    {
+    }
+    ~psegarray() noexcept = default;
+    size_t   size() const noexcept { return static_cast<size_t>( _size ); }
+    bool     empty() const noexcept { return _size == 0; }
+    size_t   capacity() const noexcept { return static_cast<size_t>( _chunks ) * ChunkElems; }
+    size_t   chunk_count() const noexcept { return static_cast<size_t>( _chunks ); }
+    T*       at( size_t i ) noexcept { return i < _size ? slot( i ) : nullptr; }
+    const T* at( size_t i ) const noexcept { return i < _size ? slot( i ) : nullptr; }
+    T        operator[]( size_t i ) const noexcept
+    {
+        const T* p = slot( i );
+        return ( p != nullptr ) ? *p : T{};
+    }
+    T*       front() noexcept { return at( 0 ); }
+    const T* front() const noexcept { return at( 0 ); }
+    T*       back() noexcept { return ( _size > 0 ) ? at( static_cast<size_t>( _size ) - 1 ) : nullptr; }
+    const T* back() const noexcept { return ( _size > 0 ) ? at( static_cast<size_t>( _size ) - 1 ) : nullptr; }
+/*
+### pmm-psegarray-push_back
+*/
+    bool push_back( const T& value ) noexcept
+    {
+        if ( _size == capacity() && !add_chunk() )
+            return false;
+        T* p = slot( static_cast<size_t>( _size ) );
+        if ( p == nullptr )
+            return false;
+        *p = value;
+        ++_size;
+        return true;
+    }
+    void pop_back() noexcept
+    {
+        if ( _size > 0 )
+            --_size;
+    }
+    bool set( size_t i, const T& value ) noexcept
+    {
+        T* p = at( i );
+        if ( p == nullptr )
+            return false;
+        *p = value;
+        return true;
+    }
+    bool reserve( size_t n ) noexcept
+    {
+        while ( capacity() < n )
+        {
+            if ( !add_chunk() )
+                return false;
+        }
+        return true;
+    }
+    bool resize( size_t n ) noexcept
+    {
+        if ( !reserve( n ) )
+            return false;
+        for ( size_t i = static_cast<size_t>( _size ); i < n; )
+        {
+            const size_t run = ChunkElems - i % ChunkElems;
+            const size_t cnt = ( n - i < run ) ? n - i : run;
+            std::memset( static_cast<void*>( slot( i ) ), 0, cnt * sizeof( T ) );
+            i += cnt;
+        }
+        _size = n;
+        return true;
+    }
+    template <typename FnT> void for_each_chunk( FnT&& fn ) const
+    {
+        for ( size_t c = 0; c * ChunkElems < _size; ++c )
+        {
+            const size_t left = static_cast<size_t>( _size ) - c * ChunkElems;
+            fn( static_cast<const T*>( chunk( c ) ), left < ChunkElems ? left : ChunkElems );
+        }
+    }
+    void clear() noexcept { _size = 0; }
+    void free_data() noexcept
+    {
+        if ( _dir_idx != detail::kNullIdx_v<typename ManagerT::address_traits> )
+        {
+            for ( size_t c = 0; c < _chunks; ++c )
+                ManagerT::template deallocate_typed<T>( pmm::pptr<T, ManagerT>( directory()[c] ) );
+            ManagerT::template deallocate_typed<index_type>( pmm::pptr<index_type, ManagerT>( _dir_idx ) );
+            _dir_idx = detail::kNullIdx_v<typename ManagerT::address_traits>;
+        }
+        _size         = 0;
+        _chunks       = 0;
+        _dir_capacity = 0;
+    }
+
+  private:
+    index_type* directory() const noexcept { return pmm::pptr<index_type, ManagerT>( _dir_idx ).resolve_unchecked(); }
+    T* chunk( size_t c ) const noexcept
+    {
+        const index_type* dir = directory();
+        return ( dir != nullptr ) ? pmm::pptr<T, ManagerT>( dir[c] ).resolve_unchecked() : nullptr;
+    }
+    T* slot( size_t i ) const noexcept
+    {
+        if ( i / ChunkElems >= _chunks )
+            return nullptr;
+        T* c = chunk( i / ChunkElems );
+        return ( c != nullptr ) ? c + i % ChunkElems : nullptr;
+    }
+    bool add_chunk() noexcept
+    {
+        if ( _chunks == _dir_capacity )
+        {
+            const uint64_t                  new_cap = _dir_capacity < 8 ? 8 : _dir_capacity * 2;
+            pmm::pptr<index_type, ManagerT> old_p( _dir_idx );
+            pmm::pptr<index_type, ManagerT> new_p = ManagerT::template reallocate_typed<index_type>(
+                old_p, static_cast<size_t>( _chunks ), static_cast<size_t>( new_cap ) );
+            if ( new_p.is_null() )
+                return false;
+            _dir_idx      = new_p.offset();
+            _dir_capacity = new_cap;
+        }
+        pmm::pptr<T, ManagerT> c = ManagerT::template allocate_typed<T>( ChunkElems );
+        if ( c.is_null() )
+            return false;
+        directory()[_chunks] = c.offset();
+        ++_chunks;
+        return true;
+    }
+};
+}
@@ -15,40 +15,61 @@ template <typename ManagerT> struct pstring
 {
     using manager_type = ManagerT;
     using index_type   = typename ManagerT::index_type;
-    uint32_t   _length;
-    uint32_t   _capacity;
-    index_type _data_idx;
+    static constexpr size_t kInlineBytes = 16;
+    uint32_t                _length;
+    uint32_t                _capacity;
+    index_type              _data_idx;
+    char                    _inline_tail[kInlineBytes - sizeof( uint32_t ) - sizeof( index_type )];
+    uint32_t                _hash;
     pstring() noexcept
-        : _length( 0 ), _capacity( 0 ), _data_idx( detail::kNullIdx_v<typename ManagerT::address_traits> )
+        : _length( 0 ), _capacity( 0 ), _data_idx( detail::kNullIdx_v<typename ManagerT::address_traits> ),
+          _inline_tail{}, _hash( detail::kStrHashSeed )
     {
     }
     ~pstring() noexcept = default;
+    static constexpr uint32_t kInlineFlag = 0x80000000u;
+    static constexpr size_t   inline_capacity() noexcept
+    {
+        return offsetof( pstring, _hash ) - offsetof( pstring, _capacity ) - 1;
+    }
+    bool        is_inline() const noexcept { return ( _length & kInlineFlag ) != 0; }
     const char* c_str() const noexcept
     {
+        if ( is_inline() )
+            return inline_data();
         if ( _data_idx == detail::kNullIdx_v<typename ManagerT::address_traits> )
             return "";
         char* data = resolve_data();
         return ( data != nullptr ) ? data : "";
     }
-    size_t size() const noexcept { return static_cast<size_t>( _length ); }
-    bool   empty() const noexcept { return _length == 0; }
-    char   operator[]( size_t i ) const noexcept
-    {
-        char* data = resolve_data();
-        return ( data != nullptr ) ? data[i] : '\0';
-    }
-    bool assign( const char* s ) noexcept
+    size_t   size() const noexcept { return static_cast<size_t>( _length & ~kInlineFlag ); }
+    bool     empty() const noexcept { return size() == 0; }
+    char     operator[]( size_t i ) const noexcept { return c_str()[i]; }
+    uint32_t hash() const noexcept { return _hash; }
+    bool     assign( const char* s ) noexcept
     {
         if ( s == nullptr )
             s = "";
         auto len = static_cast<uint32_t>( std::strlen( s ) );
-        if ( !ensure_capacity( len ) )
+        if ( len >= kInlineFlag )
+            return false;
+        const uint32_t h        = detail::str_hash( s, len );
+        const bool     heapless = !is_inline() && _data_idx == detail::kNullIdx_v<typename ManagerT::address_traits>;
+        if ( ( is_inline() || heapless ) && len <= inline_capacity() )
+        {
+            std::memmove( inline_data(), s, static_cast<size_t>( len ) + 1 );
+            _length = len | kInlineFlag;
+            _hash   = h;
+            return true;
+        }
+        if ( !reserve( len ) )
             return false;
         char* data = resolve_data();
         if ( data == nullptr )
             return false;
-        std::memcpy( data, s, static_cast<size_t>( len ) + 1 );
+        std::memmove( data, s, static_cast<size_t>( len ) + 1 );
         _length = len;
+        _hash   = h;
         return true;
     }
     bool append( const char* s ) noexcept
@@ -58,20 +79,43 @@ template <typename ManagerT> struct pstring
         auto add_len = static_cast<uint32_t>( std::strlen( s ) );
         if ( add_len == 0 )
             return true;
-        uint32_t new_len = _length + add_len;
-        if ( new_len < _length )
+        const uint32_t old_len = static_cast<uint32_t>( size() );
+        uint32_t       new_len = old_len + add_len;
+        if ( new_len < old_len || new_len >= kInlineFlag )
             return false;
-        if ( !ensure_capacity( new_len ) )
+        const uint32_t h = detail::str_hash( s, add_len, _hash );
+        if ( is_inline() && new_len <= inline_capacity() )
+        {
+            std::memmove( inline_data() + old_len, s, static_cast<size_t>( add_len ) + 1 );
+            _length = new_len | kInlineFlag;
+            _hash   = h;
+            return true;
+        }
+        char saved[sizeof( pstring )];
+        if ( is_inline() && s >= inline_data() && s < inline_data() + inline_capacity() + 1 )
+        {
+            std::memcpy( saved, s, static_cast<size_t>( add_len ) + 1 );
+            s = saved;
+        }
+        if ( !reserve( new_len ) )
             return false;
         char* data = resolve_data();
         if ( data == nullptr )
             return false;
-        std::memcpy( data + _length, s, static_cast<size_t>( add_len ) + 1 );
+        std::memcpy( data + old_len, s, static_cast<size_t>( add_len ) + 1 );
         _length = new_len;
+        _hash   = h;
         return true;
     }
     void clear() noexcept
     {
+        _hash = detail::kStrHashSeed;
+        if ( is_inline() )
+        {
+            _length          = kInlineFlag;
+            inline_data()[0] = '\0';
+            return;
+        }
         _length = 0;
         if ( _data_idx != detail::kNullIdx_v<typename ManagerT::address_traits> )
         {
@@ -82,36 +126,64 @@ template <typename ManagerT> struct pstring
     }
     void free_data() noexcept
     {
-        if ( _data_idx != detail::kNullIdx_v<typename ManagerT::address_traits> )
-        {
+        if ( !is_inline() && _data_idx != detail::kNullIdx_v<typename ManagerT::address_traits> )
             ManagerT::template deallocate_typed<char>( pmm::pptr<char, ManagerT>( _data_idx ) );
-            _data_idx = detail::kNullIdx_v<typename ManagerT::address_traits>;
-        }
+        _data_idx = detail::kNullIdx_v<typename ManagerT::address_traits>;
         _length   = 0;
         _capacity = 0;
+        _hash     = detail::kStrHashSeed;
     }
     bool operator==( const char* s ) const noexcept
     {
         if ( s == nullptr )
-            return _length == 0;
-        return std::strcmp( c_str(), s ) == 0;
+            return empty();
+        const size_t len = std::strlen( s );
+        return len == size() && std::memcmp( c_str(), s, len ) == 0;
     }
     bool operator!=( const char* s ) const noexcept { return !( *this == s ); }
     bool operator==( const pstring& other ) const noexcept
     {
         if ( this == &other )
             return true;
-        if ( _length != other._length )
+        if ( size() != other.size() || _hash != other._hash )
             return false;
-        if ( _length == 0 )
+        if ( empty() )
             return true;
-        return std::strcmp( c_str(), other.c_str() ) == 0;
+        return std::memcmp( c_str(), other.c_str(), size() ) == 0;
     }
     bool operator!=( const pstring& other ) const noexcept { return !( *this == other ); }
-    bool operator<( const pstring& other ) const noexcept { return std::strcmp( c_str(), other.c_str() ) < 0; }
+    bool operator<( const pstring& other ) const noexcept
+    {
+        return detail::str_compare( c_str(), size(), other.c_str(), other.size() ) < 0;
+    }
 
   private:
+    char*       inline_data() noexcept { return reinterpret_cast<char*>( this ) + offsetof( pstring, _capacity ); }
+    const char* inline_data() const noexcept
+    {
+        return reinterpret_cast<const char*>( this ) + offsetof( pstring, _capacity );
+    }
     char* resolve_data() const noexcept { return pmm::pptr<char, ManagerT>( _data_idx ).resolve_unchecked(); }
+    bool  reserve( uint32_t required ) noexcept
+    {
+        if ( !is_inline() )
+            return ensure_capacity( required );
+        char         saved[sizeof( pstring )];
+        const size_t len = size();
+        std::memcpy( saved, inline_data(), len + 1 );
+        _length   = 0;
+        _capacity = 0;
+        _data_idx = detail::kNullIdx_v<typename ManagerT::address_traits>;
+        if ( !ensure_capacity( required ) )
+        {
+            std::memcpy( inline_data(), saved, len + 1 );
+            _length = static_cast<uint32_t>( len ) | kInlineFlag;
+            return false;
+        }
+        std::memcpy( resolve_data(), saved, len + 1 );
+        _length = static_cast<uint32_t>( len );
+        return true;
+    }
     bool  ensure_capacity( uint32_t required ) noexcept
     {
         if ( required <= _capacity )
@@ -45,15 +45,17 @@ template <typename ManagerT> struct pstringview
         {
             node_type* lhs_obj = resolve_node( lhs );
             node_type* rhs_obj = resolve_node( rhs );
-            return lhs_obj != nullptr && rhs_obj != nullptr && std::strcmp( lhs_obj->c_str(), rhs_obj->c_str() ) < 0;
+            return lhs_obj != nullptr && rhs_obj != nullptr && *lhs_obj < *rhs_obj;
         }
         static bool validate_node( node_pptr p ) noexcept { return resolve_node( p ) != nullptr; }
     };
     using forest_domain_policy = detail::ForestDomainOps<forest_domain_descriptor>;
     static forest_domain_policy forest_domain_ops() noexcept { return forest_domain_policy{}; }
     uint32_t                    length;
+    uint32_t                    hash;
     char                        str[1];
-    explicit pstringview( const char* s ) noexcept : length( 0 ), str{ '\0' } { _interned = _intern( s ); }
+    psview_pptr                 _interned;
+    explicit pstringview( const char* s ) noexcept : length( 0 ), hash( 0 ), str{ '\0' } { _interned = _intern( s ); }
     operator psview_pptr() const noexcept { return _interned; }
     const char* c_str() const noexcept { return str; }
     size_t      size() const noexcept { return static_cast<size_t>( length ); }
@@ -62,19 +64,23 @@ template <typename ManagerT> struct pstringview
     {
         if ( s == nullptr )
             return length == 0;
-        return std::strcmp( c_str(), s ) == 0;
+        const size_t len = std::strlen( s );
+        return len == length && std::memcmp( str, s, len ) == 0;
     }
     bool operator==( const pstringview& other ) const noexcept
     {
         if ( this == &other )
             return true;
-        if ( length != other.length )
+        if ( length != other.length || hash != other.hash )
             return false;
-        return std::strcmp( str, other.str ) == 0;
+        return std::memcmp( str, other.str, length ) == 0;
     }
     bool operator!=( const char* s ) const noexcept { return !( *this == s ); }
     bool operator!=( const pstringview& other ) const noexcept { return !( *this == other ); }
-    bool operator<( const pstringview& other ) const noexcept { return std::strcmp( c_str(), other.c_str() ) < 0; }
+    bool operator<( const pstringview& other ) const noexcept
+    {
+        return detail::str_compare( str, length, other.str, other.length ) < 0;
+    }
 /*
 ### pmm-pstringview-intern
 */
@@ -85,6 +91,7 @@ template <typename ManagerT> struct pstringview
             return;
         typename ManagerT::thread_policy::unique_lock_type lock( ManagerT::_mutex );
         forest_domain_ops().reset_root();
+        ManagerT::drop_symbol_index_unlocked();
     }
     static index_type root_index() noexcept
     {
@@ -96,7 +103,6 @@ template <typename ManagerT> struct pstringview
     ~pstringview() = default;
 
   private:
-    psview_pptr        _interned;
     static psview_pptr _intern( const char* s ) noexcept
     {
         if ( !ManagerT::is_initialized() )
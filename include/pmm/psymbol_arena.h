@@ -0,0 +1,291 @@
+#pragma once
+#include "pmm/forest_registry.h"
+#include "pmm/pmap.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+namespace pmm
+{
+struct psymbol
+{
+    uint64_t offset = 0;
+    bool     is_null() const noexcept { return offset == 0; }
+    bool     operator==( const psymbol& other ) const noexcept { return offset == other.offset; }
+    bool     operator!=( const psymbol& other ) const noexcept { return offset != other.offset; }
+};
+template <typename IndexT> struct psymbol_arena_header
+{
+    uint64_t count;
+    uint64_t bytes_used;
+    uint64_t page_count;
+    uint64_t index_capacity;
+    IndexT   first_page;
+    IndexT   last_page;
+    IndexT   index;
+};
+template <typename IndexT> struct psymbol_page
+{
+    IndexT   next;
+    uint32_t used;
+    uint32_t capacity;
+};
+struct psymbol_entry
+{
+    uint32_t length;
+    uint32_t hash;
+};
+struct psymbol_slot
+{
+    uint64_t offset;
+    uint32_t hash;
+    uint32_t length;
+};
+template <typename ManagerT, size_t PageBytes = 16384>
+/*
+## pmm-psymbol_arena
+req: feat-003, fr-007, fr-008, fr-029, ur-003, dr-007
+*/
+class psymbol_arena : public detail::pmap_domain_binding<ManagerT>
+{
+    using binding_type = detail::pmap_domain_binding<ManagerT>;
+
+  public:
+    using manager_type                   = ManagerT;
+    using index_type                     = typename ManagerT::index_type;
+    using header_type                    = psymbol_arena_header<index_type>;
+    using page_type                      = psymbol_page<index_type>;
+    static constexpr size_t page_payload = PageBytes;
+    static_assert( PageBytes >= 64 && PageBytes < ( size_t{ 1 } << 31 ), "psymbol_arena: unsupported page size" );
+    psymbol_arena() noexcept { bind( nullptr ); }
+    explicit psymbol_arena( const char* domain_key ) noexcept { bind( domain_key ); }
+    psymbol_arena( const psymbol_arena& )            = delete;
+    psymbol_arena& operator=( const psymbol_arena& ) = delete;
+    using binding_type::root_index;
+    size_t size() const noexcept
+    {
+        const header_type* h = header();
+        return h == nullptr ? 0 : static_cast<size_t>( h->count );
+    }
+    size_t page_count() const noexcept
+    {
+        const header_type* h = header();
+        return h == nullptr ? 0 : static_cast<size_t>( h->page_count );
+    }
+    size_t bytes_used() const noexcept
+    {
+        const header_type* h = header();
+        return h == nullptr ? 0 : static_cast<size_t>( h->bytes_used );
+    }
+/*
+### pmm-psymbol_arena-intern
+*/
+    psymbol intern( const char* s ) noexcept
+    {
+        if ( s == nullptr )
+            s = "";
+        const size_t len = std::strlen( s );
+        if ( len > PageBytes * 64 )
+            return psymbol{};
+        const uint32_t hash = detail::symbol_hash( s, len );
+        header_type*   h    = ensure_header();
+        if ( h == nullptr )
+            return psymbol{};
+        if ( psymbol found = lookup( h, s, len, hash ); !found.is_null() )
+            return found;
+        if ( ( h->count + 1 ) * 2 > h->index_capacity &&
+             !grow_index( h->index_capacity == 0 ? detail::kSymbolIndexMinCapacity : h->index_capacity * 2 ) )
+            return psymbol{};
+        const uint32_t need = entry_bytes( len );
+        h                   = header();
+        page_type* page     = resolve<page_type>( h->last_page );
+        if ( page == nullptr || page->capacity - page->used < need )
+        {
+            if ( !add_page( need ) )
+                return psymbol{};
+            h    = header();
+            page = resolve<page_type>( h->last_page );
+        }
+        uint8_t*      at = reinterpret_cast<uint8_t*>( page + 1 ) + page->used;
+        psymbol_entry e{ static_cast<uint32_t>( len ), hash };
+        std::memcpy( at, &e, sizeof( e ) );
+        std::memcpy( at + sizeof( e ), s, len + 1 );
+        psymbol sym{ static_cast<uint64_t>( h->last_page ) * ManagerT::address_traits::granule_size +
+                     sizeof( page_type ) + page->used };
+        page->used += need;
+        h->bytes_used += need;
+        ++h->count;
+        place( slots_at( h->index ), h->index_capacity, psymbol_slot{ sym.offset, hash, static_cast<uint32_t>( len ) } );
+        return sym;
+    }
+    psymbol find( const char* s ) const noexcept
+    {
+        if ( s == nullptr )
+            s = "";
+        const size_t len = std::strlen( s );
+        return lookup( header(), s, len, detail::symbol_hash( s, len ) );
+    }
+    static const char* c_str( psymbol sym ) noexcept
+    {
+        const uint8_t* e = entry_at( sym );
+        return e == nullptr ? "" : reinterpret_cast<const char*>( e + sizeof( psymbol_entry ) );
+    }
+    static size_t length( psymbol sym ) noexcept
+    {
+        const uint8_t* e = entry_at( sym );
+        if ( e == nullptr )
+            return 0;
+        psymbol_entry entry;
+        std::memcpy( &entry, e, sizeof( entry ) );
+        return entry.length;
+    }
+/*
+### pmm-psymbol_arena-clear
+*/
+    void clear() noexcept
+    {
+        index_type*        root = root_slot();
+        const header_type* h    = header();
+        if ( root == nullptr || h == nullptr )
+            return;
+        const header_type old  = *h;
+        const index_type  self = *root;
+        *root                  = static_cast<index_type>( 0 );
+        index_type page        = old.first_page;
+        for ( uint64_t i = 0; i < old.page_count && page != static_cast<index_type>( 0 ); ++i )
+        {
+            const page_type* p    = resolve<page_type>( page );
+            index_type       next = p == nullptr ? static_cast<index_type>( 0 ) : p->next;
+            ManagerT::template deallocate_typed<uint8_t>( typename ManagerT::template pptr<uint8_t>( page ) );
+            page = next;
+        }
+        if ( old.index != static_cast<index_type>( 0 ) )
+            ManagerT::template deallocate_typed<psymbol_slot>(
+                typename ManagerT::template pptr<psymbol_slot>( old.index ) );
+        ManagerT::template deallocate_typed<header_type>( typename ManagerT::template pptr<header_type>( self ) );
+    }
+    template <typename FnT> void for_each( FnT&& fn ) const
+    {
+        const header_type* h = header();
+        for ( index_type p = h == nullptr ? static_cast<index_type>( 0 ) : h->first_page;
+              p != static_cast<index_type>( 0 ); p = resolve<page_type>( p )->next )
+        {
+            const page_type* page = resolve<page_type>( p );
+            const uint8_t*   base = reinterpret_cast<const uint8_t*>( page + 1 );
+            for ( uint32_t pos = 0; pos < page->used; )
+            {
+                psymbol_entry e;
+                std::memcpy( &e, base + pos, sizeof( e ) );
+                const uint64_t off =
+                    static_cast<uint64_t>( p ) * ManagerT::address_traits::granule_size + sizeof( page_type ) + pos;
+                fn( psymbol{ off }, reinterpret_cast<const char*>( base + pos + sizeof( e ) ), size_t{ e.length } );
+                pos += entry_bytes( e.length );
+            }
+        }
+    }
+
+  private:
+    using binding_type::root_slot;
+    void bind( const char* domain_key ) noexcept
+    {
+        constexpr uint32_t kTypeHash = detail::pmap_fnv1a( 0x73796d62u, detail::pmap_type_fp<char>(), 4 );
+        this->bind_domain( kTypeHash, domain_key );
+    }
+    template <typename T> static T* resolve( index_type idx ) noexcept
+    {
+        return detail::pmap_resolve<T, ManagerT>( idx );
+    }
+    static psymbol_slot* slots_at( index_type idx ) noexcept { return resolve<psymbol_slot>( idx ); }
+    header_type*         header() const noexcept { return resolve<header_type>( root_index() ); }
+    static uint32_t      entry_bytes( size_t len ) noexcept
+    {
+        return static_cast<uint32_t>( ( sizeof( psymbol_entry ) + len + 1 + 3 ) & ~size_t{ 3 } );
+    }
+    static const uint8_t* entry_at( psymbol sym ) noexcept
+    {
+        constexpr uint64_t kGranule = ManagerT::address_traits::granule_size;
+        if ( sym.is_null() )
+            return nullptr;
+        const uint8_t* g = resolve<uint8_t>( static_cast<index_type>( sym.offset / kGranule ) );
+        return g == nullptr ? nullptr : g + sym.offset % kGranule;
+    }
+    header_type* ensure_header() noexcept
+    {
+        if ( header_type* h = header() )
+            return h;
+        if ( root_slot() == nullptr )
+            return nullptr;
+        auto p = ManagerT::template allocate_typed<header_type>();
+        if ( p.is_null() )
+            return nullptr;
+        header_type* h = resolve<header_type>( p.offset() );
+        std::memset( h, 0, sizeof( header_type ) );
+        *root_slot() = p.offset();
+        return h;
+    }
+    static psymbol lookup( const header_type* h, const char* s, size_t len, uint32_t hash ) noexcept
+    {
+        if ( h == nullptr || h->index_capacity == 0 )
+            return psymbol{};
+        const psymbol_slot* slots = slots_at( h->index );
+        const uint64_t      mask  = h->index_capacity - 1;
+        for ( uint64_t i = hash & mask; slots[i].offset != 0; i = ( i + 1 ) & mask )
+        {
+            if ( slots[i].hash != hash || slots[i].length != len )
+                continue;
+            const psymbol sym{ slots[i].offset };
+            if ( std::memcmp( c_str( sym ), s, len ) == 0 )
+                return sym;
+        }
+        return psymbol{};
+    }
+    static void place( psymbol_slot* slots, uint64_t capacity, const psymbol_slot& slot ) noexcept
+    {
+        uint64_t i = slot.hash & ( capacity - 1 );
+        while ( slots[i].offset != 0 )
+            i = ( i + 1 ) & ( capacity - 1 );
+        slots[i] = slot;
+    }
+    bool grow_index( uint64_t capacity ) noexcept
+    {
+        auto fresh = ManagerT::template allocate_typed<psymbol_slot>( static_cast<size_t>( capacity ) );
+        if ( fresh.is_null() )
+            return false;
+        psymbol_slot* slots = resolve<psymbol_slot>( fresh.offset() );
+        std::memset( static_cast<void*>( slots ), 0, static_cast<size_t>( capacity ) * sizeof( psymbol_slot ) );
+        header_type* h = header();
+        if ( h->index != static_cast<index_type>( 0 ) )
+        {
+            const psymbol_slot* old = slots_at( h->index );
+            for ( uint64_t i = 0; i < h->index_capacity; ++i )
+            {
+                if ( old[i].offset != 0 )
+                    place( slots, capacity, old[i] );
+            }
+            ManagerT::template deallocate_typed<psymbol_slot>(
+                typename ManagerT::template pptr<psymbol_slot>( h->index ) );
+        }
+        h->index          = fresh.offset();
+        h->index_capacity = capacity;
+        return true;
+    }
+    bool add_page( uint32_t need ) noexcept
+    {
+        const size_t payload = need > PageBytes ? need : PageBytes;
+        auto         p       = ManagerT::template allocate_typed<uint8_t>( sizeof( page_type ) + payload );
+        if ( p.is_null() )
+            return false;
+        page_type* page = resolve<page_type>( p.offset() );
+        page->next      = static_cast<index_type>( 0 );
+        page->used      = 0;
+        page->capacity  = static_cast<uint32_t>( payload );
+        header_type* h = header();
+        if ( page_type* last = resolve<page_type>( h->last_page ) )
+            last->next = p.offset();
+        else
+            h->first_page = p.offset();
+        h->last_page = p.offset();
+        ++h->page_count;
+        return true;
+    }
+};
+}
@@ -4,6 +4,7 @@
 #include "pmm/pptr.h"
 #include "pmm/typed_guard.h"
 #include "pmm/types.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -36,13 +37,14 @@ template <typename ManagerT> class PersistMemoryTypedApi
         if ( user_off < kHdrBytes )
             return;
         void* blk_raw = base + user_off - kHdrBytes;
+        ManagerT::touch_range_unlocked( user_off - kHdrBytes, user_off );
         BlockStateBase<address_traits>::set_node_type_of( blk_raw, pmm::node_type_for_v<T> );
     }
     template <typename T> static pmm::pptr<T, ManagerT> allocate_typed() noexcept
     {
         using thread_policy = typename ManagerT::thread_policy;
         typename thread_policy::unique_lock_type lock( ManagerT::_mutex );
-        void*                                    raw = ManagerT::allocate_unlocked( sizeof( T ) );
+        void* raw = ManagerT::scope_track_unlocked( ManagerT::allocate_unlocked( sizeof( T ) ) );
         if ( raw == nullptr )
             return pmm::pptr<T, ManagerT>();
         assign_node_type_for<T>( raw );
@@ -56,12 +58,81 @@ template <typename ManagerT> class PersistMemoryTypedApi
             return pmm::pptr<T, ManagerT>();
         using thread_policy = typename ManagerT::thread_policy;
         typename thread_policy::unique_lock_type lock( ManagerT::_mutex );
-        void*                                    raw = ManagerT::allocate_unlocked( sizeof( T ) * count );
+        void* raw = ManagerT::scope_track_unlocked( ManagerT::allocate_unlocked( sizeof( T ) * count ) );
         if ( raw == nullptr )
             return pmm::pptr<T, ManagerT>();
         assign_node_type_for<T>( raw );
         return ManagerT::template make_pptr_from_raw<T>( raw );
     }
+/*
+#### pmm-detail-persistmemorytypedapi-allocate_typed_batch
+*/
+    template <typename T> static bool allocate_typed_batch( size_t count, pmm::pptr<T, ManagerT>* out ) noexcept
+    {
+        using address_traits  = typename ManagerT::address_traits;
+        using free_block_tree = typename ManagerT::free_block_tree;
+        using index_type      = typename ManagerT::index_type;
+        using thread_policy   = typename ManagerT::thread_policy;
+        if ( count == 0 || out == nullptr )
+            return false;
+        typename thread_policy::unique_lock_type lock( ManagerT::_mutex );
+        if ( !ManagerT::_initialized )
+        {
+            ManagerT::_last_error = PmmError::NotInitialized;
+            return false;
+        }
+        auto checked = pmm::detail::bytes_to_granules_checked<address_traits>( sizeof( T ) );
+        if ( !checked.has_value() || checked->value == 0 )
+        {
+            ManagerT::_last_error = PmmError::InvalidSize;
+            return false;
+        }
+        if ( !ManagerT::scope_reserve_unlocked( count ) )
+        {
+            ManagerT::_last_error = PmmError::OutOfMemory;
+            return false;
+        }
+        const index_type data_gran = checked->value;
+        const size_t     node_gran = static_cast<size_t>( ManagerT::kBlockHdrGranules ) + data_gran;
+        size_t           done      = 0;
+        if ( count <= static_cast<size_t>( std::numeric_limits<index_type>::max() ) / node_gran )
+        {
+            const index_type                       run  = static_cast<index_type>( node_gran * count );
+            uint8_t*                               base = ManagerT::_backend.base_ptr();
+            detail::ManagerHeader<address_traits>* hdr  = ManagerT::get_header( base );
+            index_type                             idx  = free_block_tree::find_best_fit( base, hdr, run );
+            if ( idx == address_traits::no_block && ManagerT::do_expand( run - ManagerT::kBlockHdrGranules ) )
+            {
+                base = ManagerT::_backend.base_ptr();
+                hdr  = ManagerT::get_header( base );
+                idx  = free_block_tree::find_best_fit( base, hdr, run );
+            }
+            for ( ; idx != address_traits::no_block && done < count;
+                  ++done, idx = static_cast<index_type>( idx + node_gran ) )
+            {
+                void* raw = ManagerT::allocate_from_block_unlocked( idx, data_gran );
+                assign_node_type_for<T>( raw );
+                out[done] = ManagerT::template make_pptr_from_raw<T>( raw );
+            }
+        }
+        for ( ; done < count; ++done )
+        {
+            void* raw = ManagerT::allocate_unlocked( sizeof( T ) );
+            if ( raw == nullptr )
+            {
+                while ( done > 0 )
+                    ManagerT::deallocate_unlocked( ManagerT::template raw_block_user_ptr_from_pptr<T>( out[--done] ) );
+                ManagerT::_last_error = PmmError::OutOfMemory;
+                return false;
+            }
+            assign_node_type_for<T>( raw );
+            out[done] = ManagerT::template make_pptr_from_raw<T>( raw );
+        }
+        for ( done = 0; done < count; ++done )
+            (void)ManagerT::scope_track_unlocked( ManagerT::template raw_block_user_ptr_from_pptr<T>( out[done] ) );
+        ManagerT::_last_error = PmmError::Ok;
+        return true;
+    }
     template <typename T> static void deallocate_typed( pmm::pptr<T, ManagerT> p ) noexcept
     {
         if ( p.is_null() || !ManagerT::_initialized )
@@ -133,6 +204,7 @@ template <typename ManagerT> class PersistMemoryTypedApi
         }
         static constexpr bool kBlockAligned = ( sizeof( Block<address_traits> ) % address_traits::granule_size == 0 );
         detail::ArenaView<address_traits> arena{ base, hdr };
+        ManagerT::touch_block_unlocked( blk_idx, std::max( old_data_gran, new_data_gran ) );
         if constexpr ( kBlockAligned )
         {
             if ( new_data_gran < old_data_gran )
@@ -170,8 +242,8 @@ template <typename ManagerT> class PersistMemoryTypedApi
                 return pmm::pptr<T, ManagerT>();
             }
         }
-        detail::ArenaView<address_traits> arena_after{ base, hdr };
-        void* new_raw = allocator::allocate_from_block( arena_after, new_idx, new_data_gran );
+        void* new_raw =
+            ManagerT::scope_track_unlocked( ManagerT::allocate_from_block_unlocked( new_idx, new_data_gran ) );
         if ( new_raw == nullptr )
         {
             ManagerT::_last_error = PmmError::OutOfMemory;
@@ -188,21 +260,8 @@ template <typename ManagerT> class PersistMemoryTypedApi
         void*  old_src = resolve_unchecked<T>( p );
         size_t copy_sz = ( new_count < old_count ? new_count : old_count ) * sizeof( T );
         std::memmove( new_dst, old_src, copy_sz );
-        void*               old_blk_raw = detail::block_at<address_traits>( base, blk_idx );
-        index_type          freed_w     = BlockStateBase<address_traits>::get_weight( old_blk_raw );
-        const pmm::NodeType nt_old      = BlockStateBase<address_traits>::get_node_type( old_blk_raw );
-        if ( pmm::is_allocated( nt_old ) && pmm::can_be_deleted_from_pap( nt_old ) )
-        {
-            auto       old_alloc  = AllocatedBlock<address_traits>::cast_from_raw( old_blk_raw );
-            index_type total_gran = detail::physical_block_total_granules<address_traits>(
-                base, hdr, detail::block_at<address_traits>( base, blk_idx ) );
-            old_alloc.mark_as_free( total_gran );
-            hdr->alloc_count--;
-            hdr->free_count++;
-            if ( hdr->used_size >= freed_w )
-                hdr->used_size -= freed_w;
-            allocator::coalesce( arena_after, blk_idx );
-        }
+        if ( !ManagerT::scope_defer_free_unlocked( ManagerT::template raw_block_user_ptr_from_pptr<T>( p ) ) )
+            ManagerT::release_block_unlocked( detail::block_at<address_traits>( base, blk_idx ) );
         ManagerT::_last_error = PmmError::Ok;
         return new_p;
     }
@@ -214,7 +273,7 @@ template <typename ManagerT> class PersistMemoryTypedApi
         {
             using thread_policy = typename ManagerT::thread_policy;
             typename thread_policy::unique_lock_type lock( ManagerT::_mutex );
-            raw = ManagerT::allocate_unlocked( sizeof( T ) );
+            raw = ManagerT::scope_track_unlocked( ManagerT::allocate_unlocked( sizeof( T ) ) );
             if ( raw == nullptr )
                 return pmm::pptr<T, ManagerT>();
             assign_node_type_for<T>( raw );
@@ -249,13 +308,10 @@ template <typename ManagerT> class PersistMemoryTypedApi
     {
         if ( p.is_null() || !ManagerT::_initialized )
             return nullptr;
-        void* raw = ManagerT::template raw_user_ptr_from_pptr<T>( p );
-        if ( raw == nullptr )
-        {
-            ManagerT::_last_error = PmmError::InvalidPointer;
-            return nullptr;
-        }
         ManagerT::_last_error = PmmError::Ok;
+        void* raw             = ManagerT::template raw_user_ptr_from_pptr<T>( p );
+        if ( raw == nullptr && ManagerT::_last_error == PmmError::Ok )
+            ManagerT::_last_error = PmmError::InvalidPointer;
         return reinterpret_cast<T*>( raw );
     }
     template <typename T> static T* resolve_checked( pmm::pptr<T, ManagerT> p ) noexcept
@@ -7,6 +7,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <ostream>
 namespace pmm
@@ -93,7 +94,7 @@ struct FreeBlockView
 namespace detail
 {
 inline constexpr uint8_t kLegacyUnversionedImageVersion = 0;
-inline constexpr uint8_t kCurrentImageVersion           = 2;
+inline constexpr uint8_t kCurrentImageVersion           = 3;
 inline constexpr bool    is_supported_image_version( uint8_t image_version ) noexcept
 {
     return image_version == kCurrentImageVersion;
@@ -109,6 +110,41 @@ inline uint32_t crc32_accumulate_byte( uint32_t crc, uint8_t byte ) noexcept
         crc = ( crc >> 1 ) ^ ( 0xEDB88320U & ( ~( crc & 1U ) + 1U ) );
     return crc;
 }
+inline uint32_t crc32_matrix_times( const uint32_t* mat, uint32_t vec ) noexcept
+{
+    uint32_t sum = 0;
+    for ( ; vec != 0; vec >>= 1, ++mat )
+    {
+        if ( vec & 1U )
+            sum ^= *mat;
+    }
+    return sum;
+}
+inline void crc32_matrix_square( uint32_t* square, const uint32_t* mat ) noexcept
+{
+    for ( int n = 0; n < 32; ++n )
+        square[n] = crc32_matrix_times( mat, mat[n] );
+}
+inline uint32_t crc32_accumulate_zeros( uint32_t crc, size_t count ) noexcept
+{
+    uint32_t odd[32];
+    uint32_t even[32];
+    odd[0] = 0xEDB88320U;
+    for ( int n = 1; n < 32; ++n )
+        odd[n] = 1U << ( n - 1 );
+    crc32_matrix_square( even, odd );
+    crc32_matrix_square( odd, even );
+    crc32_matrix_square( even, odd );
+    for ( uint32_t* op = even; count != 0; count >>= 1 )
+    {
+        if ( count & 1U )
+            crc = crc32_matrix_times( op, crc );
+        uint32_t* next = op == even ? odd : even;
+        crc32_matrix_square( next, op );
+        op = next;
+    }
+    return crc;
+}
 inline uint32_t compute_crc32( const uint8_t* data, size_t length ) noexcept
 {
     uint32_t crc = 0xFFFFFFFFU;
@@ -116,6 +152,23 @@ inline uint32_t compute_crc32( const uint8_t* data, size_t length ) noexcept
         crc = crc32_accumulate_byte( crc, data[i] );
     return crc ^ 0xFFFFFFFFU;
 }
+inline constexpr uint32_t kStrHashSeed = 2166136261u;
+inline uint32_t           str_hash( const char* s, size_t len, uint32_t h = kStrHashSeed ) noexcept
+{
+    for ( size_t i = 0; i < len; ++i )
+    {
+        h ^= static_cast<uint8_t>( s[i] );
+        h *= 16777619u;
+    }
+    return h;
+}
+inline int str_compare( const char* a, size_t a_len, const char* b, size_t b_len ) noexcept
+{
+    const int c = std::memcmp( a, b, a_len < b_len ? a_len : b_len );
+    if ( c != 0 )
+        return c;
+    return a_len < b_len ? -1 : ( a_len > b_len ? 1 : 0 );
+}
 static_assert( sizeof( pmm::Block<pmm::DefaultAddressTraits> ) == 32, "" );
 static_assert( sizeof( pmm::Block<pmm::DefaultAddressTraits> ) % kGranuleSize == 0, "" );
 inline constexpr uint32_t kNoBlock = 0xFFFFFFFFU;
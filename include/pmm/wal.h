@@ -0,0 +1,254 @@
+#pragma once
+#include "pmm/diagnostics.h"
+#include "pmm/io.h"
+#include "pmm/types.h"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+namespace pmm
+{
+namespace detail
+{
+inline constexpr uint32_t kWalFileMagic       = 0x504D574CU;
+inline constexpr uint32_t kWalRecordMagic     = 0x504D5752U;
+inline constexpr size_t   kDefaultWalPageSize = 4096;
+struct WalFileHeader
+{
+    uint32_t magic;
+    uint32_t page_size;
+    uint64_t base_size;
+    uint32_t base_crc;
+    uint32_t reserved;
+};
+struct WalRecordHeader
+{
+    uint32_t magic;
+    uint32_t page_count;
+    uint64_t sequence;
+    uint64_t image_size;
+    uint64_t payload_size;
+    uint32_t payload_crc;
+    uint32_t reserved;
+};
+inline size_t wal_page_bytes( uint64_t image_size, uint64_t page, size_t page_size ) noexcept
+{
+    uint64_t begin = page * page_size;
+    return begin >= image_size ? 0 : static_cast<size_t>( std::min<uint64_t>( page_size, image_size - begin ) );
+}
+inline uint64_t wal_apply_records( std::FILE* f, uint8_t* buf, size_t capacity, size_t page_size )
+{
+    std::vector<uint8_t> payload;
+    uint64_t             expected_seq = 1;
+    WalRecordHeader      rh{};
+    long                 pos0 = std::ftell( f );
+    long file_size = pos0 >= 0 && std::fseek( f, 0, SEEK_END ) == 0 ? std::ftell( f ) : -1;
+    if ( file_size < 0 || std::fseek( f, pos0, SEEK_SET ) != 0 )
+        return 0;
+    uint64_t remaining = static_cast<uint64_t>( file_size - pos0 );
+    while ( remaining >= sizeof( rh ) && std::fread( &rh, sizeof( rh ), 1, f ) == 1 )
+    {
+        remaining -= sizeof( rh );
+        if ( rh.magic != kWalRecordMagic || rh.sequence != expected_seq || rh.image_size > capacity ||
+             rh.payload_size > remaining || rh.page_count > ( rh.image_size + page_size - 1 ) / page_size ||
+             rh.payload_size > static_cast<uint64_t>( rh.page_count ) * ( sizeof( uint64_t ) + page_size ) )
+            break;
+        remaining -= rh.payload_size;
+        payload.resize( static_cast<size_t>( rh.payload_size ) );
+        if ( std::fread( payload.data(), 1, payload.size(), f ) != payload.size() ||
+             compute_crc32( payload.data(), payload.size() ) != rh.payload_crc )
+            break;
+        size_t pos = 0;
+        bool   ok  = true;
+        for ( uint32_t i = 0; i < rh.page_count && ok; ++i )
+        {
+            uint64_t page = 0;
+            ok            = pos + sizeof( page ) <= payload.size();
+            if ( !ok )
+                break;
+            std::memcpy( &page, payload.data() + pos, sizeof( page ) );
+            pos += sizeof( page );
+            size_t bytes = wal_page_bytes( rh.image_size, page, page_size );
+            ok           = bytes != 0 && pos + bytes <= payload.size();
+            if ( ok )
+                pos += bytes;
+        }
+        if ( !ok || pos != payload.size() )
+            break;
+        for ( pos = 0; pos < payload.size(); )
+        {
+            uint64_t page = 0;
+            std::memcpy( &page, payload.data() + pos, sizeof( page ) );
+            pos += sizeof( page );
+            size_t bytes = wal_page_bytes( rh.image_size, page, page_size );
+            std::memcpy( buf + page * page_size, payload.data() + pos, bytes );
+            pos += bytes;
+        }
+        ++expected_seq;
+    }
+    return expected_seq - 1;
+}
+}
+template <typename MgrT>
+/*
+## pmm-writeaheadlog
+req: feat-004, fr-014, fr-024, qa-rec-001
+*/
+class WriteAheadLog
+{
+  public:
+    using address_traits = typename MgrT::address_traits;
+    explicit WriteAheadLog( size_t page_size = detail::kDefaultWalPageSize ) noexcept : _page_size( page_size ) {}
+    WriteAheadLog( const WriteAheadLog& )            = delete;
+    WriteAheadLog& operator=( const WriteAheadLog& ) = delete;
+    ~WriteAheadLog() { close(); }
+    bool open( const char* image_path, const char* log_path )
+    {
+        close();
+        if ( image_path == nullptr || log_path == nullptr || !std::has_single_bit( _page_size ) )
+            return false;
+        _image_path = image_path;
+        _log_path   = log_path;
+        return checkpoint();
+    }
+    bool checkpoint()
+    {
+        if ( _image_path.empty() )
+            return false;
+        std::vector<uint8_t> snapshot;
+        if ( !detail::with_shared_image<MgrT>(
+                 [&]( const uint8_t* data, size_t total )
+                 {
+                     snapshot.assign( data, data + total );
+                     return true;
+                 } ) )
+            return false;
+        _page_crc.resize( ( snapshot.size() + _page_size - 1 ) / _page_size );
+        for ( size_t page = 0; page < _page_crc.size(); ++page )
+            _page_crc[page] = detail::compute_crc32( snapshot.data() + page * _page_size,
+                                                     detail::wal_page_bytes( snapshot.size(), page, _page_size ) );
+        auto* hdr  = detail::manager_header_at<address_traits>( snapshot.data() );
+        hdr->crc32 = detail::compute_image_crc32<address_traits>( snapshot.data(), snapshot.size() );
+        detail::WalFileHeader fh{};
+        fh.magic     = detail::kWalFileMagic;
+        fh.page_size = static_cast<uint32_t>( _page_size );
+        fh.base_size = snapshot.size();
+        fh.base_crc  = hdr->crc32;
+        bool ok      = detail::write_file_atomic( _image_path.c_str(), snapshot.data(), snapshot.size() );
+        if ( _log != nullptr )
+            std::fclose( _log );
+        _log      = nullptr;
+        _sequence = 0;
+        if ( !ok )
+            return false;
+        ok = detail::write_file_atomic( _log_path.c_str(), reinterpret_cast<const uint8_t*>( &fh ), sizeof( fh ) );
+        if ( ok )
+            _log = std::fopen( _log_path.c_str(), "ab" );
+        return _log != nullptr;
+    }
+    bool commit()
+    {
+        if ( _log == nullptr )
+            return false;
+        uint32_t dirty = 0;
+        uint64_t image = 0;
+        _record.assign( sizeof( detail::WalRecordHeader ), 0 );
+        if ( !detail::with_shared_image<MgrT>(
+                 [&]( const uint8_t* data, size_t total )
+                 {
+                     const size_t pages = ( total + _page_size - 1 ) / _page_size;
+                     _page_crc.resize( pages, 0 );
+                     for ( size_t page = 0; page < pages; ++page )
+                     {
+                         const uint8_t* src   = data + page * _page_size;
+                         const size_t   bytes = detail::wal_page_bytes( total, page, _page_size );
+                         const uint32_t crc   = detail::compute_crc32( src, bytes );
+                         if ( crc == _page_crc[page] )
+                             continue;
+                         _page_crc[page]        = crc;
+                         uint64_t       page_id = page;
+                         const uint8_t* id      = reinterpret_cast<const uint8_t*>( &page_id );
+                         _record.insert( _record.end(), id, id + sizeof( page_id ) );
+                         _record.insert( _record.end(), src, src + bytes );
+                         ++dirty;
+                     }
+                     image = total;
+                     return true;
+                 } ) )
+            return false;
+        if ( dirty == 0 )
+            return true;
+        detail::WalRecordHeader rh{};
+        rh.magic        = detail::kWalRecordMagic;
+        rh.page_count   = dirty;
+        rh.sequence     = _sequence + 1;
+        rh.image_size   = image;
+        rh.payload_size = _record.size() - sizeof( rh );
+        rh.payload_crc  = detail::compute_crc32( _record.data() + sizeof( rh ), _record.size() - sizeof( rh ) );
+        std::memcpy( _record.data(), &rh, sizeof( rh ) );
+        if ( std::fwrite( _record.data(), 1, _record.size(), _log ) != _record.size() ||
+             !detail::flush_file_to_storage( _log ) )
+        {
+            close();
+            return false;
+        }
+        _sequence = rh.sequence;
+        return true;
+    }
+    void close() noexcept
+    {
+        if ( _log != nullptr )
+            std::fclose( _log );
+        _log = nullptr;
+    }
+    bool     is_open() const noexcept { return _log != nullptr; }
+    uint64_t sequence() const noexcept { return _sequence; }
+    size_t   page_size() const noexcept { return _page_size; }
+
+  private:
+    size_t                _page_size;
+    uint64_t              _sequence = 0;
+    std::FILE*            _log      = nullptr;
+    std::string           _image_path;
+    std::string           _log_path;
+    std::vector<uint32_t> _page_crc;
+    std::vector<uint8_t>  _record;
+};
+template <typename MgrT>
+inline bool recover_manager_from_wal( const char* image_path, const char* log_path, VerifyResult& result )
+{
+    using address_traits = typename MgrT::address_traits;
+    if ( image_path == nullptr || log_path == nullptr )
+        return false;
+    uint8_t* buf  = MgrT::backend().base_ptr();
+    size_t   size = MgrT::backend().total_size();
+    if ( buf == nullptr || size < detail::kMinMemorySize )
+        return false;
+    size_t image_size = 0;
+    if ( !detail::read_file_into( image_path, buf, size, image_size ) ||
+         image_size < detail::manager_header_offset_bytes_v<address_traits> +
+                          sizeof( detail::ManagerHeader<address_traits> ) )
+        return false;
+    uint32_t stored_crc = detail::manager_header_at<address_traits>( buf )->crc32;
+    if ( stored_crc != detail::compute_image_crc32<address_traits>( buf, image_size ) )
+    {
+        MgrT::set_last_error( PmmError::CrcMismatch );
+        MgrT::logging_policy::on_corruption_detected( PmmError::CrcMismatch );
+        return false;
+    }
+    std::FILE* f = std::fopen( log_path, "rb" );
+    if ( f != nullptr )
+    {
+        detail::WalFileHeader fh{};
+        if ( std::fread( &fh, sizeof( fh ), 1, f ) == 1 && fh.magic == detail::kWalFileMagic &&
+             std::has_single_bit( fh.page_size ) && fh.base_size == image_size && fh.base_crc == stored_crc )
+            (void)detail::wal_apply_records( f, buf, size, fh.page_size );
+        std::fclose( f );
+    }
+    return MgrT::load( result );
+}
+}
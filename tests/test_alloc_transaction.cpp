@@ -0,0 +1,242 @@
+/**
+ * @file test_alloc_transaction.cpp
+ * @brief Tests for alloc_transaction<ManagerT>: allocation scopes with commit/rollback.
+ *
+ * Verifies:
+ *  - rollback() (and scope exit without commit) frees every allocation made in the scope
+ *  - rollback() runs container cleanup through typed_guard (pstring/parray buffers are freed)
+ *  - deferred frees and root changes are applied only on commit()
+ *  - commit() publishes several domain roots at once and fails without side effects on a bad domain
+ *  - adopt() takes ownership of a typed_guard created before the scope
+ *  - rollback() frees container nodes allocated inside the scope and restores the roots it changed
+ *  - rollback() after the image grew leaves a consistent, larger image
+ *  - a nested scope that commits hands its changes to the outer scope
+ *  - scopes on different threads record and roll back only their own changes
+ */
+
+#include "pmm/alloc_transaction.h"
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using TxMgr     = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 2801>;
+using TxConcMgr = pmm::PersistMemoryManager<pmm::PersistentDataConfig, 2802>;
+
+TEST_CASE( "alloc_transaction rollback frees scope allocations", "[test_alloc_transaction]" )
+{
+    REQUIRE( TxMgr::create( 64 * 1024 ) );
+    std::size_t allocs = TxMgr::alloc_block_count();
+    std::size_t used   = TxMgr::used_size();
+    {
+        pmm::alloc_transaction<TxMgr> tx;
+        TxMgr::pptr<int>              a = tx.allocate_typed<int>( 16 );
+        TxMgr::pptr<TxMgr::pstring>   s = tx.create_typed<TxMgr::pstring>();
+        REQUIRE( !a.is_null() );
+        REQUIRE( !s.is_null() );
+        REQUIRE( s->assign( "a string long enough to own a heap buffer" ) );
+        REQUIRE( tx.pending_allocations() == 3 );
+        REQUIRE( TxMgr::alloc_block_count() > allocs );
+    }
+    REQUIRE( TxMgr::alloc_block_count() == allocs );
+    REQUIRE( TxMgr::used_size() == used );
+    TxMgr::destroy();
+}
+
+TEST_CASE( "alloc_transaction commit keeps allocations and applies deferred frees", "[test_alloc_transaction]" )
+{
+    REQUIRE( TxMgr::create( 64 * 1024 ) );
+    TxMgr::pptr<int> old_node = TxMgr::create_typed<int>( 1 );
+    std::size_t      allocs   = TxMgr::alloc_block_count();
+
+    pmm::alloc_transaction<TxMgr> tx;
+    TxMgr::pptr<int>              fresh = tx.create_typed<int>( 2 );
+    tx.destroy_typed( old_node );
+    REQUIRE( TxMgr::alloc_block_count() == allocs + 1 );
+    REQUIRE( tx.commit() );
+    REQUIRE( tx.empty() );
+    REQUIRE( TxMgr::alloc_block_count() == allocs );
+    REQUIRE( *fresh == 2 );
+    TxMgr::destroy();
+}
+
+TEST_CASE( "alloc_transaction rollback discards deferred frees and root changes", "[test_alloc_transaction]" )
+{
+    REQUIRE( TxMgr::create( 64 * 1024 ) );
+    REQUIRE( TxMgr::register_domain( "app/index" ) );
+    TxMgr::pptr<int> keep = TxMgr::create_typed<int>( 7 );
+    TxMgr::set_domain_root( "app/index", keep );
+    std::size_t allocs = TxMgr::alloc_block_count();
+    {
+        pmm::alloc_transaction<TxMgr> tx;
+        TxMgr::pptr<int>              next = tx.create_typed<int>( 8 );
+        REQUIRE( tx.set_domain_root( "app/index", next ) );
+        tx.destroy_typed( keep );
+        tx.rollback();
+        REQUIRE( tx.empty() );
+    }
+    REQUIRE( TxMgr::alloc_block_count() == allocs );
+    REQUIRE( TxMgr::get_domain_root<int>( "app/index" ) == keep );
+    REQUIRE( *keep == 7 );
+    TxMgr::destroy();
+}
+
+TEST_CASE( "alloc_transaction commit publishes several roots at once", "[test_alloc_transaction]" )
+{
+    REQUIRE( TxMgr::create( 64 * 1024 ) );
+    REQUIRE( TxMgr::register_domain( "app/a" ) );
+    REQUIRE( TxMgr::register_domain( "app/b" ) );
+
+    pmm::alloc_transaction<TxMgr> tx;
+    TxMgr::pptr<int>              a = tx.create_typed<int>( 1 );
+    TxMgr::pptr<int>              b = tx.create_typed<int>( 2 );
+    REQUIRE( tx.set_domain_root( "app/a", a ) );
+    REQUIRE( tx.set_domain_root( "app/b", b ) );
+    REQUIRE( tx.set_root( b ) );
+    REQUIRE( tx.set_domain_root( "app/a", b ) );
+    REQUIRE( tx.pending_roots() == 3 );
+    REQUIRE( TxMgr::get_domain_root<int>( "app/a" ).is_null() );
+    REQUIRE( tx.commit() );
+    REQUIRE( TxMgr::get_domain_root<int>( "app/a" ) == b );
+    REQUIRE( TxMgr::get_domain_root<int>( "app/b" ) == b );
+    REQUIRE( TxMgr::get_root<int>() == b );
+    TxMgr::destroy();
+}
+
+TEST_CASE( "alloc_transaction commit fails atomically on an unknown domain", "[test_alloc_transaction]" )
+{
+    REQUIRE( TxMgr::create( 64 * 1024 ) );
+    REQUIRE( TxMgr::register_domain( "app/a" ) );
+    std::size_t allocs = TxMgr::alloc_block_count();
+    {
+        pmm::alloc_transaction<TxMgr> tx;
+        TxMgr::pptr<int>              a = tx.create_typed<int>( 1 );
+        REQUIRE( tx.set_domain_root( "app/a", a ) );
+        REQUIRE( tx.set_domain_root( "app/missing", a ) );
+        REQUIRE_FALSE( tx.commit() );
+        REQUIRE( TxMgr::get_domain_root<int>( "app/a" ).is_null() );
+        REQUIRE_FALSE( tx.set_domain_root( "", a ) );
+    }
+    REQUIRE( TxMgr::alloc_block_count() == allocs );
+    TxMgr::destroy();
+}
+
+TEST_CASE( "alloc_transaction adopts typed_guard ownership", "[test_alloc_transaction]" )
+{
+    REQUIRE( TxMgr::create( 64 * 1024 ) );
+    std::size_t allocs = TxMgr::alloc_block_count();
+    auto        guard  = TxMgr::make_guard<TxMgr::parray<int>>();
+    REQUIRE( guard );
+    REQUIRE( guard->push_back( 1 ) );
+    REQUIRE( guard->push_back( 2 ) );
+    {
+        pmm::alloc_transaction<TxMgr>   tx;
+        TxMgr::pptr<TxMgr::parray<int>> arr = tx.adopt( std::move( guard ) );
+        REQUIRE( !arr.is_null() );
+        REQUIRE( !guard );
+        REQUIRE( tx.pending_allocations() == 1 );
+    }
+    REQUIRE( TxMgr::alloc_block_count() == allocs );
+    TxMgr::destroy();
+}
+
+TEST_CASE( "alloc_transaction rollback frees a container built in the scope", "[test_alloc_transaction]" )
+{
+    REQUIRE( TxMgr::create( 64 * 1024 ) );
+    TxMgr::pmap<int, int> live( "app/live" );
+    TxMgr::pmap<int, int> staged( "app/staged" );
+    REQUIRE( !live.insert( 1, 10 ).is_null() );
+    std::size_t allocs = TxMgr::alloc_block_count();
+    std::size_t used   = TxMgr::used_size();
+    {
+        pmm::alloc_transaction<TxMgr> tx;
+        REQUIRE( tx.active() );
+        for ( int i = 0; i < 64; ++i )
+            REQUIRE( !staged.insert( i, i * 10 ).is_null() );
+        REQUIRE( staged.size() == 64 );
+        REQUIRE( tx.pending_allocations() >= 64 );
+        REQUIRE( live.find( 1 )->value == 10 );
+        REQUIRE( tx.rollback() );
+        REQUIRE( staged.size() == 0 );
+    }
+    REQUIRE( TxMgr::alloc_block_count() == allocs );
+    REQUIRE( TxMgr::used_size() == used );
+    REQUIRE( TxMgr::get_domain_root_offset( "app/staged" ) == 0 );
+    REQUIRE( live.size() == 1 );
+    REQUIRE( TxMgr::verify().ok );
+    TxMgr::destroy();
+}
+
+TEST_CASE( "alloc_transaction rollback after growth keeps the larger image", "[test_alloc_transaction]" )
+{
+    REQUIRE( TxMgr::create( 64 * 1024 ) );
+    std::size_t allocs = TxMgr::alloc_block_count();
+    std::size_t total  = TxMgr::total_size();
+    {
+        pmm::alloc_transaction<TxMgr> tx;
+        REQUIRE( !tx.allocate_typed<std::uint8_t>( 256 * 1024 ).is_null() );
+        REQUIRE( TxMgr::total_size() > total );
+    }
+    REQUIRE( TxMgr::alloc_block_count() == allocs );
+    REQUIRE( TxMgr::verify().ok );
+    REQUIRE( !TxMgr::allocate_typed<std::uint8_t>( 200 * 1024 ).is_null() );
+    REQUIRE( TxMgr::verify().ok );
+    TxMgr::destroy();
+}
+
+TEST_CASE( "alloc_transaction nested scope commits into the outer scope", "[test_alloc_transaction]" )
+{
+    REQUIRE( TxMgr::create( 64 * 1024 ) );
+    REQUIRE( TxMgr::register_domain( "app/a" ) );
+    TxMgr::pptr<int> keep   = TxMgr::create_typed<int>( 1 );
+    std::size_t      allocs = TxMgr::alloc_block_count();
+    {
+        pmm::alloc_transaction<TxMgr> outer;
+        REQUIRE( !outer.create_typed<int>( 2 ).is_null() );
+        {
+            pmm::alloc_transaction<TxMgr> inner;
+            REQUIRE( inner.active() );
+            TxMgr::pptr<int> a = inner.create_typed<int>( 3 );
+            REQUIRE( inner.set_domain_root( "app/a", a ) );
+            REQUIRE( inner.destroy_typed( keep ) );
+            REQUIRE( inner.commit() );
+            REQUIRE( TxMgr::get_domain_root<int>( "app/a" ) == a );
+        }
+        REQUIRE( outer.pending_allocations() == 2 );
+        REQUIRE( TxMgr::alloc_block_count() == allocs + 2 );
+    }
+    REQUIRE( TxMgr::alloc_block_count() == allocs );
+    REQUIRE( TxMgr::get_domain_root<int>( "app/a" ).is_null() );
+    REQUIRE( *keep == 1 );
+    TxMgr::destroy();
+}
+
+TEST_CASE( "alloc_transaction scopes on different threads are independent", "[test_alloc_transaction]" )
+{
+    REQUIRE( TxConcMgr::create( 256 * 1024 ) );
+    std::size_t                       allocs    = TxConcMgr::alloc_block_count();
+    bool                              committed = false;
+    std::vector<TxConcMgr::pptr<int>> kept;
+    std::thread                       writer(
+        [&]
+        {
+            pmm::alloc_transaction<TxConcMgr> tx;
+            for ( int i = 0; i < 100; ++i )
+                kept.push_back( tx.create_typed<int>( i ) );
+            committed = tx.commit();
+        } );
+    {
+        pmm::alloc_transaction<TxConcMgr> tx;
+        for ( int i = 0; i < 100; ++i )
+            REQUIRE( !tx.create_typed<int>( -i ).is_null() );
+        REQUIRE( tx.pending_allocations() == 100 );
+    }
+    writer.join();
+    REQUIRE( committed );
+    REQUIRE( TxConcMgr::alloc_block_count() == allocs + 100 );
+    for ( int i = 0; i < 100; ++i )
+        REQUIRE( *kept[static_cast<std::size_t>( i )] == i );
+    TxConcMgr::destroy();
+}
@@ -6,10 +6,14 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <vector>
 
 using ForestMgr        = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 240>;
 using ForestPersistMgr = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 241>;
 using CanonicalRootMgr = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 313>;
+using ManyDomainsMgr   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4901>;
+using RootCacheMgr     = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4902>;
+using OldRegistryMgr   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4903>;
 
 TEST_CASE( "forest registry bootstraps system domains", "[test_forest_registry]" )
 {
@@ -176,3 +180,119 @@ TEST_CASE( "root object API is a thin view over the service/domain_root registry
 
     CanonicalRootMgr::destroy();
 }
+
+TEST_CASE( "forest registry chains pages past one page of domains", "[test_forest_registry]" )
+{
+    const char*   filename = "test_forest_registry_many.dat";
+    constexpr int kCount   = 20 * static_cast<int>( pmm::detail::kForestDomainsPerPage );
+
+    ManyDomainsMgr::destroy();
+    REQUIRE( ManyDomainsMgr::create( 256 * 1024 ) );
+    std::vector<ManyDomainsMgr::index_type> ids;
+    for ( int i = 0; i < kCount; ++i )
+    {
+        char name[pmm::detail::kForestDomainNameCapacity];
+        std::snprintf( name, sizeof( name ), "app/domain/%d", i );
+        REQUIRE( ManyDomainsMgr::register_domain( name ) );
+        auto value = ManyDomainsMgr::create_typed<int>( i );
+        REQUIRE( ManyDomainsMgr::set_domain_root( name, value ) );
+        ids.push_back( ManyDomainsMgr::find_domain_by_name( name ) );
+    }
+    REQUIRE( ManyDomainsMgr::validate_bootstrap_invariants() );
+
+    REQUIRE( pmm::save_manager<ManyDomainsMgr>( filename ) );
+    const std::size_t blocks_before = ManyDomainsMgr::block_count();
+    const std::size_t used_before   = ManyDomainsMgr::used_size();
+    ManyDomainsMgr::destroy();
+    REQUIRE( ManyDomainsMgr::create( 256 * 1024 ) );
+    {
+        pmm::VerifyResult vr_;
+        REQUIRE( pmm::load_manager_from_file<ManyDomainsMgr>( filename, vr_ ) );
+    }
+    REQUIRE( ManyDomainsMgr::block_count() == blocks_before );
+    REQUIRE( ManyDomainsMgr::used_size() == used_before );
+
+    for ( int i = 0; i < kCount; ++i )
+    {
+        char name[pmm::detail::kForestDomainNameCapacity];
+        std::snprintf( name, sizeof( name ), "app/domain/%d", i );
+        REQUIRE( ManyDomainsMgr::find_domain_by_name( name ) == ids[static_cast<size_t>( i )] );
+        auto by_name    = ManyDomainsMgr::get_domain_root<int>( name );
+        auto by_binding = ManyDomainsMgr::get_domain_root<int>( ids[static_cast<size_t>( i )] );
+        REQUIRE( !by_name.is_null() );
+        REQUIRE( by_name.offset() == by_binding.offset() );
+        REQUIRE( *by_name == i );
+    }
+    REQUIRE( !ManyDomainsMgr::has_domain( "app/domain/missing" ) );
+    REQUIRE( ManyDomainsMgr::register_domain( "app/domain/after_load" ) );
+    REQUIRE( ManyDomainsMgr::has_domain( "app/domain/after_load" ) );
+    REQUIRE( ManyDomainsMgr::validate_bootstrap_invariants() );
+
+    ManyDomainsMgr::destroy();
+    std::remove( filename );
+}
+
+TEST_CASE( "cached domain root handles follow the domain epoch", "[test_forest_registry]" )
+{
+    const char* filename = "test_forest_registry_epoch.dat";
+
+    RootCacheMgr::destroy();
+    REQUIRE( RootCacheMgr::create( 16 * 1024 ) );
+    RootCacheMgr::pmap<int, int> map( "cache/map" );
+    REQUIRE( map.insert( 0, 0 ) );
+    const std::uint64_t epoch_before = RootCacheMgr::domain_epoch();
+    for ( int i = 1; i < 2000; ++i )
+        REQUIRE( map.insert( i, i * 3 ) );
+    REQUIRE( RootCacheMgr::domain_epoch() > epoch_before );
+    REQUIRE( map.size() == 2000 );
+    for ( int i = 0; i < 2000; ++i )
+        REQUIRE( map.find( i )->value == i * 3 );
+
+    const std::uint64_t epoch_registry = RootCacheMgr::domain_epoch();
+    for ( int i = 0; i < 2 * static_cast<int>( pmm::detail::kForestDomainsPerPage ); ++i )
+    {
+        char name[pmm::detail::kForestDomainNameCapacity];
+        std::snprintf( name, sizeof( name ), "cache/extra/%d", i );
+        REQUIRE( RootCacheMgr::register_domain( name ) );
+    }
+    REQUIRE( RootCacheMgr::domain_epoch() > epoch_registry );
+    REQUIRE( map.find( 1999 )->value == 1999 * 3 );
+
+    REQUIRE( pmm::save_manager<RootCacheMgr>( filename ) );
+    const std::size_t image_size = RootCacheMgr::total_size();
+    RootCacheMgr::destroy();
+    REQUIRE( RootCacheMgr::create( image_size ) );
+    {
+        pmm::VerifyResult vr_;
+        REQUIRE( pmm::load_manager_from_file<RootCacheMgr>( filename, vr_ ) );
+    }
+    REQUIRE( map.size() == 2000 );
+    REQUIRE( map.find( 1234 )->value == 1234 * 3 );
+    REQUIRE( RootCacheMgr::pmap<int, int>( "cache/map" ).root_index() == map.root_index() );
+
+    RootCacheMgr::destroy();
+    std::remove( filename );
+}
+
+TEST_CASE( "forest registry rejects an image with an older registry version", "[test_forest_registry]" )
+{
+    OldRegistryMgr::destroy();
+    REQUIRE( OldRegistryMgr::create( 64 * 1024 ) );
+    REQUIRE( OldRegistryMgr::register_domain( "app/kept" ) );
+    OldRegistryMgr::destroy();
+
+    auto& be  = OldRegistryMgr::backend();
+    auto* hdr = pmm::detail::manager_header_at<pmm::DefaultAddressTraits>( be.base_ptr() );
+    auto* reg = reinterpret_cast<pmm::detail::ForestDomainRegistry<pmm::DefaultAddressTraits>*>(
+        be.base_ptr() + static_cast<std::size_t>( hdr->root_offset ) * pmm::DefaultAddressTraits::granule_size );
+    REQUIRE( reg->magic == pmm::detail::kForestRegistryMagic );
+    reg->version = static_cast<std::uint16_t>( pmm::detail::kForestRegistryVersion - 1 );
+    const auto root_before = hdr->root_offset;
+
+    OldRegistryMgr::clear_error();
+    pmm::VerifyResult result;
+    REQUIRE( !OldRegistryMgr::load( result ) );
+    REQUIRE( OldRegistryMgr::last_error() == pmm::PmmError::UnsupportedImageVersion );
+    REQUIRE( !OldRegistryMgr::is_initialized() );
+    REQUIRE( hdr->root_offset == root_before );
+}
@@ -0,0 +1,251 @@
+/**
+ * @file test_image_page_checksums.cpp
+ * @brief Tests for per-page image checksums rolled up into a Merkle root.
+ *
+ * Verifies:
+ *  - save_manager_paged() appends the page table to the image and stores its Merkle root in the header
+ *  - load_manager_from_file_paged() restores the image when every page matches
+ *  - a corrupted byte is reported as the exact page index instead of a whole-image mismatch
+ *  - a corrupted page table is rejected
+ *  - with an output table, payload-only pages are verified on first access instead of at load
+ *  - a repeated save picks up writes made through raw pointers kept across saves
+ *  - a lazily verifying table can be detached while another thread resolves pointers
+ */
+
+#include "pmm/io.h"
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using PageMgr     = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 2601>;
+using PageMgr2    = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 2602>;
+using PageLockMgr = pmm::PersistMemoryManager<pmm::PersistentDataConfig, 2603>;
+
+static const char* kPagedFile = "test_image_pages.dat";
+
+static void cleanup_paged_files()
+{
+    std::remove( kPagedFile );
+}
+
+static void corrupt_byte_at( const char* path, long offset )
+{
+    std::FILE* f = std::fopen( path, "r+b" );
+    REQUIRE( f != nullptr );
+    REQUIRE( std::fseek( f, offset, SEEK_SET ) == 0 );
+    int c = std::fgetc( f );
+    REQUIRE( c != EOF );
+    REQUIRE( std::fseek( f, offset, SEEK_SET ) == 0 );
+    std::fputc( c ^ 0x5A, f );
+    std::fclose( f );
+}
+
+TEST_CASE( "merkle root is deterministic and order sensitive", "[test_image_page_checksums]" )
+{
+    std::uint32_t a[] = { 1, 2, 3 };
+    std::uint32_t b[] = { 2, 1, 3 };
+    REQUIRE( pmm::detail::compute_merkle_root( a, 0 ) == 0 );
+    REQUIRE( pmm::detail::compute_merkle_root( a, 1 ) == 1 );
+    REQUIRE( pmm::detail::compute_merkle_root( a, 3 ) == pmm::detail::compute_merkle_root( a, 3 ) );
+    REQUIRE( pmm::detail::compute_merkle_root( a, 3 ) != pmm::detail::compute_merkle_root( b, 3 ) );
+}
+
+TEST_CASE( "paged save/load roundtrip", "[test_image_page_checksums]" )
+{
+    cleanup_paged_files();
+    REQUIRE( PageMgr::create( 256 * 1024 ) );
+    PageMgr::pptr<int> p = PageMgr::allocate_typed<int>();
+    REQUIRE( !p.is_null() );
+    *p                      = 4242;
+    std::uint32_t saved_idx = p.offset();
+
+    pmm::ImagePageTable table;
+    REQUIRE( pmm::save_manager_paged<PageMgr>( kPagedFile, table ) );
+    REQUIRE( table.page_crc.size() == 4 );
+    REQUIRE( table.merkle_root == pmm::detail::compute_merkle_root( table.page_crc.data(), table.page_crc.size() ) );
+    PageMgr::destroy();
+
+    REQUIRE( PageMgr2::create( 256 * 1024 ) );
+    pmm::VerifyResult   vr;
+    pmm::ImagePageTable loaded;
+    REQUIRE( pmm::load_manager_from_file_paged<PageMgr2>( kPagedFile, vr, &loaded ) );
+    REQUIRE( loaded.merkle_root == table.merkle_root );
+    REQUIRE( loaded.page_crc == table.page_crc );
+    PageMgr2::pptr<int> p2( saved_idx );
+    REQUIRE( *p2 == 4242 );
+    PageMgr2::destroy();
+    cleanup_paged_files();
+}
+
+TEST_CASE( "paged load locates the corrupted page", "[test_image_page_checksums]" )
+{
+    cleanup_paged_files();
+    REQUIRE( PageMgr::create( 256 * 1024 ) );
+    pmm::ImagePageTable table;
+    REQUIRE( pmm::save_manager_paged<PageMgr>( kPagedFile, table ) );
+    PageMgr::destroy();
+
+    corrupt_byte_at( kPagedFile, 2 * 64 * 1024 + 100 );
+
+    REQUIRE( PageMgr2::create( 256 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE_FALSE( pmm::load_manager_from_file_paged<PageMgr2>( kPagedFile, vr ) );
+    REQUIRE( PageMgr2::last_error() == pmm::PmmError::CrcMismatch );
+    REQUIRE( vr.violation_count == 1 );
+    REQUIRE( vr.entries[0].type == pmm::ViolationType::PageChecksumMismatch );
+    REQUIRE( vr.entries[0].block_index == 2 );
+    REQUIRE( vr.entries[0].expected == table.page_crc[2] );
+    PageMgr2::destroy();
+    cleanup_paged_files();
+}
+
+TEST_CASE( "paged load rejects a damaged page table", "[test_image_page_checksums]" )
+{
+    cleanup_paged_files();
+    REQUIRE( PageMgr::create( 128 * 1024 ) );
+    pmm::ImagePageTable table;
+    REQUIRE( pmm::save_manager_paged<PageMgr>( kPagedFile, table ) );
+    PageMgr::destroy();
+
+    corrupt_byte_at( kPagedFile, static_cast<long>( table.image_size ) );
+
+    REQUIRE( PageMgr2::create( 128 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE_FALSE( pmm::load_manager_from_file_paged<PageMgr2>( kPagedFile, vr ) );
+    REQUIRE( PageMgr2::last_error() == pmm::PmmError::CrcMismatch );
+    PageMgr2::destroy();
+    cleanup_paged_files();
+}
+
+TEST_CASE( "paged image is rejected by the whole-image CRC loader", "[test_image_page_checksums]" )
+{
+    cleanup_paged_files();
+    REQUIRE( PageMgr::create( 128 * 1024 ) );
+    pmm::ImagePageTable table;
+    REQUIRE( pmm::save_manager_paged<PageMgr>( kPagedFile, table ) );
+    PageMgr::destroy();
+
+    REQUIRE( PageMgr2::create( 128 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE_FALSE( pmm::load_manager_from_file<PageMgr2>( kPagedFile, vr ) );
+    PageMgr2::destroy();
+    cleanup_paged_files();
+}
+
+TEST_CASE( "paged load with a table verifies payload pages on first access", "[test_image_page_checksums]" )
+{
+    cleanup_paged_files();
+    REQUIRE( PageMgr::create( 256 * 1024 ) );
+    PageMgr::pptr<char> blob = PageMgr::allocate_typed<char>( 150 * 1024 );
+    REQUIRE( !blob.is_null() );
+    std::memset( blob.resolve(), 'x', 150 * 1024 );
+    std::uint32_t       blob_idx = blob.offset();
+    pmm::ImagePageTable table;
+    REQUIRE( pmm::save_manager_paged<PageMgr>( kPagedFile, table ) );
+    PageMgr::destroy();
+
+    corrupt_byte_at( kPagedFile, 64 * 1024 + 100 );
+
+    REQUIRE( PageMgr2::create( 256 * 1024 ) );
+    pmm::VerifyResult   vr;
+    pmm::ImagePageTable loaded;
+    REQUIRE( pmm::load_manager_from_file_paged<PageMgr2>( kPagedFile, vr, &loaded ) );
+    REQUIRE( loaded.bad_pages == 0 );
+    PageMgr2::pptr<char> blob2( blob_idx );
+    REQUIRE( blob2.resolve() == nullptr );
+    REQUIRE( PageMgr2::last_error() == pmm::PmmError::CrcMismatch );
+    REQUIRE( loaded.bad_pages == 1 );
+    REQUIRE( blob2.resolve() == nullptr );
+    PageMgr2::destroy();
+
+    REQUIRE( PageMgr2::create( 256 * 1024 ) );
+    pmm::VerifyResult eager;
+    REQUIRE_FALSE( pmm::load_manager_from_file_paged<PageMgr2>( kPagedFile, eager ) );
+    REQUIRE( eager.entries[0].block_index == 1 );
+    PageMgr2::destroy();
+    cleanup_paged_files();
+}
+
+TEST_CASE( "paged save picks up writes through raw pointers", "[test_image_page_checksums]" )
+{
+    cleanup_paged_files();
+    REQUIRE( PageMgr::create( 1024 * 1024 ) );
+    PageMgr::pptr<char> blob = PageMgr::allocate_typed<char>( 700 * 1024 );
+    PageMgr::pptr<int>  late = PageMgr::allocate_typed<int>();
+    REQUIRE( !blob.is_null() );
+    REQUIRE( !late.is_null() );
+    char* raw      = blob.resolve();
+    int*  raw_late = late.resolve();
+    std::memset( raw, 0, 700 * 1024 );
+    *raw_late = 1;
+    pmm::ImagePageTable table;
+    REQUIRE( pmm::save_manager_paged<PageMgr>( kPagedFile, table ) );
+    REQUIRE( pmm::save_manager_paged<PageMgr>( kPagedFile, table ) );
+
+    raw[600 * 1024]          = 'x';
+    *raw_late                = 77;
+    PageMgr::pptr<int> extra = PageMgr::allocate_typed<int>();
+    REQUIRE( !extra.is_null() );
+    *extra = 78;
+    REQUIRE( pmm::save_manager_paged<PageMgr>( kPagedFile, table ) );
+    std::uint32_t blob_idx  = blob.offset();
+    std::uint32_t late_idx  = late.offset();
+    std::uint32_t extra_idx = extra.offset();
+    PageMgr::destroy();
+
+    REQUIRE( PageMgr2::create( 1024 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file_paged<PageMgr2>( kPagedFile, vr ) );
+    REQUIRE( PageMgr2::pptr<char>( blob_idx ).resolve()[600 * 1024] == 'x' );
+    REQUIRE( *PageMgr2::pptr<int>( late_idx ) == 77 );
+    REQUIRE( *PageMgr2::pptr<int>( extra_idx ) == 78 );
+    PageMgr2::destroy();
+    cleanup_paged_files();
+}
+
+TEST_CASE( "paged table detaches while another thread resolves", "[test_image_page_checksums]" )
+{
+    cleanup_paged_files();
+    REQUIRE( PageLockMgr::create( 1024 * 1024 ) );
+    std::vector<std::uint32_t> idx;
+    for ( int i = 0; i < 64; ++i )
+    {
+        PageLockMgr::pptr<int> p = PageLockMgr::allocate_typed<int>( 2048 );
+        REQUIRE( !p.is_null() );
+        *p = i;
+        idx.push_back( p.offset() );
+    }
+    pmm::ImagePageTable table;
+    REQUIRE( pmm::save_manager_paged<PageLockMgr>( kPagedFile, table ) );
+    PageLockMgr::destroy();
+
+    REQUIRE( PageLockMgr::create( 1024 * 1024 ) );
+    pmm::VerifyResult vr;
+    auto              loaded = std::make_unique<pmm::ImagePageTable>();
+    REQUIRE( pmm::load_manager_from_file_paged<PageLockMgr>( kPagedFile, vr, loaded.get() ) );
+    bool        values_ok = true;
+    std::thread reader(
+        [&]
+        {
+            for ( int round = 0; round < 200; ++round )
+            {
+                for ( std::size_t i = 0; i < idx.size(); ++i )
+                {
+                    const int* v = PageLockMgr::pptr<int>( idx[i] ).resolve();
+                    values_ok    = values_ok && v != nullptr && *v == static_cast<int>( i );
+                }
+            }
+        } );
+    loaded.reset();
+    reader.join();
+    REQUIRE( values_ok );
+    REQUIRE( PageLockMgr::verify().ok );
+    PageLockMgr::destroy();
+    cleanup_paged_files();
+}
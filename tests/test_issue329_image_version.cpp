@@ -17,6 +17,7 @@ using VersionMgr       = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3290
 using VersionLoadMgr   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 32902>;
 using VersionVerifyMgr = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 32903>;
 using VersionLegacyMgr = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 32904>;
+using VersionOlderMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 32905>;
 
 } // namespace
 
@@ -28,6 +29,8 @@ TEST_CASE( "issue329: ManagerHeader exposes a persisted image version", "[issue3
                    "ManagerHeader::image_version must be a persisted version byte" );
     static_assert( pmm::detail::kCurrentImageVersion >= 2,
                    "Issue #367 bumps the persisted image version to 2 (or later) to break legacy compatibility" );
+    static_assert( pmm::detail::kCurrentImageVersion >= 3,
+                   "pmap_node, pstringview, pstring, parray and the symbol index changed their layout (version 3)" );
     static_assert( sizeof( Header ) == 64,
                    "Adding an explicit image version must preserve the default ManagerHeader size" );
 }
@@ -83,6 +86,26 @@ TEST_CASE( "issue329/issue367: legacy unversioned images are rejected, not migra
     VersionLegacyMgr::destroy();
 }
 
+TEST_CASE( "issue329: every older layout version is rejected on load", "[issue329][load]" )
+{
+    for ( unsigned v = 0; v < pmm::detail::kCurrentImageVersion; ++v )
+    {
+        VersionOlderMgr::destroy();
+        REQUIRE( VersionOlderMgr::create( 64 * 1024 ) );
+        VersionOlderMgr::destroy();
+
+        auto* hdr =
+            pmm::detail::manager_header_at<pmm::DefaultAddressTraits>( VersionOlderMgr::backend().base_ptr() );
+        hdr->image_version = static_cast<std::uint8_t>( v );
+
+        VersionOlderMgr::clear_error();
+        pmm::VerifyResult result;
+        REQUIRE_FALSE( VersionOlderMgr::load( result ) );
+        REQUIRE( VersionOlderMgr::last_error() == pmm::PmmError::UnsupportedImageVersion );
+    }
+    VersionOlderMgr::destroy();
+}
+
 TEST_CASE( "issue329: verify reports an unsupported image version as header corruption", "[issue329][verify]" )
 {
     VersionVerifyMgr::destroy();
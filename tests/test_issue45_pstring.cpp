@@ -219,8 +219,8 @@ TEST_CASE( "    free_data() deallocates buffer", "[test_issue45_pstring]" )
     TestMgr::pptr<TestStr> p   = TestMgr::create_typed<TestStr>();
     TestStr*               str = p.resolve();
 
-    REQUIRE( str->assign( "test data" ) );
-    REQUIRE( str->size() == 9 );
+    REQUIRE( str->assign( "test data past the inline size" ) );
+    REQUIRE( str->size() == 30 );
 
     std::size_t alloc_before = TestMgr::alloc_block_count();
 
@@ -0,0 +1,103 @@
+/**
+ * @file test_parray_bulk.cpp
+ * @brief Tests for parray bulk operations, size width and growth factor.
+ *
+ * Verifies:
+ *  - size_type is 32-bit for 32-bit indexes and 64-bit for 64-bit indexes
+ *  - append_range/assign/insert_range/erase_range match std::vector, including sources inside the array
+ *  - a custom growth factor is honoured and bulk appends grow capacity once
+ */
+
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+using BulkMgr   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4201>;
+using BulkLarge = pmm::PersistMemoryManager<pmm::LargeDBConfig, 4202>;
+
+static bool same( const BulkMgr::parray<int>& a, const std::vector<int>& v )
+{
+    if ( a.size() != v.size() )
+        return false;
+    for ( std::size_t i = 0; i < v.size(); ++i )
+        if ( a[i] != v[i] )
+            return false;
+    return true;
+}
+
+TEST_CASE( "parray size type follows the index width", "[test_parray_bulk]" )
+{
+    STATIC_REQUIRE( std::is_same_v<BulkMgr::parray<int>::size_type, std::uint32_t> );
+    STATIC_REQUIRE( std::is_same_v<BulkLarge::parray<int>::size_type, std::uint64_t> );
+}
+
+TEST_CASE( "parray bulk operations match std::vector", "[test_parray_bulk]" )
+{
+    REQUIRE( BulkMgr::create( 1024 * 1024 ) );
+    auto p = BulkMgr::create_typed<BulkMgr::parray<int>>();
+
+    std::vector<int> src( 1000 );
+    std::iota( src.begin(), src.end(), 0 );
+    std::vector<int> ref;
+
+    REQUIRE( p.resolve()->append_range( src.data(), src.size() ) );
+    ref.insert( ref.end(), src.begin(), src.end() );
+    REQUIRE( same( *p.resolve(), ref ) );
+    REQUIRE( p.resolve()->append_range( nullptr, 0 ) );
+
+    REQUIRE( p.resolve()->insert_range( 10, src.data() + 500, 20 ) );
+    ref.insert( ref.begin() + 10, src.begin() + 500, src.begin() + 520 );
+    REQUIRE( same( *p.resolve(), ref ) );
+
+    REQUIRE( p.resolve()->erase_range( 5, 100 ) );
+    ref.erase( ref.begin() + 5, ref.begin() + 105 );
+    REQUIRE( same( *p.resolve(), ref ) );
+    REQUIRE( !p.resolve()->erase_range( ref.size() - 1, 2 ) );
+    REQUIRE( !p.resolve()->insert_range( ref.size() + 1, src.data(), 1 ) );
+
+    std::vector<int> copy( ref );
+    REQUIRE( p.resolve()->insert_range( 50, p.resolve()->data() + 40, 30 ) );
+    ref.insert( ref.begin() + 50, copy.begin() + 40, copy.begin() + 70 );
+    REQUIRE( same( *p.resolve(), ref ) );
+
+    copy = ref;
+    REQUIRE( p.resolve()->append_range( p.resolve()->data(), p.resolve()->size() ) );
+    ref.insert( ref.end(), copy.begin(), copy.end() );
+    REQUIRE( same( *p.resolve(), ref ) );
+
+    REQUIRE( p.resolve()->assign( p.resolve()->data() + 7, 100 ) );
+    ref.assign( ref.begin() + 7, ref.begin() + 107 );
+    REQUIRE( same( *p.resolve(), ref ) );
+
+    REQUIRE( p.resolve()->assign( src.data(), 3 ) );
+    REQUIRE( same( *p.resolve(), { 0, 1, 2 } ) );
+    p.resolve()->free_data();
+    BulkMgr::destroy_typed( p );
+    REQUIRE( BulkMgr::verify().ok );
+    BulkMgr::destroy();
+}
+
+TEST_CASE( "parray honours a custom growth factor", "[test_parray_bulk]" )
+{
+    using Arr = pmm::parray<std::uint8_t, BulkMgr, 3, 2>;
+    REQUIRE( BulkMgr::create( 256 * 1024 ) );
+    auto p = BulkMgr::create_typed<Arr>();
+    REQUIRE( p.resolve()->reserve( 100 ) );
+    REQUIRE( p.resolve()->resize( 100 ) );
+    REQUIRE( p.resolve()->push_back( 1 ) );
+    REQUIRE( p.resolve()->capacity() == 150 );
+
+    std::vector<std::uint8_t> bytes( 10000, 0xAB );
+    REQUIRE( p.resolve()->append_range( bytes.data(), bytes.size() ) );
+    REQUIRE( p.resolve()->capacity() == 10101 );
+    REQUIRE( p.resolve()->size() == 10101 );
+    REQUIRE( ( *p.resolve() )[100] == 1 );
+    REQUIRE( ( *p.resolve() )[10100] == 0xAB );
+    p.resolve()->free_data();
+    BulkMgr::destroy_typed( p );
+    BulkMgr::destroy();
+}
@@ -0,0 +1,167 @@
+/**
+ * @file test_parray_kernels.cpp
+ * @brief Tests for the SIMD analytics kernels over parray (pmm/parray_kernels.h).
+ *
+ * Verifies:
+ *  - sum/minmax/prefix sum/filter/gather agree with scalar references at every SIMD level
+ *    the CPU supports, for double and int64_t, including lengths that are not vector multiples
+ *  - filter bitmasks have one bit per element and cleared tail bits; gather rejects bad indexes
+ *  - threaded chunking returns the same results as a single pass
+ */
+
+#include "pmm/parray_kernels.h"
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using KerMgr = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4301>;
+
+static std::vector<pmm::KernelOptions> kernel_variants()
+{
+    std::vector<pmm::KernelOptions> out;
+    for ( int lvl = 0; lvl <= static_cast<int>( pmm::simd_level_supported() ); ++lvl )
+    {
+        for ( std::size_t threads : { std::size_t{ 1 }, std::size_t{ 4 } } )
+        {
+            pmm::KernelOptions opt;
+            opt.max_level = static_cast<pmm::SimdLevel>( lvl );
+            opt.threads   = threads;
+            opt.min_chunk = 256;
+            out.push_back( opt );
+        }
+    }
+    return out;
+}
+
+template <typename T> static void check_kernels( const std::vector<T>& values )
+{
+    REQUIRE( KerMgr::create( 4 * 1024 * 1024 ) );
+    auto p = KerMgr::create_typed<KerMgr::parray<T>>();
+    REQUIRE( p.resolve()->append_range( values.data(), values.size() ) );
+    const auto& arr = *p.resolve();
+    const T     pivot = values[values.size() / 3];
+
+    T ref_sum = T{};
+    T ref_lo = values[0], ref_hi = values[0];
+    for ( T v : values )
+    {
+        ref_sum += v;
+        ref_lo = v < ref_lo ? v : ref_lo;
+        ref_hi = v > ref_hi ? v : ref_hi;
+    }
+    std::vector<std::uint64_t> idx;
+    for ( std::size_t i = 0; i < values.size(); i += 7 )
+        idx.push_back( ( i * 31 ) % values.size() );
+
+    for ( const pmm::KernelOptions& opt : kernel_variants() )
+    {
+        if constexpr ( std::is_floating_point_v<T> )
+            REQUIRE( std::fabs( pmm::array_sum( arr, opt ) - ref_sum ) <= 1e-9 * std::fabs( ref_sum ) + 1e-9 );
+        else
+            REQUIRE( pmm::array_sum( arr, opt ) == ref_sum );
+
+        T lo{}, hi{};
+        REQUIRE( pmm::array_minmax( arr, lo, hi, opt ) );
+        REQUIRE( lo == ref_lo );
+        REQUIRE( hi == ref_hi );
+
+        for ( pmm::CompareOp op : { pmm::CompareOp::Less, pmm::CompareOp::LessEqual, pmm::CompareOp::Greater,
+                                    pmm::CompareOp::GreaterEqual, pmm::CompareOp::Equal, pmm::CompareOp::NotEqual } )
+        {
+            std::vector<std::uint64_t> mask( pmm::bitmask_words( values.size() ), ~std::uint64_t{ 0 } );
+            const std::size_t          hits = pmm::array_filter( arr, op, pivot, mask.data(), opt );
+            std::size_t                expect = 0;
+            bool                       exact  = true;
+            for ( std::size_t i = 0; i < values.size(); ++i )
+            {
+                const bool want = pmm::detail::kernel_match( values[i], op, pivot );
+                expect += want ? 1 : 0;
+                exact = exact && ( ( ( mask[i / 64] >> ( i % 64 ) ) & 1 ) != 0 ) == want;
+            }
+            REQUIRE( exact );
+            REQUIRE( hits == expect );
+            if ( values.size() % 64 != 0 )
+                REQUIRE( ( mask.back() >> ( values.size() % 64 ) ) == 0 );
+        }
+
+        std::vector<T> gathered( idx.size() );
+        REQUIRE( pmm::array_gather( arr, idx.data(), idx.size(), gathered.data(), opt ) );
+        bool gather_ok = true;
+        for ( std::size_t i = 0; i < idx.size(); ++i )
+            gather_ok = gather_ok && gathered[i] == values[idx[i]];
+        REQUIRE( gather_ok );
+        std::uint64_t bad = values.size();
+        REQUIRE( !pmm::array_gather( arr, &bad, 1, gathered.data(), opt ) );
+
+        std::vector<T> scan( values );
+        pmm::array_prefix_sum( scan.data(), scan.size(), opt );
+        T    running = T{};
+        bool scan_ok = true;
+        for ( std::size_t i = 0; i < values.size(); ++i )
+        {
+            running += values[i];
+            if constexpr ( std::is_floating_point_v<T> )
+                scan_ok = scan_ok && std::fabs( scan[i] - running ) <= 1e-9 * ( std::fabs( running ) + 1.0 );
+            else
+                scan_ok = scan_ok && scan[i] == running;
+        }
+        REQUIRE( scan_ok );
+    }
+
+    REQUIRE( pmm::array_prefix_sum( *p.resolve() ) );
+    const T last = ( *p.resolve() )[values.size() - 1];
+    if constexpr ( std::is_floating_point_v<T> )
+        REQUIRE( std::fabs( last - ref_sum ) <= 1e-9 * std::fabs( ref_sum ) + 1e-9 );
+    else
+        REQUIRE( last == ref_sum );
+    p.resolve()->free_data();
+    KerMgr::destroy_typed( p );
+    KerMgr::destroy();
+}
+
+TEST_CASE( "kernels over parray<int64_t> match scalar references", "[test_parray_kernels]" )
+{
+    std::vector<std::int64_t> values( 5003 );
+    std::uint64_t             x = 88172645463325252ull;
+    for ( auto& v : values )
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        v = static_cast<std::int64_t>( x % 2000001 ) - 1000000;
+    }
+    values[4000] = -5000000;
+    values[17]   = 7000000;
+    check_kernels( values );
+}
+
+TEST_CASE( "kernels over parray<double> match scalar references", "[test_parray_kernels]" )
+{
+    std::vector<double> values( 4099 );
+    for ( std::size_t i = 0; i < values.size(); ++i )
+        values[i] = std::sin( static_cast<double>( i ) * 0.37 ) * 100.0;
+    values[123] = 250.5;
+    values[3001] = -250.25;
+    check_kernels( values );
+}
+
+TEST_CASE( "kernels handle empty and tiny arrays", "[test_parray_kernels]" )
+{
+    REQUIRE( KerMgr::create( 64 * 1024 ) );
+    auto p = KerMgr::create_typed<KerMgr::parray<double>>();
+    double lo = 0, hi = 0;
+    REQUIRE( pmm::array_sum( *p.resolve() ) == 0.0 );
+    REQUIRE( !pmm::array_minmax( *p.resolve(), lo, hi ) );
+    REQUIRE( pmm::array_filter( *p.resolve(), pmm::CompareOp::Less, 1.0, nullptr ) == 0 );
+    REQUIRE( pmm::array_prefix_sum( *p.resolve() ) );
+    REQUIRE( p.resolve()->push_back( 3.5 ) );
+    REQUIRE( pmm::array_minmax( *p.resolve(), lo, hi ) );
+    REQUIRE( lo == 3.5 );
+    REQUIRE( hi == 3.5 );
+    p.resolve()->free_data();
+    KerMgr::destroy_typed( p );
+    KerMgr::destroy();
+}
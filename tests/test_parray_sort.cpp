@@ -0,0 +1,138 @@
+/**
+ * @file test_parray_sort.cpp
+ * @brief Tests for parray sorting and searching (pmm/parray_kernels.h).
+ *
+ * Verifies:
+ *  - radix sort (integral keys, signed and unsigned) and chunked merge sort (double) match std::sort
+ *    single-threaded and with several workers
+ *  - the scratch region comes from the same manager and is released afterwards, even when
+ *    allocating it grows and relocates the image
+ *  - lower_bound/binary_search and the batched lookup agree with std::lower_bound
+ */
+
+#include "pmm/parray_kernels.h"
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using SortMgr     = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4401>;
+using SortGrowMgr = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4402>;
+
+template <typename T> static std::vector<T> random_values( std::size_t n, std::uint64_t seed )
+{
+    std::vector<T> out( n );
+    for ( auto& v : out )
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        if constexpr ( std::is_floating_point_v<T> )
+            v = static_cast<T>( static_cast<std::int64_t>( seed % 2000001 ) - 1000000 ) / 7.0;
+        else
+            v = static_cast<T>( seed );
+    }
+    return out;
+}
+
+template <typename T> static void check_sort( std::size_t n )
+{
+    const std::vector<T> values = random_values<T>( n, 88172645463325252ull + n );
+    std::vector<T>       expect( values );
+    std::sort( expect.begin(), expect.end() );
+    for ( std::size_t threads : { std::size_t{ 1 }, std::size_t{ 4 } } )
+    {
+        REQUIRE( SortMgr::create( 4 * 1024 * 1024 ) );
+        auto p = SortMgr::create_typed<SortMgr::parray<T>>();
+        REQUIRE( p.resolve()->append_range( values.data(), values.size() ) );
+        const std::size_t used  = SortMgr::used_size();
+        const std::size_t count = SortMgr::alloc_block_count();
+
+        pmm::KernelOptions opt;
+        opt.threads   = threads;
+        opt.min_chunk = 256;
+        REQUIRE( pmm::array_sort( *p.resolve(), opt ) );
+        REQUIRE( std::equal( expect.begin(), expect.end(), p.resolve()->data() ) );
+        REQUIRE( SortMgr::used_size() == used );
+        REQUIRE( SortMgr::alloc_block_count() == count );
+
+        p.resolve()->free_data();
+        SortMgr::destroy_typed( p );
+        SortMgr::destroy();
+    }
+}
+
+TEST_CASE( "array_sort matches std::sort for integral and floating keys", "[test_parray_sort]" )
+{
+    for ( std::size_t n : { std::size_t{ 0 }, std::size_t{ 1 }, std::size_t{ 2 }, std::size_t{ 1000 },
+                            std::size_t{ 20011 } } )
+    {
+        check_sort<std::int64_t>( n );
+        check_sort<std::uint32_t>( n );
+        check_sort<std::int16_t>( n );
+        check_sort<double>( n );
+    }
+}
+
+TEST_CASE( "array_sort survives image growth for its scratch region", "[test_parray_sort]" )
+{
+    REQUIRE( SortGrowMgr::create( 64 * 1024 ) );
+    SortGrowMgr::parray<std::int64_t> arr;
+    REQUIRE( arr.reserve( 6000 ) );
+    for ( std::int64_t i = 0; i < 6000; ++i )
+        REQUIRE( arr.push_back( ( i * 7919 ) % 6000 - 3000 ) );
+    const std::size_t before = SortGrowMgr::total_size();
+    REQUIRE( pmm::array_sort( arr ) );
+    REQUIRE( SortGrowMgr::total_size() > before );
+    const std::int64_t* d = arr.data();
+    for ( std::size_t i = 0; i < 6000; ++i )
+        REQUIRE( d[i] == static_cast<std::int64_t>( i ) - 3000 );
+    arr.free_data();
+    SortGrowMgr::destroy();
+}
+
+TEST_CASE( "lower_bound, binary_search and batched lookup agree with std::lower_bound", "[test_parray_sort]" )
+{
+    REQUIRE( SortMgr::create( 1024 * 1024 ) );
+    auto p = SortMgr::create_typed<SortMgr::parray<std::int64_t>>();
+    REQUIRE( pmm::array_lower_bound( *p.resolve(), std::int64_t{ 5 } ) == 0 );
+    REQUIRE( !pmm::array_binary_search( *p.resolve(), std::int64_t{ 5 } ) );
+
+    std::vector<std::int64_t> values;
+    for ( std::int64_t i = 0; i < 3001; ++i )
+        values.push_back( i * 3 - ( i % 4 == 0 ? 1 : 0 ) );
+    REQUIRE( p.resolve()->append_range( values.data(), values.size() ) );
+    const auto& arr = *p.resolve();
+
+    std::vector<std::int64_t> keys;
+    for ( std::int64_t k = -5; k < 9010; k += 2 )
+        keys.push_back( k );
+    bool single_ok = true;
+    for ( std::int64_t k : keys )
+    {
+        const auto it = std::lower_bound( values.begin(), values.end(), k );
+        single_ok     = single_ok && pmm::array_lower_bound( arr, k ) == static_cast<std::size_t>( it - values.begin() );
+        single_ok     = single_ok && pmm::array_binary_search( arr, k ) == ( it != values.end() && *it == k );
+    }
+    REQUIRE( single_ok );
+
+    for ( std::size_t threads : { std::size_t{ 1 }, std::size_t{ 3 } } )
+    {
+        pmm::KernelOptions opt;
+        opt.threads   = threads;
+        opt.min_chunk = 64;
+        std::vector<std::uint64_t> out( keys.size(), ~std::uint64_t{ 0 } );
+        pmm::array_lower_bound_batch( arr, keys.data(), keys.size(), out.data(), opt );
+        bool batch_ok = true;
+        for ( std::size_t i = 0; i < keys.size(); ++i )
+            batch_ok = batch_ok && out[i] == static_cast<std::uint64_t>(
+                                                 std::lower_bound( values.begin(), values.end(), keys[i] ) -
+                                                 values.begin() );
+        REQUIRE( batch_ok );
+    }
+    p.resolve()->free_data();
+    SortMgr::destroy_typed( p );
+    SortMgr::destroy();
+}
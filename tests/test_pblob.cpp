@@ -0,0 +1,144 @@
+/**
+ * @file test_pblob.cpp
+ * @brief Tests for pblob — chunked persistent blob with streaming I/O.
+ *
+ * Verifies:
+ *  - append/write/read at arbitrary offsets across chunk boundaries match a std::vector model
+ *  - writing past the end zero-fills the gap; resize shrinks and frees trailing chunks
+ *  - no block is larger than one chunk, whatever the blob size
+ *  - per-chunk spans cover the blob in order; free_data releases every block; the blob survives save/load
+ */
+
+#include "pmm/io.h"
+#include "pmm/pblob.h"
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using BlobMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4801>;
+using BlobMgr2 = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4802>;
+using Blob     = pmm::pblob<BlobMgr, 1024>;
+
+static std::vector<std::uint8_t> pattern( std::size_t n, std::uint8_t seed )
+{
+    std::vector<std::uint8_t> out( n );
+    for ( std::size_t i = 0; i < n; ++i )
+        out[i] = static_cast<std::uint8_t>( seed + i * 31 + ( i >> 8 ) );
+    return out;
+}
+
+TEST_CASE( "pblob streaming writes and reads match a byte model", "[test_pblob]" )
+{
+    REQUIRE( BlobMgr::create( 4 * 1024 * 1024 ) );
+    const std::size_t         blocks = BlobMgr::alloc_block_count();
+    auto                      p      = BlobMgr::create_typed<Blob>();
+    std::vector<std::uint8_t> model;
+
+    const auto head = pattern( 3000, 1 );
+    REQUIRE( p.resolve()->append( head.data(), head.size() ) );
+    model.insert( model.end(), head.begin(), head.end() );
+    const auto tail = pattern( 5000, 9 );
+    REQUIRE( p.resolve()->append( tail.data(), tail.size() ) );
+    model.insert( model.end(), tail.begin(), tail.end() );
+    const auto patch = pattern( 2100, 77 );
+    REQUIRE( p.resolve()->write( 1000, patch.data(), patch.size() ) );
+    std::copy( patch.begin(), patch.end(), model.begin() + 1000 );
+    const auto past = pattern( 100, 200 );
+    REQUIRE( p.resolve()->write( 9000, past.data(), past.size() ) );
+    model.resize( 9000, 0 );
+    model.insert( model.end(), past.begin(), past.end() );
+
+    Blob* b = p.resolve();
+    REQUIRE( b->size() == model.size() );
+    REQUIRE( b->chunk_count() == ( model.size() + 1023 ) / 1024 );
+    std::vector<std::uint8_t> all( model.size() );
+    REQUIRE( b->read( 0, all.data(), all.size() ) == model.size() );
+    REQUIRE( all == model );
+    for ( std::uint64_t off : { std::uint64_t{ 0 }, std::uint64_t{ 1023 }, std::uint64_t{ 1024 },
+                                std::uint64_t{ 4095 }, std::uint64_t{ 8990 } } )
+    {
+        std::vector<std::uint8_t> part( 700, 0xEE );
+        const std::size_t         got = b->read( off, part.data(), part.size() );
+        REQUIRE( got == std::min<std::size_t>( 700, model.size() - off ) );
+        REQUIRE( std::equal( part.begin(), part.begin() + got, model.begin() + off ) );
+    }
+    std::uint8_t byte = 0;
+    REQUIRE( b->read( model.size(), &byte, 1 ) == 0 );
+
+    std::size_t covered = 0;
+    bool        spans   = true;
+    b->for_each_chunk(
+        [&]( std::span<const std::uint8_t> s )
+        {
+            spans = spans && std::equal( s.begin(), s.end(), model.begin() + covered );
+            covered += s.size();
+        } );
+    REQUIRE( spans );
+    REQUIRE( covered == model.size() );
+    REQUIRE( b->span( b->chunk_count() ).empty() );
+    b->span( 0 )[5] = 0x42;
+    model[5]        = 0x42;
+    REQUIRE( b->read( 5, &byte, 1 ) == 1 );
+    REQUIRE( byte == 0x42 );
+
+    REQUIRE( b->resize( 2500 ) );
+    REQUIRE( b->size() == 2500 );
+    REQUIRE( b->chunk_count() == 3 );
+    REQUIRE( b->resize( 2600 ) );
+    REQUIRE( b->read( 2550, &byte, 1 ) == 1 );
+    REQUIRE( byte == 0 );
+    b->clear();
+    REQUIRE( b->empty() );
+    REQUIRE( b->chunk_count() == 0 );
+    b->free_data();
+    BlobMgr::destroy_typed( p );
+    REQUIRE( BlobMgr::alloc_block_count() == blocks );
+    BlobMgr::destroy();
+}
+
+TEST_CASE( "pblob never needs a block larger than one chunk", "[test_pblob]" )
+{
+    REQUIRE( BlobMgr::create( 4 * 1024 * 1024 ) );
+    using Big      = pmm::pblob<BlobMgr>;
+    auto       p   = BlobMgr::create_typed<Big>();
+    const auto big = pattern( 3 * 1024 * 1024 / 2, 5 );
+    REQUIRE( p.resolve()->append( big.data(), big.size() ) );
+    auto* b = p.resolve();
+    REQUIRE( b->chunk_count() == ( big.size() + Big::chunk_bytes - 1 ) / Big::chunk_bytes );
+    bool bounded = true;
+    b->for_each_chunk( [&]( std::span<const std::uint8_t> s ) { bounded = bounded && s.size() <= Big::chunk_bytes; } );
+    REQUIRE( bounded );
+    std::vector<std::uint8_t> back( big.size() );
+    REQUIRE( b->read( 0, back.data(), back.size() ) == big.size() );
+    REQUIRE( back == big );
+    b->free_data();
+    BlobMgr::destroy_typed( p );
+    BlobMgr::destroy();
+}
+
+TEST_CASE( "pblob survives save and load", "[test_pblob]" )
+{
+    const char* file = "test_pblob.dat";
+    REQUIRE( BlobMgr::create( 1024 * 1024 ) );
+    auto       p    = BlobMgr::create_typed<Blob>();
+    const auto data = pattern( 6000, 3 );
+    REQUIRE( p.resolve()->append( data.data(), data.size() ) );
+    const auto offset = p.offset();
+    REQUIRE( pmm::save_manager<BlobMgr>( file ) );
+    REQUIRE( BlobMgr2::create( BlobMgr::total_size() ) );
+    BlobMgr::destroy();
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<BlobMgr2>( file, vr ) );
+    std::remove( file );
+
+    auto* b = BlobMgr2::pptr<pmm::pblob<BlobMgr2, 1024>>( offset ).resolve();
+    REQUIRE( b->size() == data.size() );
+    std::vector<std::uint8_t> back( data.size() );
+    REQUIRE( b->read( 0, back.data(), back.size() ) == data.size() );
+    REQUIRE( back == data );
+    BlobMgr2::destroy();
+}
@@ -0,0 +1,175 @@
+/**
+ * @file test_pbtree.cpp
+ * @brief Tests for pbtree: persistent B+tree with wide nodes and linked leaves.
+ *
+ * Verifies:
+ *  - insert/find/erase agree with std::map under a random workload, with splits and merges
+ *  - find() on a const tree returns a pointer to const
+ *  - in-order iteration, lower_bound/upper_bound and for_each_range follow the leaf chain
+ *  - sequential appends fill leaves completely; random inserts keep leaves at least half full
+ *  - erasing every key collapses the tree and clear() releases every node
+ *  - the tree survives save/load through its named forest domain
+ */
+
+#include "pmm/io.h"
+#include "pmm/pbtree.h"
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using TreeMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3201>;
+using TreeMgr2 = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3202>;
+
+template <typename Tree, typename Ref> static void check_same( const Tree& tree, const Ref& ref )
+{
+    REQUIRE( tree.size() == ref.size() );
+    auto it = tree.begin();
+    for ( const auto& kv : ref )
+    {
+        REQUIRE( it != tree.end() );
+        REQUIRE( it.key() == kv.first );
+        REQUIRE( it.value() == kv.second );
+        ++it;
+    }
+    REQUIRE( it == tree.end() );
+}
+
+TEST_CASE( "pbtree matches std::map under random workload", "[test_pbtree]" )
+{
+    using Tree = pmm::pbtree<std::int32_t, std::int64_t, TreeMgr, 128>;
+    REQUIRE( TreeMgr::create( 2 * 1024 * 1024 ) );
+    {
+        Tree tree( "btree/random" );
+        REQUIRE( tree.is_bound() );
+        REQUIRE( tree.empty() );
+        REQUIRE( tree.find( 1 ) == nullptr );
+        REQUIRE_FALSE( tree.erase( 1 ) );
+        REQUIRE( tree.begin() == tree.end() );
+        std::map<std::int32_t, std::int64_t> ref;
+        std::mt19937                         rng( 32 );
+        for ( std::int64_t i = 0; i < 20000; ++i )
+        {
+            std::int32_t k = static_cast<std::int32_t>( rng() % 4000 ) - 2000;
+            if ( rng() % 3 == 0 )
+                REQUIRE( tree.erase( k ) == ( ref.erase( k ) == 1 ) );
+            else
+            {
+                REQUIRE( tree.insert( k, i ) );
+                ref[k] = i;
+            }
+        }
+        REQUIRE( tree.height() >= 3 );
+        check_same( tree, ref );
+        const Tree& view = tree;
+        static_assert( std::is_same_v<decltype( view.find( 0 ) ), const std::int64_t*> );
+        for ( std::int32_t k = -2000; k < 2000; ++k )
+        {
+            const std::int64_t* v = view.find( k );
+            REQUIRE( ( v != nullptr ) == ( ref.count( k ) == 1 ) );
+        }
+        REQUIRE( tree.size() >= tree.leaf_count() * ( Tree::leaf_capacity / 2 ) );
+
+        for ( std::int32_t probe : { -2500, -2000, -17, 0, 511, 1999, 2500 } )
+        {
+            auto lb = tree.lower_bound( probe );
+            auto rl = ref.lower_bound( probe );
+            REQUIRE( ( lb == tree.end() ) == ( rl == ref.end() ) );
+            if ( rl != ref.end() )
+                REQUIRE( lb.key() == rl->first );
+            auto ub = tree.upper_bound( probe );
+            auto ru = ref.upper_bound( probe );
+            REQUIRE( ( ub == tree.end() ) == ( ru == ref.end() ) );
+            if ( ru != ref.end() )
+                REQUIRE( ub.key() == ru->first );
+        }
+        std::vector<std::int32_t> scanned;
+        std::vector<std::int32_t> expected;
+        std::size_t               n =
+            tree.for_each_range( -300, 700, [&]( std::int32_t k, std::int64_t ) { scanned.push_back( k ); } );
+        for ( auto it = ref.lower_bound( -300 ); it != ref.lower_bound( 700 ); ++it )
+            expected.push_back( it->first );
+        REQUIRE( n == expected.size() );
+        REQUIRE( scanned == expected );
+
+        for ( const auto& kv : std::map<std::int32_t, std::int64_t>( ref ) )
+            REQUIRE( tree.erase( kv.first ) );
+        REQUIRE( tree.empty() );
+        REQUIRE( tree.height() == 0 );
+        REQUIRE( tree.leaf_count() == 0 );
+        REQUIRE( tree.inner_count() == 0 );
+        tree.clear();
+        REQUIRE( tree.root_index() == 0 );
+    }
+    REQUIRE( TreeMgr::verify().ok );
+    TreeMgr::destroy();
+}
+
+TEST_CASE( "pbtree sequential appends pack leaves", "[test_pbtree]" )
+{
+    using Tree = pmm::pbtree<std::uint64_t, std::uint64_t, TreeMgr>;
+    REQUIRE( TreeMgr::create( 2 * 1024 * 1024 ) );
+    {
+        Tree tree( "btree/append" );
+        const std::uint64_t count = 20000;
+        for ( std::uint64_t i = 0; i < count; ++i )
+            REQUIRE( tree.insert( i, i * 3 ) );
+        REQUIRE( tree.size() == count );
+        REQUIRE( tree.leaf_count() == ( count + Tree::leaf_capacity - 1 ) / Tree::leaf_capacity );
+        std::uint64_t sum = 0;
+        REQUIRE( tree.for_each( [&]( std::uint64_t, std::uint64_t v ) { sum += v; } ) == count );
+        REQUIRE( sum == 3 * count * ( count - 1 ) / 2 );
+        std::uint64_t expect = 100;
+        REQUIRE( tree.for_each_range( 100, 5000,
+                                      [&]( std::uint64_t k, std::uint64_t )
+                                      {
+                                          REQUIRE( k == expect );
+                                          ++expect;
+                                      } ) == 4900 );
+        tree.clear();
+        REQUIRE( tree.empty() );
+    }
+    REQUIRE( TreeMgr::verify().ok );
+    REQUIRE( TreeMgr::alloc_block_count() < 16 );
+    TreeMgr::destroy();
+}
+
+TEST_CASE( "pbtree survives save/load", "[test_pbtree]" )
+{
+    using Tree  = pmm::pbtree<std::int32_t, std::int32_t, TreeMgr>;
+    using Tree2 = pmm::pbtree<std::int32_t, std::int32_t, TreeMgr2>;
+    const char* file = "test_pbtree.dat";
+    std::remove( file );
+    REQUIRE( TreeMgr::create( 1024 * 1024 ) );
+    {
+        Tree tree( "btree/persist" );
+        for ( std::int32_t i = 0; i < 3000; ++i )
+            REQUIRE( tree.insert( ( i * 7919 ) % 3000, i ) );
+        REQUIRE( pmm::save_manager<TreeMgr>( file ) );
+    }
+    std::size_t total = TreeMgr::total_size();
+    TreeMgr::destroy();
+
+    REQUIRE( TreeMgr2::create( total ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<TreeMgr2>( file, vr ) );
+    {
+        Tree2 tree( "btree/persist" );
+        REQUIRE( tree.size() == 3000 );
+        std::int32_t prev = -1;
+        for ( auto it = tree.begin(); it != tree.end(); ++it )
+        {
+            REQUIRE( it.key() == prev + 1 );
+            prev = it.key();
+        }
+        REQUIRE( tree.insert( 5000, 1 ) );
+        REQUIRE( *tree.find( 5000 ) == 1 );
+    }
+    TreeMgr2::destroy();
+    std::remove( file );
+}
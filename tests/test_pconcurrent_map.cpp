@@ -0,0 +1,200 @@
+/**
+ * @file test_pconcurrent_map.cpp
+ * @brief Tests for pconcurrent_map: a pmap striped by key hash with one shared_mutex per stripe.
+ *
+ * Verifies:
+ *  - insert/find/update/erase/size/clear agree with std::map on one thread
+ *  - every stripe is its own named pmap domain, so the data survives save/load
+ *  - disjoint-key writers and concurrent readers on many threads lose no updates
+ *  - readers stay valid while concurrent inserts relocate a growing heap image
+ */
+
+#include "pmm/io.h"
+#include "pmm/pconcurrent_map.h"
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+using ConcMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3601>;
+using ConcMgr2 = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3602>;
+using ConcMt   = pmm::PersistMemoryManager<pmm::PersistentDataConfig, 3603>;
+using ConcGrow = pmm::PersistMemoryManager<pmm::PersistentDataConfig, 3604>;
+
+TEST_CASE( "pconcurrent_map basic operations match std::map", "[test_pconcurrent_map]" )
+{
+    using Map = pmm::pconcurrent_map<std::uint32_t, std::uint64_t, ConcMgr>;
+    REQUIRE( ConcMgr::create( 256 * 1024 ) );
+    {
+        Map map( "conc/basic" );
+        REQUIRE( map.is_bound() );
+        std::map<std::uint32_t, std::uint64_t> ref;
+        std::mt19937                            rng( 36 );
+        for ( int i = 0; i < 4000; ++i )
+        {
+            std::uint32_t k = rng() % 1500;
+            switch ( rng() % 4 )
+            {
+            case 0:
+                REQUIRE( map.erase( k ) == ( ref.erase( k ) == 1 ) );
+                break;
+            case 1:
+                REQUIRE( map.update( k, []( std::uint64_t& v ) { v += 10; } ) == ( ref.count( k ) == 1 ) );
+                if ( ref.count( k ) == 1 )
+                    ref[k] += 10;
+                break;
+            default:
+                REQUIRE( map.insert( k, i ) );
+                ref[k] = static_cast<std::uint64_t>( i );
+                break;
+            }
+        }
+        REQUIRE( map.size() == ref.size() );
+        for ( const auto& kv : ref )
+        {
+            std::uint64_t v = 0;
+            REQUIRE( map.find( kv.first, v ) );
+            REQUIRE( v == kv.second );
+        }
+        std::size_t seen = 0;
+        map.for_each(
+            [&]( const std::uint32_t& k, const std::uint64_t& v )
+            {
+                REQUIRE( ref.at( k ) == v );
+                ++seen;
+            } );
+        REQUIRE( seen == ref.size() );
+        map.clear();
+        REQUIRE( map.size() == 0 );
+        REQUIRE_FALSE( map.contains( 1 ) );
+    }
+    REQUIRE( ConcMgr::verify().ok );
+    ConcMgr::destroy();
+}
+
+TEST_CASE( "pconcurrent_map stripes survive save/load", "[test_pconcurrent_map]" )
+{
+    using Map1         = pmm::pconcurrent_map<int, int, ConcMgr, 4>;
+    using Map2         = pmm::pconcurrent_map<int, int, ConcMgr2, 4>;
+    const char* kImage = "test_pconcurrent_map.img";
+    REQUIRE( ConcMgr::create( 128 * 1024 ) );
+    {
+        Map1 map( "conc/saved" );
+        for ( int i = 0; i < 300; ++i )
+            REQUIRE( map.insert( i, i * i ) );
+    }
+    REQUIRE( pmm::save_manager<ConcMgr>( kImage ) );
+    REQUIRE( ConcMgr2::create( ConcMgr::total_size() ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<ConcMgr2>( kImage, vr ) );
+    {
+        Map2 map( "conc/saved" );
+        REQUIRE( map.size() == 300 );
+        int v = 0;
+        REQUIRE( map.find( 17, v ) );
+        REQUIRE( v == 289 );
+    }
+    ConcMgr2::destroy();
+    ConcMgr::destroy();
+    std::remove( kImage );
+}
+
+TEST_CASE( "pconcurrent_map parallel writers and readers", "[test_pconcurrent_map]" )
+{
+    using Map = pmm::pconcurrent_map<std::uint32_t, std::uint32_t, ConcMt, 16>;
+    REQUIRE( ConcMt::create( 8 * 1024 * 1024 ) );
+    {
+        Map                      map;
+        constexpr std::uint32_t  kThreads = 4;
+        constexpr std::uint32_t  kPerThr  = 3000;
+        std::atomic<bool>        stop{ false };
+        std::atomic<std::size_t> bad{ 0 };
+        std::vector<std::thread> writers;
+        for ( std::uint32_t t = 0; t < kThreads; ++t )
+        {
+            writers.emplace_back(
+                [&, t]()
+                {
+                    for ( std::uint32_t i = 0; i < kPerThr; ++i )
+                        map.insert( i * kThreads + t, t );
+                    for ( std::uint32_t i = 0; i < kPerThr; i += 2 )
+                        map.erase( i * kThreads + t );
+                } );
+        }
+        std::thread reader(
+            [&]()
+            {
+                while ( !stop.load() )
+                {
+                    for ( std::uint32_t k = 0; k < 1000; ++k )
+                    {
+                        std::uint32_t v = 0;
+                        if ( map.find( k, v ) && v != k % kThreads )
+                            ++bad;
+                    }
+                }
+            } );
+        for ( auto& w : writers )
+            w.join();
+        stop = true;
+        reader.join();
+        REQUIRE( bad.load() == 0 );
+        REQUIRE( map.size() == kThreads * kPerThr / 2 );
+        for ( std::uint32_t k = 0; k < kThreads * kPerThr; ++k )
+            REQUIRE( map.contains( k ) == ( ( k / kThreads ) % 2 == 1 ) );
+    }
+    REQUIRE( ConcMt::verify().ok );
+    ConcMt::destroy();
+}
+
+TEST_CASE( "pconcurrent_map readers survive heap relocation by concurrent inserts", "[test_pconcurrent_map]" )
+{
+    using Map = pmm::pconcurrent_map<std::uint32_t, std::uint32_t, ConcGrow, 4>;
+    REQUIRE( ConcGrow::create( 64 * 1024 ) );
+    const std::size_t initial = ConcGrow::total_size();
+    {
+        Map                      map( "conc/grow" );
+        constexpr std::uint32_t  kThreads = 3;
+        constexpr std::uint32_t  kPerThr  = 4000;
+        std::atomic<bool>        stop{ false };
+        std::atomic<std::size_t> bad{ 0 };
+        std::vector<std::thread> writers;
+        for ( std::uint32_t t = 0; t < kThreads; ++t )
+        {
+            writers.emplace_back(
+                [&, t]()
+                {
+                    for ( std::uint32_t i = 0; i < kPerThr; ++i )
+                        if ( !map.insert( i * kThreads + t, i * kThreads + t ) )
+                            ++bad;
+                } );
+        }
+        std::thread reader(
+            [&]()
+            {
+                while ( !stop.load() )
+                {
+                    map.for_each(
+                        [&]( const std::uint32_t& k, const std::uint32_t& v )
+                        {
+                            if ( k != v )
+                                ++bad;
+                        } );
+                }
+            } );
+        for ( auto& w : writers )
+            w.join();
+        stop = true;
+        reader.join();
+        REQUIRE( bad.load() == 0 );
+        REQUIRE( map.size() == kThreads * kPerThr );
+    }
+    REQUIRE( ConcGrow::total_size() > initial );
+    ConcGrow::destroy();
+}
@@ -0,0 +1,191 @@
+/**
+ * @file test_phashmap.cpp
+ * @brief Tests for phashmap: open-addressing hash map with control bytes and incremental rehash.
+ *
+ * Verifies:
+ *  - insert/find/erase/assign agree with std::unordered_map under a random workload
+ *  - growth migrates old slots a few groups per operation while lookups keep working
+ *  - tombstones are purged by a same-capacity rehash instead of unbounded growth
+ *  - clear() releases every table block; reserve() pre-sizes the table
+ *  - the table survives save/load through its named forest domain
+ *  - anonymous handles constructed from several threads get distinct domains
+ */
+
+#include "pmm/io.h"
+#include "pmm/phashmap.h"
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using HashMgr   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3101>;
+using HashMgr2  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3102>;
+using HashMgrMt = pmm::PersistMemoryManager<pmm::PersistentDataConfig, 3103>;
+
+struct PointKey
+{
+    std::int32_t x;
+    std::int32_t y;
+    bool         operator==( const PointKey& o ) const noexcept { return x == o.x && y == o.y; }
+};
+
+TEST_CASE( "phashmap matches unordered_map under random workload", "[test_phashmap]" )
+{
+    using Map = pmm::phashmap<std::uint64_t, std::uint32_t, HashMgr>;
+    REQUIRE( HashMgr::create( 1024 * 1024 ) );
+    {
+        Map map( "hash/random" );
+        REQUIRE( map.is_bound() );
+        REQUIRE( map.empty() );
+        REQUIRE( map.find( 1 ) == nullptr );
+        REQUIRE_FALSE( map.erase( 1 ) );
+        std::unordered_map<std::uint64_t, std::uint32_t> ref;
+        std::mt19937_64                                  rng( 31 );
+        bool                                             saw_rehash = false;
+        for ( std::uint32_t i = 0; i < 6000; ++i )
+        {
+            std::uint64_t k = rng() % 1500;
+            if ( rng() % 4 == 0 )
+                REQUIRE( map.erase( k ) == ( ref.erase( k ) == 1 ) );
+            else
+            {
+                REQUIRE( map.insert( k, i ) );
+                ref[k] = i;
+            }
+            saw_rehash = saw_rehash || map.rehash_in_progress();
+            REQUIRE( map.size() == ref.size() );
+        }
+        REQUIRE( saw_rehash );
+        for ( std::uint64_t k = 0; k < 1500; ++k )
+        {
+            const std::uint32_t* v  = map.find( k );
+            auto                 it = ref.find( k );
+            REQUIRE( ( v != nullptr ) == ( it != ref.end() ) );
+            if ( v != nullptr )
+                REQUIRE( *v == it->second );
+        }
+        std::size_t visited = 0;
+        map.for_each(
+            [&]( std::uint64_t k, std::uint32_t v )
+            {
+                REQUIRE( ref.at( k ) == v );
+                ++visited;
+            } );
+        REQUIRE( visited == ref.size() );
+        REQUIRE( map.capacity() * 7 >= map.size() * 8 );
+        map.clear();
+        REQUIRE( map.empty() );
+        REQUIRE( map.root_index() == 0 );
+    }
+    REQUIRE( HashMgr::verify().ok );
+    HashMgr::destroy();
+}
+
+TEST_CASE( "phashmap growth is incremental and tombstones do not grow the table", "[test_phashmap]" )
+{
+    using Map = pmm::phashmap<std::uint32_t, std::uint32_t, HashMgr>;
+    REQUIRE( HashMgr::create( 1024 * 1024 ) );
+    {
+        Map map( "hash/growth" );
+        for ( std::uint32_t i = 0; i < 14; ++i )
+            REQUIRE( map.insert( i, i * 2 ) );
+        REQUIRE( map.capacity() == 16 );
+        REQUIRE_FALSE( map.rehash_in_progress() );
+        for ( std::uint32_t i = 14; i < 300; ++i )
+            REQUIRE( map.insert( i, i * 2 ) );
+        for ( std::uint32_t i = 0; i < 300; ++i )
+            REQUIRE( *map.find( i ) == i * 2 );
+
+        std::size_t cap = map.capacity();
+        for ( std::uint32_t round = 0; round < 50; ++round )
+        {
+            for ( std::uint32_t i = 0; i < 100; ++i )
+                REQUIRE( map.insert( 1000 + round * 100 + i, i ) );
+            for ( std::uint32_t i = 0; i < 100; ++i )
+                REQUIRE( map.erase( 1000 + round * 100 + i ) );
+        }
+        REQUIRE( map.size() == 300 );
+        REQUIRE( map.capacity() <= cap * 2 );
+
+        Map reserved( "hash/reserved" );
+        REQUIRE( reserved.reserve( 1000 ) );
+        std::size_t reserved_cap = reserved.capacity();
+        REQUIRE( reserved_cap * 7 >= 1000 * 8 );
+        for ( std::uint32_t i = 0; i < 1000; ++i )
+            REQUIRE( reserved.insert( i, i ) );
+        REQUIRE( reserved.capacity() == reserved_cap );
+    }
+    REQUIRE( HashMgr::verify().ok );
+    HashMgr::destroy();
+}
+
+TEST_CASE( "phashmap with struct keys survives save/load", "[test_phashmap]" )
+{
+    const char* file = "test_phashmap.dat";
+    std::remove( file );
+    REQUIRE( HashMgr::create( 512 * 1024 ) );
+    {
+        pmm::phashmap<PointKey, std::int64_t, HashMgr> map( "hash/points" );
+        for ( std::int32_t i = 0; i < 200; ++i )
+            REQUIRE( map.insert( PointKey{ i, -i }, i * 1000 ) );
+        REQUIRE( map.erase( PointKey{ 5, -5 } ) );
+        REQUIRE( pmm::save_manager<HashMgr>( file ) );
+    }
+    std::size_t total = HashMgr::total_size();
+    HashMgr::destroy();
+
+    REQUIRE( HashMgr2::create( total ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<HashMgr2>( file, vr ) );
+    {
+        pmm::phashmap<PointKey, std::int64_t, HashMgr2> map( "hash/points" );
+        REQUIRE( map.size() == 199 );
+        REQUIRE( map.find( PointKey{ 5, -5 } ) == nullptr );
+        for ( std::int32_t i = 0; i < 200; ++i )
+        {
+            if ( i != 5 )
+                REQUIRE( *map.find( PointKey{ i, -i } ) == i * 1000 );
+        }
+        REQUIRE( map.insert( PointKey{ 5, -5 }, 7 ) );
+        REQUIRE( *map.find( PointKey{ 5, -5 } ) == 7 );
+    }
+    HashMgr2::destroy();
+    std::remove( file );
+}
+
+TEST_CASE( "anonymous phashmap handles get distinct domains across threads", "[test_phashmap]" )
+{
+    using Map = pmm::phashmap<std::uint32_t, std::uint32_t, HashMgrMt>;
+    REQUIRE( HashMgrMt::create( 1024 * 1024 ) );
+    constexpr int                     kThreads   = 4;
+    constexpr int                     kPerThread = 32;
+    std::vector<std::unique_ptr<Map>> maps( kThreads * kPerThread );
+    std::vector<std::thread>          workers;
+    for ( int t = 0; t < kThreads; ++t )
+        workers.emplace_back(
+            [&maps, t]
+            {
+                for ( int i = 0; i < kPerThread; ++i )
+                    maps[static_cast<std::size_t>( t * kPerThread + i )] = std::make_unique<Map>();
+            } );
+    for ( auto& w : workers )
+        w.join();
+    std::set<std::string> names;
+    for ( auto& m : maps )
+    {
+        REQUIRE( m->is_bound() );
+        names.insert( m->domain_name() );
+    }
+    REQUIRE( names.size() == maps.size() );
+    maps.clear();
+    HashMgrMt::destroy();
+}
@@ -0,0 +1,230 @@
+/**
+ * @file test_plru_cache.cpp
+ * @brief Tests for plru_cache, the persistent LRU/CLOCK cache (pmm/plru_cache.h).
+ *
+ * Verifies:
+ *  - exact LRU evicts the least recently used entry and reports it through the callback
+ *  - byte accounting: bytes() is entry_charge per entry, capacity changes evict to fit
+ *  - a random workload matches a reference LRU model across bucket-array growth
+ *  - CLOCK gives referenced entries a second chance, and concurrent hits work under the shared lock
+ *  - contents and recency order survive save/load
+ *  - two handles bound to the same domain share its lock across threads
+ */
+
+#include "pmm/io.h"
+#include "pmm/plru_cache.h"
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <thread>
+#include <vector>
+
+using LruMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4701>;
+using LruMgr2 = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4702>;
+
+using Lru   = pmm::plru_cache<std::uint64_t, std::uint64_t, LruMgr>;
+using Clock = pmm::plru_cache<std::uint64_t, std::uint64_t, LruMgr, pmm::CachePolicy::Clock>;
+
+template <typename CacheT> static std::vector<std::uint64_t> keys_by_recency( const CacheT& cache )
+{
+    std::vector<std::uint64_t> out;
+    cache.for_each( [&]( const std::uint64_t& k, const std::uint64_t& ) { out.push_back( k ); } );
+    return out;
+}
+
+static void record_eviction( const std::uint64_t& key, const std::uint64_t&, void* ctx )
+{
+    static_cast<std::vector<std::uint64_t>*>( ctx )->push_back( key );
+}
+
+TEST_CASE( "plru_cache evicts the least recently used entry", "[test_plru_cache]" )
+{
+    REQUIRE( LruMgr::create( 256 * 1024 ) );
+    Lru cache( "lru", 4 * Lru::entry_charge );
+    REQUIRE( cache.is_bound() );
+    std::vector<std::uint64_t> evicted;
+    cache.set_eviction_callback( record_eviction, &evicted );
+    for ( std::uint64_t k = 1; k <= 4; ++k )
+        REQUIRE( cache.put( k, k * 10 ) );
+    std::uint64_t v = 0;
+    REQUIRE( cache.get( 1, v ) );
+    REQUIRE( v == 10 );
+    REQUIRE( cache.put( 5, 50 ) );
+    REQUIRE( evicted == std::vector<std::uint64_t>{ 2 } );
+    REQUIRE( keys_by_recency( cache ) == std::vector<std::uint64_t>{ 5, 1, 4, 3 } );
+    REQUIRE( cache.bytes() == 4 * Lru::entry_charge );
+    REQUIRE( !cache.contains( 2 ) );
+
+    REQUIRE( cache.put( 3, 33 ) );
+    REQUIRE( keys_by_recency( cache ) == std::vector<std::uint64_t>{ 3, 5, 1, 4 } );
+    cache.set_capacity_bytes( 2 * Lru::entry_charge );
+    REQUIRE( evicted == std::vector<std::uint64_t>{ 2, 4, 1 } );
+    REQUIRE( cache.size() == 2 );
+    REQUIRE( cache.erase( 5 ) );
+    REQUIRE( !cache.erase( 5 ) );
+    REQUIRE( cache.bytes() == Lru::entry_charge );
+    REQUIRE( cache.evict() );
+    REQUIRE( evicted.back() == 3 );
+    REQUIRE( !cache.evict() );
+
+    cache.set_capacity_bytes( Lru::entry_charge - 1 );
+    REQUIRE( !cache.put( 9, 9 ) );
+    cache.set_capacity_bytes( 8 * Lru::entry_charge );
+    for ( std::uint64_t k = 0; k < 6; ++k )
+        REQUIRE( cache.put( k, k ) );
+    cache.clear();
+    REQUIRE( cache.empty() );
+    REQUIRE( cache.bytes() == 0 );
+    REQUIRE( cache.put( 1, 1 ) );
+    LruMgr::destroy();
+}
+
+TEST_CASE( "plru_cache matches a reference LRU model", "[test_plru_cache]" )
+{
+    REQUIRE( LruMgr::create( 1024 * 1024 ) );
+    constexpr std::size_t kCapacity = 300;
+    using Slot = std::pair<std::uint64_t, std::list<std::uint64_t>::iterator>;
+    Lru                           cache( "model", kCapacity * Lru::entry_charge );
+    std::list<std::uint64_t>      order;
+    std::map<std::uint64_t, Slot> ref;
+    std::uint64_t                 x  = 88172645463325252ull;
+    bool                          ok = true;
+    for ( int step = 0; step < 20000; ++step )
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        const std::uint64_t key = x % 700;
+        auto                it  = ref.find( key );
+        if ( ( x >> 20 ) % 3 == 0 )
+        {
+            std::uint64_t v   = 0;
+            const bool    hit = cache.get( key, v );
+            ok                = ok && hit == ( it != ref.end() );
+            if ( it != ref.end() )
+            {
+                ok = ok && v == it->second.first;
+                order.splice( order.begin(), order, it->second.second );
+            }
+        }
+        else
+        {
+            REQUIRE( cache.put( key, step ) );
+            if ( it != ref.end() )
+            {
+                it->second.first = static_cast<std::uint64_t>( step );
+                order.splice( order.begin(), order, it->second.second );
+            }
+            else
+            {
+                if ( ref.size() == kCapacity )
+                {
+                    ref.erase( order.back() );
+                    order.pop_back();
+                }
+                order.push_front( key );
+                ref[key] = { static_cast<std::uint64_t>( step ), order.begin() };
+            }
+        }
+    }
+    REQUIRE( ok );
+    REQUIRE( cache.size() == ref.size() );
+    REQUIRE( keys_by_recency( cache ) == std::vector<std::uint64_t>( order.begin(), order.end() ) );
+    LruMgr::destroy();
+}
+
+TEST_CASE( "plru_cache CLOCK gives referenced entries a second chance", "[test_plru_cache]" )
+{
+    REQUIRE( LruMgr::create( 256 * 1024 ) );
+    Clock                      cache( "clock", 3 * Clock::entry_charge );
+    std::vector<std::uint64_t> evicted;
+    cache.set_eviction_callback( record_eviction, &evicted );
+    for ( std::uint64_t k = 1; k <= 3; ++k )
+        REQUIRE( cache.put( k, k ) );
+    std::uint64_t v = 0;
+    REQUIRE( cache.get( 1, v ) );
+    REQUIRE( keys_by_recency( cache ) == std::vector<std::uint64_t>{ 3, 2, 1 } );
+    REQUIRE( cache.put( 4, 4 ) );
+    REQUIRE( evicted == std::vector<std::uint64_t>{ 2 } );
+    REQUIRE( cache.contains( 1 ) );
+
+    std::vector<std::thread> readers;
+    std::uint64_t            hits[4]{};
+    for ( int t = 0; t < 4; ++t )
+        readers.emplace_back(
+            [&cache, &hits, t]
+            {
+                std::uint64_t out = 0;
+                for ( int i = 0; i < 2000; ++i )
+                    hits[t] += cache.get( static_cast<std::uint64_t>( 1 + i % 4 ), out ) ? 1 : 0;
+            } );
+    for ( std::uint64_t k = 10; k < 200; ++k )
+        cache.put( k, k );
+    for ( auto& r : readers )
+        r.join();
+    REQUIRE( cache.size() == 3 );
+    REQUIRE( cache.bytes() == 3 * Clock::entry_charge );
+    LruMgr::destroy();
+}
+
+TEST_CASE( "plru_cache handles on one domain share a lock across threads", "[test_plru_cache]" )
+{
+    REQUIRE( LruMgr::create( 1024 * 1024 ) );
+    {
+        Lru                      first( "shared", 64 * Lru::entry_charge );
+        Lru                      second( "shared" );
+        std::vector<std::thread> workers;
+        for ( Lru* cache : { &first, &second } )
+            workers.emplace_back(
+                [cache]
+                {
+                    std::uint64_t out = 0;
+                    for ( std::uint64_t i = 0; i < 2000; ++i )
+                    {
+                        cache->put( i % 200, i );
+                        cache->get( ( i * 7 ) % 200, out );
+                    }
+                } );
+        for ( auto& w : workers )
+            w.join();
+        REQUIRE( first.size() == 64 );
+        REQUIRE( second.size() == 64 );
+        REQUIRE( keys_by_recency( first ) == keys_by_recency( second ) );
+    }
+    LruMgr::destroy();
+}
+
+TEST_CASE( "plru_cache contents survive save and load", "[test_plru_cache]" )
+{
+    const char* file = "test_plru_cache.dat";
+    REQUIRE( LruMgr::create( 256 * 1024 ) );
+    {
+        Lru cache( "persist", 64 * Lru::entry_charge );
+        for ( std::uint64_t k = 0; k < 40; ++k )
+            REQUIRE( cache.put( k, k * k ) );
+        std::uint64_t v = 0;
+        REQUIRE( cache.get( 7, v ) );
+    }
+    REQUIRE( pmm::save_manager<LruMgr>( file ) );
+    REQUIRE( LruMgr2::create( LruMgr::total_size() ) );
+    LruMgr::destroy();
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<LruMgr2>( file, vr ) );
+    std::remove( file );
+
+    pmm::plru_cache<std::uint64_t, std::uint64_t, LruMgr2> cache( "persist" );
+    REQUIRE( cache.size() == 40 );
+    REQUIRE( cache.capacity_bytes() == 64 * Lru::entry_charge );
+    const std::vector<std::uint64_t> order = keys_by_recency( cache );
+    REQUIRE( order.front() == 7 );
+    REQUIRE( order[1] == 39 );
+    REQUIRE( order.back() == 0 );
+    std::uint64_t v = 0;
+    REQUIRE( cache.get( 12, v ) );
+    REQUIRE( v == 144 );
+    LruMgr2::destroy();
+}
@@ -0,0 +1,210 @@
+/**
+ * @file test_pmap_bulk_load.cpp
+ * @brief Tests for pmap::bulk_load() and allocate_typed_batch().
+ *
+ * Verifies:
+ *  - sorted input builds a perfectly balanced AVL tree with exact subtree counts
+ *  - nodes are allocated as one contiguous run in key order when a free run is available
+ *  - unsorted input with duplicates is sorted in a side buffer; the last value of a key wins
+ *  - loading into a non-empty map merges through insert()
+ *  - a failed side-buffer allocation returns false and leaves the map empty
+ *  - a failed merge into a non-empty map removes the keys it added and restores the values it replaced
+ *  - the bulk-loaded map supports find/erase/insert and passes verify()
+ */
+
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <new>
+#include <random>
+#include <utility>
+#include <vector>
+
+using BulkMgr = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3401>;
+
+static int g_copies_left = -1;
+
+struct FragileValue
+{
+    int v = 0;
+    FragileValue() = default;
+    FragileValue( int x ) : v( x ) {}
+    FragileValue( const FragileValue& o ) : v( o.v )
+    {
+        if ( g_copies_left == 0 )
+            throw std::bad_alloc();
+        if ( g_copies_left > 0 )
+            --g_copies_left;
+    }
+    FragileValue& operator=( const FragileValue& ) = default;
+};
+
+template <typename Map> static int check_tree( typename Map::node_pptr p, std::uint64_t& count )
+{
+    if ( p.is_null() )
+        return 0;
+    std::uint64_t lc = 0;
+    std::uint64_t rc = 0;
+    int           lh = check_tree<Map>( pmm::detail::pptr_get_left( p ), lc );
+    int           rh = check_tree<Map>( pmm::detail::pptr_get_right( p ), rc );
+    REQUIRE( ( lh - rh <= 1 && rh - lh <= 1 ) );
+    REQUIRE( p.tree_node_unchecked().avl_height == 1 + std::max( lh, rh ) );
+    count = 1 + lc + rc;
+    REQUIRE( p->subtree_count == count );
+    return 1 + std::max( lh, rh );
+}
+
+TEST_CASE( "pmap bulk_load builds a balanced contiguous tree from sorted input", "[test_pmap_bulk_load]" )
+{
+    using Map = pmm::pmap<std::uint32_t, std::uint64_t, BulkMgr>;
+    REQUIRE( BulkMgr::create( 256 * 1024 ) );
+    {
+        Map map( "bulk/sorted" );
+        std::vector<std::pair<std::uint32_t, std::uint64_t>> input;
+        for ( std::uint32_t i = 0; i < 20000; ++i )
+            input.emplace_back( i * 3, std::uint64_t{ i } * 7 );
+        REQUIRE( map.bulk_load( input ) );
+        REQUIRE( map.size() == input.size() );
+
+        std::uint64_t count  = 0;
+        int           height = check_tree<Map>( Map::node_pptr( map.root_index() ), count );
+        REQUIRE( count == input.size() );
+        REQUIRE( height <= 15 );
+
+        std::uint32_t expect = 0;
+        auto          prev   = Map::node_pptr();
+        for ( auto it = map.begin(); it != map.end(); ++it )
+        {
+            REQUIRE( ( *it )->key == expect );
+            REQUIRE( ( *it )->value == std::uint64_t{ expect / 3 } * 7 );
+            if ( !prev.is_null() )
+                REQUIRE( ( *it ).offset() > prev.offset() );
+            prev = *it;
+            expect += 3;
+        }
+        REQUIRE( map.nth( 1234 )->key == 1234 * 3 );
+        REQUIRE( map.erase( 300 ) );
+        REQUIRE( !map.insert( 301, 1 ).is_null() );
+        REQUIRE( map.size() == input.size() );
+        REQUIRE( BulkMgr::verify().ok );
+        map.clear();
+    }
+    BulkMgr::destroy();
+}
+
+TEST_CASE( "pmap bulk_load sorts unsorted input and merges into non-empty maps", "[test_pmap_bulk_load]" )
+{
+    using Map = pmm::pmap<int, int, BulkMgr>;
+    REQUIRE( BulkMgr::create( 256 * 1024 ) );
+    {
+        Map                            map( "bulk/unsorted" );
+        std::list<std::pair<int, int>> input;
+        std::map<int, int>             ref;
+        std::mt19937                   rng( 34 );
+        for ( int i = 0; i < 3000; ++i )
+        {
+            int k = static_cast<int>( rng() % 1000 );
+            input.emplace_back( k, i );
+            ref[k] = i;
+        }
+        REQUIRE( map.bulk_load( input.begin(), input.end() ) );
+        REQUIRE( map.size() == ref.size() );
+        std::uint64_t count = 0;
+        check_tree<Map>( Map::node_pptr( map.root_index() ), count );
+        auto it = map.begin();
+        for ( const auto& kv : ref )
+        {
+            REQUIRE( ( *it )->key == kv.first );
+            REQUIRE( ( *it )->value == kv.second );
+            ++it;
+        }
+
+        std::vector<std::pair<int, int>> extra{ { -1, 5 }, { 0, 99 }, { 2000, 7 } };
+        REQUIRE( map.bulk_load( extra ) );
+        REQUIRE( map.find( -1 )->value == 5 );
+        REQUIRE( map.find( 0 )->value == 99 );
+        REQUIRE( map.contains( 2000 ) );
+        count = 0;
+        check_tree<Map>( Map::node_pptr( map.root_index() ), count );
+        REQUIRE( map.size() == count );
+
+        Map empty_map( "bulk/empty" );
+        std::vector<std::pair<int, int>> none;
+        REQUIRE( empty_map.bulk_load( none ) );
+        REQUIRE( empty_map.empty() );
+    }
+    REQUIRE( BulkMgr::verify().ok );
+    BulkMgr::destroy();
+}
+
+TEST_CASE( "pmap bulk_load returns false when the side buffer cannot be filled", "[test_pmap_bulk_load]" )
+{
+    using Map = pmm::pmap<int, FragileValue, BulkMgr>;
+    REQUIRE( BulkMgr::create( 256 * 1024 ) );
+    {
+        Map                                     map( "bulk/fragile" );
+        std::list<std::pair<int, FragileValue>> input;
+        for ( int i = 0; i < 64; ++i )
+            input.emplace_back( 64 - i, FragileValue( i ) );
+        std::size_t blocks = BulkMgr::alloc_block_count();
+        g_copies_left      = 10;
+        REQUIRE_FALSE( map.bulk_load( input.begin(), input.end() ) );
+        g_copies_left = -1;
+        REQUIRE( map.empty() );
+        REQUIRE( BulkMgr::alloc_block_count() == blocks );
+        REQUIRE( map.bulk_load( input.begin(), input.end() ) );
+        REQUIRE( map.size() == 64 );
+        REQUIRE( map.find( 1 )->value.v == 63 );
+    }
+    BulkMgr::destroy();
+}
+
+TEST_CASE( "pmap bulk_load rolls back a failed merge into a non-empty map", "[test_pmap_bulk_load]" )
+{
+    using Map = pmm::pmap<int, FragileValue, BulkMgr>;
+    REQUIRE( BulkMgr::create( 256 * 1024 ) );
+    {
+        Map map( "bulk/merge" );
+        for ( int k = 1; k <= 10; ++k )
+            REQUIRE_FALSE( map.insert( k, FragileValue( 100 + k ) ).is_null() );
+        std::vector<std::pair<int, FragileValue>> input;
+        for ( int k = 5; k <= 10; ++k )
+        {
+            input.emplace_back( k + 6, FragileValue( k + 6 ) );
+            input.emplace_back( k, FragileValue( k ) );
+        }
+        std::size_t blocks = BulkMgr::alloc_block_count();
+        g_copies_left      = 3;
+        REQUIRE_FALSE( map.bulk_load( input ) );
+        g_copies_left = -1;
+        REQUIRE( map.size() == 10 );
+        REQUIRE( BulkMgr::alloc_block_count() == blocks );
+        for ( int k = 1; k <= 10; ++k )
+            REQUIRE( map.find( k )->value.v == 100 + k );
+        for ( int k = 11; k <= 16; ++k )
+            REQUIRE_FALSE( map.contains( k ) );
+        REQUIRE( map.bulk_load( input ) );
+        REQUIRE( map.size() == 16 );
+        REQUIRE( map.find( 5 )->value.v == 5 );
+    }
+    REQUIRE( BulkMgr::verify().ok );
+    BulkMgr::destroy();
+}
+
+TEST_CASE( "allocate_typed_batch returns a contiguous run and falls back when fragmented", "[test_pmap_bulk_load]" )
+{
+    REQUIRE( BulkMgr::create( 64 * 1024 ) );
+    std::vector<BulkMgr::pptr<std::uint64_t>> run( 100 );
+    REQUIRE( BulkMgr::allocate_typed_batch<std::uint64_t>( run.size(), run.data() ) );
+    for ( std::size_t i = 1; i < run.size(); ++i )
+        REQUIRE( run[i].offset() == run[i - 1].offset() + ( run[1].offset() - run[0].offset() ) );
+    for ( auto p : run )
+        BulkMgr::deallocate_typed( p );
+    REQUIRE_FALSE( BulkMgr::allocate_typed_batch<std::uint64_t>( 0, run.data() ) );
+    REQUIRE( BulkMgr::verify().ok );
+    BulkMgr::destroy();
+}
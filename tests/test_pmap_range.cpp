@@ -0,0 +1,114 @@
+/**
+ * @file test_pmap_range.cpp
+ * @brief Tests for pmap ordered range queries, reverse iteration and the stack cursor.
+ *
+ * Verifies:
+ *  - lower_bound / upper_bound / equal_range agree with std::map for present, absent and out-of-range keys
+ *  - rbegin()/rend() visit keys in descending order
+ *  - seek() + cursor and for_each_range() visit exactly the keys in [lo, hi)
+ *  - the cursor stays correct on a tree reshaped by erase/insert
+ */
+
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+using RangeMgr = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3501>;
+using RangeMap = pmm::pmap<int, int, RangeMgr>;
+
+static int key_of( RangeMap::iterator it )
+{
+    return ( *it )->key;
+}
+
+TEST_CASE( "pmap lower_bound/upper_bound/equal_range match std::map", "[test_pmap_range]" )
+{
+    REQUIRE( RangeMgr::create( 256 * 1024 ) );
+    {
+        RangeMap           map( "range/bounds" );
+        std::map<int, int> ref;
+        for ( int i = 0; i < 500; ++i )
+        {
+            map.insert( i * 2, i );
+            ref[i * 2] = i;
+        }
+        for ( int k = -3; k < 1004; ++k )
+        {
+            auto lb  = map.lower_bound( k );
+            auto ub  = map.upper_bound( k );
+            auto rlb = ref.lower_bound( k );
+            auto rub = ref.upper_bound( k );
+            REQUIRE( ( lb == map.end() ) == ( rlb == ref.end() ) );
+            REQUIRE( ( ub == map.end() ) == ( rub == ref.end() ) );
+            if ( rlb != ref.end() )
+                REQUIRE( key_of( lb ) == rlb->first );
+            if ( rub != ref.end() )
+                REQUIRE( key_of( ub ) == rub->first );
+            auto range = map.equal_range( k );
+            REQUIRE( range.first == lb );
+            REQUIRE( range.second == ub );
+        }
+
+        RangeMap empty_map( "range/empty" );
+        REQUIRE( empty_map.lower_bound( 1 ) == empty_map.end() );
+        REQUIRE( empty_map.rbegin() == empty_map.rend() );
+        REQUIRE_FALSE( empty_map.seek( 0 ).valid() );
+    }
+    RangeMgr::destroy();
+}
+
+TEST_CASE( "pmap reverse iteration and cursor range scans", "[test_pmap_range]" )
+{
+    REQUIRE( RangeMgr::create( 256 * 1024 ) );
+    {
+        RangeMap           map( "range/scan" );
+        std::map<int, int> ref;
+        std::mt19937       rng( 35 );
+        for ( int i = 0; i < 2000; ++i )
+        {
+            int k = static_cast<int>( rng() % 5000 );
+            map.insert( k, i );
+            ref[k] = i;
+        }
+        for ( int i = 0; i < 500; ++i )
+        {
+            int k = static_cast<int>( rng() % 5000 );
+            REQUIRE( map.erase( k ) == ( ref.erase( k ) == 1 ) );
+        }
+
+        auto rit = ref.rbegin();
+        for ( auto it = map.rbegin(); it != map.rend(); ++it, ++rit )
+        {
+            REQUIRE( rit != ref.rend() );
+            REQUIRE( ( *it )->key == rit->first );
+        }
+        REQUIRE( rit == ref.rend() );
+
+        auto expect = ref.begin();
+        for ( auto c = map.first(); c.valid(); ++c, ++expect )
+        {
+            REQUIRE( expect != ref.end() );
+            REQUIRE( ( *c )->key == expect->first );
+        }
+        REQUIRE( expect == ref.end() );
+
+        for ( int t = 0; t < 200; ++t )
+        {
+            int              lo = static_cast<int>( rng() % 5200 ) - 100;
+            int              hi = lo + static_cast<int>( rng() % 800 );
+            std::vector<int> got;
+            size_t visited = map.for_each_range( lo, hi, [&]( const int& k, const int& ) { got.push_back( k ); } );
+            std::vector<int> want;
+            for ( auto it = ref.lower_bound( lo ); it != ref.end() && it->first < hi; ++it )
+                want.push_back( it->first );
+            REQUIRE( visited == want.size() );
+            REQUIRE( got == want );
+            REQUIRE( map.count_range( lo, hi ) == want.size() );
+        }
+    }
+    RangeMgr::destroy();
+}
@@ -0,0 +1,121 @@
+/**
+ * @file test_pmap_rank.cpp
+ * @brief Tests for pmap subtree counts: O(1) size(), nth(), rank() and count_range().
+ *
+ * Verifies:
+ *  - subtree counts stay equal to the real subtree sizes through inserts, rotations and erases
+ *  - nth(i) returns the i-th smallest key and a null pptr past the end
+ *  - rank(key) counts keys strictly below key, for present and absent keys
+ *  - count_range(lo, hi) counts keys in [lo, hi) and is 0 for empty ranges
+ *  - counts are persistent and remain valid after save/load
+ */
+
+#include "pmm/io.h"
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <random>
+
+using RankMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3301>;
+using RankMgr2 = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3302>;
+
+template <typename Map> static std::uint64_t check_counts( typename Map::node_pptr p )
+{
+    if ( p.is_null() )
+        return 0;
+    std::uint64_t n = 1 + check_counts<Map>( pmm::detail::pptr_get_left( p ) ) +
+                      check_counts<Map>( pmm::detail::pptr_get_right( p ) );
+    REQUIRE( p->subtree_count == n );
+    return n;
+}
+
+TEST_CASE( "pmap subtree counts back size, nth, rank and count_range", "[test_pmap_rank]" )
+{
+    using Map = pmm::pmap<int, int, RankMgr>;
+    REQUIRE( RankMgr::create( 512 * 1024 ) );
+    {
+        Map map( "rank/random" );
+        REQUIRE( map.size() == 0 );
+        REQUIRE( map.nth( 0 ).is_null() );
+        REQUIRE( map.rank( 5 ) == 0 );
+        std::map<int, int> ref;
+        std::mt19937       rng( 33 );
+        for ( int i = 0; i < 3000; ++i )
+        {
+            int k = static_cast<int>( rng() % 800 );
+            if ( rng() % 3 == 0 )
+                REQUIRE( map.erase( k ) == ( ref.erase( k ) == 1 ) );
+            else
+            {
+                REQUIRE( !map.insert( k, i ).is_null() );
+                ref[k] = i;
+            }
+            REQUIRE( map.size() == ref.size() );
+        }
+        Map::node_pptr root( map.root_index() );
+        REQUIRE( check_counts<Map>( root ) == ref.size() );
+
+        std::size_t i = 0;
+        for ( const auto& kv : ref )
+        {
+            Map::node_pptr p = map.nth( i );
+            REQUIRE( !p.is_null() );
+            REQUIRE( p->key == kv.first );
+            REQUIRE( map.rank( kv.first ) == i );
+            ++i;
+        }
+        REQUIRE( map.nth( ref.size() ).is_null() );
+        for ( int k = -5; k < 810; k += 7 )
+        {
+            auto expected = static_cast<std::size_t>( std::distance( ref.begin(), ref.lower_bound( k ) ) );
+            REQUIRE( map.rank( k ) == expected );
+        }
+        for ( int lo = -10; lo < 820; lo += 37 )
+        {
+            for ( int hi = lo - 20; hi < 820; hi += 53 )
+            {
+                std::size_t expected =
+                    lo < hi ? static_cast<std::size_t>( std::distance( ref.lower_bound( lo ), ref.lower_bound( hi ) ) )
+                            : 0;
+                REQUIRE( map.count_range( lo, hi ) == expected );
+            }
+        }
+        map.clear();
+        REQUIRE( map.size() == 0 );
+    }
+    RankMgr::destroy();
+}
+
+TEST_CASE( "pmap subtree counts survive save/load", "[test_pmap_rank]" )
+{
+    const char* file = "test_pmap_rank.dat";
+    std::remove( file );
+    REQUIRE( RankMgr::create( 256 * 1024 ) );
+    {
+        pmm::pmap<int, int, RankMgr> map( "rank/persist" );
+        for ( int i = 0; i < 500; ++i )
+            REQUIRE( !map.insert( i * 2, i ).is_null() );
+        REQUIRE( pmm::save_manager<RankMgr>( file ) );
+    }
+    std::size_t total = RankMgr::total_size();
+    RankMgr::destroy();
+
+    REQUIRE( RankMgr2::create( total ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<RankMgr2>( file, vr ) );
+    {
+        pmm::pmap<int, int, RankMgr2> map( "rank/persist" );
+        REQUIRE( map.size() == 500 );
+        REQUIRE( map.nth( 250 )->key == 500 );
+        REQUIRE( map.rank( 501 ) == 251 );
+        REQUIRE( map.count_range( 100, 200 ) == 50 );
+        REQUIRE( map.erase( 0 ) );
+        REQUIRE( map.nth( 0 )->key == 2 );
+        REQUIRE( map.size() == 499 );
+    }
+    RankMgr2::destroy();
+    std::remove( file );
+}
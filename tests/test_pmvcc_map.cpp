@@ -0,0 +1,270 @@
+/**
+ * @file test_pmvcc_map.cpp
+ * @brief Tests for pmvcc_map: path-copying AVL map with pinned read snapshots.
+ *
+ * Verifies:
+ *  - insert/erase/find through snapshots, ordered iteration, AVL balance
+ *  - a pinned snapshot keeps seeing its version while writers publish new ones
+ *  - retired nodes are reclaimed only after every snapshot that can see them is released
+ *  - the root survives save/load through its named forest domain
+ *  - concurrent readers scan pinned snapshots under the manager's shared lock
+ *  - a second live handle on the same domain is refused; destroying a handle frees its retired nodes
+ *  - retired nodes left behind by an unclean shutdown are reclaimed when the map is bound again
+ */
+
+#include "pmm/io.h"
+#include "pmm/pmm_presets.h"
+#include "pmm/pmvcc_map.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+using MvccMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 2901>;
+using MvccMgr2 = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 2902>;
+using MvccMt   = pmm::PersistMemoryManager<pmm::PersistentDataConfig, 2903>;
+
+template <typename Snap> static int value_of( const Snap& snap, int key )
+{
+    int value = -1;
+    REQUIRE( snap.find( key, value ) );
+    return value;
+}
+
+template <typename Map> static int check_balance( typename Map::index_type idx )
+{
+    if ( idx == 0 )
+        return 0;
+    auto* n  = MvccMgr::resolve_unchecked( typename Map::node_pptr( idx ) );
+    int   lh = check_balance<Map>( n->left );
+    int   rh = check_balance<Map>( n->right );
+    REQUIRE( ( lh - rh <= 1 && rh - lh <= 1 ) );
+    REQUIRE( n->height == static_cast<std::uint32_t>( 1 + ( lh > rh ? lh : rh ) ) );
+    return 1 + ( lh > rh ? lh : rh );
+}
+
+TEST_CASE( "pmvcc_map insert, find, erase and ordered scan", "[test_pmvcc_map]" )
+{
+    using Map = pmm::pmvcc_map<int, int, MvccMgr>;
+    REQUIRE( MvccMgr::create( 256 * 1024 ) );
+    {
+        Map map( "mvcc/basic" );
+        REQUIRE( map.is_bound() );
+        std::map<int, int> ref;
+        std::mt19937       rng( 29 );
+        for ( int i = 0; i < 400; ++i )
+        {
+            int k = static_cast<int>( rng() % 200 );
+            if ( rng() % 3 == 0 )
+                REQUIRE( map.erase( k ) == ( ref.erase( k ) == 1 ) );
+            else
+            {
+                REQUIRE( map.insert( k, i ) );
+                ref[k] = i;
+            }
+        }
+        auto snap = map.pin();
+        REQUIRE( snap.size() == ref.size() );
+        std::vector<std::pair<int, int>> seen;
+        snap.for_each( [&]( const int& k, const int& v ) { seen.emplace_back( k, v ); } );
+        REQUIRE( seen == std::vector<std::pair<int, int>>( ref.begin(), ref.end() ) );
+        for ( const auto& kv : ref )
+            REQUIRE( value_of( snap, kv.first ) == kv.second );
+        REQUIRE_FALSE( snap.contains( 1000 ) );
+        check_balance<Map>( snap.root_index() );
+        snap.release();
+        REQUIRE( map.clear() );
+        REQUIRE( map.pin().empty() );
+        REQUIRE( map.retired_count() == 0 );
+    }
+    MvccMgr::destroy();
+}
+
+TEST_CASE( "pmvcc_map snapshot isolation and deferred reclamation", "[test_pmvcc_map]" )
+{
+    using Map = pmm::pmvcc_map<int, int, MvccMgr>;
+    REQUIRE( MvccMgr::create( 256 * 1024 ) );
+    {
+        Map map( "mvcc/iso" );
+        for ( int i = 0; i < 32; ++i )
+            REQUIRE( map.insert( i, i ) );
+        std::size_t live_allocs = MvccMgr::alloc_block_count();
+
+        auto old_snap = map.pin();
+        REQUIRE( map.pinned_count() == 1 );
+        REQUIRE( map.insert( 5, 500 ) );
+        REQUIRE( map.erase( 7 ) );
+        REQUIRE( map.insert( 100, 100 ) );
+
+        REQUIRE( value_of( old_snap, 5 ) == 5 );
+        REQUIRE( old_snap.contains( 7 ) );
+        REQUIRE_FALSE( old_snap.contains( 100 ) );
+        REQUIRE( old_snap.size() == 32 );
+        REQUIRE( map.retired_count() > 0 );
+
+        {
+            auto fresh = map.pin();
+            REQUIRE( fresh.version() > old_snap.version() );
+            REQUIRE( value_of( fresh, 5 ) == 500 );
+            REQUIRE_FALSE( fresh.contains( 7 ) );
+            REQUIRE( fresh.contains( 100 ) );
+            REQUIRE( fresh.size() == 32 );
+        }
+
+        old_snap.release();
+        REQUIRE( map.pinned_count() == 0 );
+        REQUIRE( map.retired_count() == 0 );
+        REQUIRE( MvccMgr::alloc_block_count() == live_allocs );
+    }
+    MvccMgr::destroy();
+}
+
+TEST_CASE( "pmvcc_map refuses a second handle and frees retired nodes on destruction", "[test_pmvcc_map]" )
+{
+    using Map = pmm::pmvcc_map<int, int, MvccMgr>;
+    REQUIRE( MvccMgr::create( 256 * 1024 ) );
+    std::size_t live_allocs = 0;
+    {
+        Map map( "mvcc/owner" );
+        REQUIRE( map.is_bound() );
+        {
+            Map other( "mvcc/owner" );
+            REQUIRE_FALSE( other.is_bound() );
+            REQUIRE_FALSE( other.insert( 1, 1 ) );
+        }
+        for ( int i = 0; i < 16; ++i )
+            REQUIRE( map.insert( i, i ) );
+        {
+            auto snap = map.pin();
+            REQUIRE( map.insert( 3, 30 ) );
+            REQUIRE( map.retired_count() > 0 );
+            snap.release();
+        }
+        REQUIRE( map.erase( 4 ) );
+        REQUIRE( map.retired_count() == 0 );
+        live_allocs = MvccMgr::alloc_block_count();
+    }
+    REQUIRE( MvccMgr::alloc_block_count() == live_allocs );
+    {
+        Map map( "mvcc/owner" );
+        REQUIRE( map.is_bound() );
+        auto snap = map.pin();
+        REQUIRE( snap.size() == 15 );
+        REQUIRE( value_of( snap, 3 ) == 30 );
+    }
+    MvccMgr::destroy();
+}
+
+TEST_CASE( "pmvcc_map root survives save and load", "[test_pmvcc_map]" )
+{
+    const char* file = "test_pmvcc_map.dat";
+    REQUIRE( MvccMgr::create( 128 * 1024 ) );
+    {
+        pmm::pmvcc_map<int, int, MvccMgr> map( "mvcc/persist" );
+        for ( int i = 0; i < 50; ++i )
+            REQUIRE( map.insert( i, i * 3 ) );
+    }
+    std::size_t total = MvccMgr::total_size();
+    REQUIRE( pmm::save_manager<MvccMgr>( file ) );
+    MvccMgr::destroy();
+
+    REQUIRE( MvccMgr2::create( total ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<MvccMgr2>( file, vr ) );
+    {
+        pmm::pmvcc_map<int, int, MvccMgr2> map( "mvcc/persist" );
+        auto                               snap = map.pin();
+        REQUIRE( snap.size() == 50 );
+        REQUIRE( value_of( snap, 49 ) == 147 );
+    }
+    MvccMgr2::destroy();
+    std::remove( file );
+}
+
+TEST_CASE( "pmvcc_map reclaims retired nodes persisted by an unclean shutdown", "[test_pmvcc_map]" )
+{
+    const char* file = "test_pmvcc_map_crash.dat";
+    REQUIRE( MvccMgr::create( 128 * 1024 ) );
+    std::size_t retired = 0;
+    {
+        pmm::pmvcc_map<int, int, MvccMgr> map( "mvcc/crash" );
+        for ( int i = 0; i < 32; ++i )
+            REQUIRE( map.insert( i, i ) );
+        auto snap = map.pin();
+        REQUIRE( map.insert( 7, 70 ) );
+        retired = map.retired_count();
+        REQUIRE( retired > 0 );
+        REQUIRE( pmm::save_manager<MvccMgr>( file ) );
+    }
+    std::size_t total = MvccMgr::total_size();
+    MvccMgr::destroy();
+
+    REQUIRE( MvccMgr2::create( total ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<MvccMgr2>( file, vr ) );
+    std::size_t loaded = MvccMgr2::alloc_block_count();
+    {
+        pmm::pmvcc_map<int, int, MvccMgr2> map( "mvcc/crash" );
+        REQUIRE( map.is_bound() );
+        REQUIRE( MvccMgr2::alloc_block_count() == loaded - retired - 1 );
+        auto snap = map.pin();
+        REQUIRE( snap.size() == 32 );
+        REQUIRE( value_of( snap, 7 ) == 70 );
+    }
+    MvccMgr2::destroy();
+    std::remove( file );
+}
+
+TEST_CASE( "pmvcc_map readers scan pinned snapshots while a writer publishes", "[test_pmvcc_map]" )
+{
+    REQUIRE( MvccMt::create( 4 * 1024 * 1024 ) );
+    {
+        pmm::pmvcc_map<int, int, MvccMt> map( "mvcc/threads" );
+        for ( int i = 0; i < 256; ++i )
+            REQUIRE( map.insert( i, 0 ) );
+        std::atomic<bool>        stop{ false };
+        std::atomic<int>         bad{ 0 };
+        std::vector<std::thread> readers;
+        for ( int t = 0; t < 3; ++t )
+        {
+            readers.emplace_back(
+                [&]()
+                {
+                    while ( !stop.load() )
+                    {
+                        auto snap = map.pin();
+                        int  prev = -1;
+                        int  low  = -1;
+                        bool ok   = true;
+                        snap.for_each(
+                            [&]( const int&, const int& v )
+                            {
+                                if ( prev >= 0 && v > prev )
+                                    ok = false;
+                                if ( low < 0 || v < low )
+                                    low = v;
+                                prev = v;
+                            } );
+                        if ( !ok || prev - low > 1 || snap.size() != 256 )
+                            bad.fetch_add( 1 );
+                    }
+                } );
+        }
+        for ( int round = 1; round <= 20; ++round )
+            for ( int i = 0; i < 256; ++i )
+                REQUIRE( map.insert( i, round ) );
+        stop.store( true );
+        for ( auto& th : readers )
+            th.join();
+        REQUIRE( bad.load() == 0 );
+        REQUIRE( map.pinned_count() == 0 );
+        REQUIRE( map.retired_count() == 0 );
+        REQUIRE( value_of( map.pin(), 0 ) == 20 );
+    }
+    MvccMt::destroy();
+}
@@ -0,0 +1,169 @@
+/**
+ * @file test_pradix.cpp
+ * @brief Tests for pradix, the persistent adaptive radix tree (pmm/pradix.h).
+ *
+ * Verifies:
+ *  - insert/find/erase agree with std::map for path-like keys, keys that are prefixes of other
+ *    keys, the empty key, binary bytes and prefixes longer than the inline prefix buffer
+ *  - nodes grow through 4/16/48/256 fan-out and shrink back as keys are erased
+ *  - for_each_prefix visits exactly the matching keys in lexicographic order
+ *  - contents survive save/load and the tree reattaches by domain key
+ */
+
+#include "pmm/io.h"
+#include "pmm/pmm_presets.h"
+#include "pmm/pradix.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+using RadixMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4601>;
+using RadixMgr2 = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4602>;
+
+template <typename TreeT> static bool matches( const TreeT& tree, const std::map<std::string, std::uint64_t>& ref )
+{
+    if ( tree.size() != ref.size() )
+        return false;
+    std::vector<std::pair<std::string, std::uint64_t>> seen;
+    tree.for_each( [&]( const char* k, std::size_t n, const std::uint64_t& v )
+                   { seen.emplace_back( std::string( k, n ), v ); } );
+    return seen == std::vector<std::pair<std::string, std::uint64_t>>( ref.begin(), ref.end() );
+}
+
+static std::vector<std::string> sample_keys()
+{
+    std::vector<std::string> keys = { "",
+                                      "a",
+                                      "ab",
+                                      "abc",
+                                      "abd",
+                                      "b",
+                                      "container/pmap/alpha",
+                                      "container/pmap/alphabet",
+                                      "container/pmap/beta",
+                                      "container/phashmap/alpha",
+                                      "container/pmap/averyveryverylongsharedprefix/one",
+                                      "container/pmap/averyveryverylongsharedprefix/two",
+                                      "container/pmap/averyveryverylongsharedprefix",
+                                      std::string( "bin\0ary", 7 ),
+                                      std::string( "bin\0arz", 7 ),
+                                      std::string( "\xff\x00\x01", 3 ) };
+    for ( int i = 0; i < 300; ++i )
+        keys.push_back( "fan/" + std::string( 1, static_cast<char>( i % 256 ) ) + std::to_string( i / 256 ) );
+    for ( int i = 0; i < 500; ++i )
+        keys.push_back( "users/" + std::to_string( i * 7919 % 1000 ) + "/profile" );
+    return keys;
+}
+
+TEST_CASE( "pradix insert, find and erase agree with std::map", "[test_pradix]" )
+{
+    REQUIRE( RadixMgr::create( 1024 * 1024 ) );
+    pmm::pradix<std::uint64_t, RadixMgr> tree( "paths" );
+    std::map<std::string, std::uint64_t> ref;
+    REQUIRE( tree.is_bound() );
+    const std::vector<std::string> keys = sample_keys();
+    for ( std::size_t i = 0; i < keys.size(); ++i )
+    {
+        REQUIRE( tree.insert( keys[i].data(), keys[i].size(), i ) );
+        ref[keys[i]] = i;
+    }
+    REQUIRE( matches( tree, ref ) );
+    REQUIRE( tree.insert( "abc", 77 ) );
+    ref["abc"] = 77;
+    std::uint64_t v = 0;
+    REQUIRE( tree.find( "abc", v ) );
+    REQUIRE( v == 77 );
+    REQUIRE( tree.find( "", v ) );
+    REQUIRE( v == 0 );
+    REQUIRE( !tree.contains( "abe" ) );
+    REQUIRE( !tree.contains( "container/pmap/averyveryverylongsharedprefiX" ) );
+    REQUIRE( !tree.contains( "container/pmap/averyveryverylongsharedprefix/" ) );
+    REQUIRE( !tree.contains( "fan" ) );
+    REQUIRE( tree.contains( std::string( "bin\0arz", 7 ).data(), 7 ) );
+
+    for ( std::size_t i = 0; i < keys.size(); i += 2 )
+    {
+        REQUIRE( tree.erase( keys[i].data(), keys[i].size() ) == ( ref.erase( keys[i] ) == 1 ) );
+        REQUIRE( !tree.contains( keys[i].data(), keys[i].size() ) );
+    }
+    REQUIRE( !tree.erase( "never-inserted" ) );
+    REQUIRE( matches( tree, ref ) );
+    for ( const auto& [key, value] : ref )
+    {
+        REQUIRE( tree.find( key.data(), key.size(), v ) );
+        REQUIRE( v == value );
+    }
+    for ( std::size_t i = 1; i < keys.size(); i += 2 )
+        tree.erase( keys[i].data(), keys[i].size() );
+    REQUIRE( tree.empty() );
+    REQUIRE( tree.insert( "again", 1 ) );
+    REQUIRE( tree.size() == 1 );
+    tree.clear();
+    REQUIRE( tree.empty() );
+    RadixMgr::destroy();
+}
+
+TEST_CASE( "pradix for_each_prefix visits matching keys in order", "[test_pradix]" )
+{
+    REQUIRE( RadixMgr::create( 1024 * 1024 ) );
+    pmm::pradix<std::uint64_t, RadixMgr> tree;
+    const std::vector<std::string>        keys = sample_keys();
+    for ( std::size_t i = 0; i < keys.size(); ++i )
+        REQUIRE( tree.insert( keys[i].data(), keys[i].size(), i ) );
+    for ( const char* prefix : { "", "a", "ab", "container/", "container/pmap/", "container/pmap/averyvery",
+                                 "container/pmap/averyveryverylongsharedprefix/", "users/1", "fan/", "zzz",
+                                 "container/pmap/averyveryverylongsharedprefiX" } )
+    {
+        std::vector<std::string> expect;
+        for ( const std::string& k : keys )
+        {
+            if ( k.compare( 0, std::strlen( prefix ), prefix ) == 0 )
+                expect.push_back( k );
+        }
+        std::sort( expect.begin(), expect.end() );
+        expect.erase( std::unique( expect.begin(), expect.end() ), expect.end() );
+        std::vector<std::string> got;
+        const std::size_t        n = tree.for_each_prefix(
+            prefix, [&]( const char* k, std::size_t len, const std::uint64_t& ) { got.emplace_back( k, len ); } );
+        REQUIRE( n == got.size() );
+        REQUIRE( got == expect );
+    }
+    RadixMgr::destroy();
+}
+
+TEST_CASE( "pradix contents survive save and load", "[test_pradix]" )
+{
+    const char* file = "test_pradix.dat";
+    REQUIRE( RadixMgr::create( 1024 * 1024 ) );
+    std::map<std::string, std::uint64_t> ref;
+    {
+        pmm::pradix<std::uint64_t, RadixMgr> tree( "paths" );
+        const std::vector<std::string>        keys = sample_keys();
+        for ( std::size_t i = 0; i < keys.size(); ++i )
+        {
+            REQUIRE( tree.insert( keys[i].data(), keys[i].size(), i * 3 ) );
+            ref[keys[i]] = i * 3;
+        }
+    }
+    REQUIRE( pmm::save_manager<RadixMgr>( file ) );
+    REQUIRE( RadixMgr2::create( RadixMgr::total_size() ) );
+    RadixMgr::destroy();
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<RadixMgr2>( file, vr ) );
+    std::remove( file );
+
+    pmm::pradix<std::uint64_t, RadixMgr2> tree( "paths" );
+    REQUIRE( tree.is_bound() );
+    REQUIRE( matches( tree, ref ) );
+    REQUIRE( tree.insert( "container/pmap/gamma", 5 ) );
+    std::uint64_t v = 0;
+    REQUIRE( tree.find( "container/pmap/gamma", v ) );
+    REQUIRE( v == 5 );
+    RadixMgr2::destroy();
+}
@@ -0,0 +1,249 @@
+/**
+ * @file test_pring.cpp
+ * @brief Tests for pring, the persistent SPSC/MPSC ring buffer (pmm/pring.h).
+ *
+ * Verifies:
+ *  - FIFO order, full/empty detection and wrap-around for both modes
+ *  - a producer and a consumer thread hand off every item in order (SPSC)
+ *  - several producer threads hand off every item exactly once, in per-producer order (MPSC)
+ *  - contents survive save/load; the ring reattaches by key and validate() accepts it
+ *  - recover() repairs corrupted indices and unpublished MPSC slots
+ *  - attaching a handle to an inconsistent ring only validates it; push/pop wait for an explicit recover()
+ */
+
+#include "pmm/io.h"
+#include "pmm/pmm_presets.h"
+#include "pmm/pring.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using RingMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4501>;
+using RingMgr2 = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4502>;
+
+template <pmm::RingMode Mode> static void check_fifo()
+{
+    REQUIRE( RingMgr::create( 256 * 1024 ) );
+    pmm::pring<std::uint64_t, RingMgr, Mode> ring( "fifo", 6 );
+    REQUIRE( ring.is_bound() );
+    REQUIRE( ring.capacity() == 8 );
+    REQUIRE( ring.validate() );
+    std::uint64_t v = 0;
+    REQUIRE( !ring.try_pop( v ) );
+    std::uint64_t next_in = 0, next_out = 0;
+    for ( int round = 0; round < 5; ++round )
+    {
+        while ( ring.try_push( next_in ) )
+            ++next_in;
+        REQUIRE( ring.size() == 8 );
+        for ( int i = 0; i < 5; ++i )
+        {
+            REQUIRE( ring.try_pop( v ) );
+            REQUIRE( v == next_out++ );
+        }
+        REQUIRE( ring.validate() );
+    }
+    while ( ring.try_pop( v ) )
+        REQUIRE( v == next_out++ );
+    REQUIRE( next_out == next_in );
+    REQUIRE( ring.empty() );
+
+    pmm::pring<std::uint64_t, RingMgr, Mode> same( "fifo" );
+    REQUIRE( same.is_bound() );
+    REQUIRE( same.capacity() == 8 );
+    REQUIRE( same.try_push( 42 ) );
+    REQUIRE( ring.try_pop( v ) );
+    REQUIRE( v == 42 );
+    RingMgr::destroy();
+}
+
+TEST_CASE( "pring keeps FIFO order across wrap-around", "[test_pring]" )
+{
+    check_fifo<pmm::RingMode::Spsc>();
+    check_fifo<pmm::RingMode::Mpsc>();
+}
+
+TEST_CASE( "pring SPSC hands off every item between threads", "[test_pring]" )
+{
+    REQUIRE( RingMgr::create( 256 * 1024 ) );
+    pmm::pring<std::uint64_t, RingMgr> ring( "spsc", 64 );
+    constexpr std::uint64_t            kItems = 200000;
+    std::thread                        producer(
+        [&]
+        {
+            for ( std::uint64_t i = 0; i < kItems; )
+            {
+                if ( ring.try_push( i ) )
+                    ++i;
+                else
+                    std::this_thread::yield();
+            }
+        } );
+    bool          ordered = true;
+    std::uint64_t expect  = 0;
+    while ( expect < kItems )
+    {
+        std::uint64_t v;
+        if ( ring.try_pop( v ) )
+            ordered = ordered && v == expect++;
+        else
+            std::this_thread::yield();
+    }
+    producer.join();
+    REQUIRE( ordered );
+    REQUIRE( ring.empty() );
+    RingMgr::destroy();
+}
+
+TEST_CASE( "pring MPSC hands off every item from several producers", "[test_pring]" )
+{
+    REQUIRE( RingMgr::create( 256 * 1024 ) );
+    pmm::pring<std::uint64_t, RingMgr, pmm::RingMode::Mpsc> ring( "mpsc", 128 );
+    constexpr std::uint64_t                                 kProducers = 4;
+    constexpr std::uint64_t                                 kPer       = 50000;
+    std::vector<std::thread>                                producers;
+    for ( std::uint64_t p = 0; p < kProducers; ++p )
+        producers.emplace_back(
+            [&ring, p]
+            {
+                for ( std::uint64_t i = 0; i < kPer; )
+                {
+                    if ( ring.try_push( ( p << 32 ) | i ) )
+                        ++i;
+                    else
+                        std::this_thread::yield();
+                }
+            } );
+    std::vector<std::uint64_t> next( kProducers, 0 );
+    bool                       ordered = true;
+    for ( std::uint64_t got = 0; got < kProducers * kPer; )
+    {
+        std::uint64_t v;
+        if ( !ring.try_pop( v ) )
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        const std::uint64_t p = v >> 32;
+        ordered               = ordered && p < kProducers && ( v & 0xFFFFFFFFu ) == next[p]++;
+        ++got;
+    }
+    for ( auto& t : producers )
+        t.join();
+    REQUIRE( ordered );
+    REQUIRE( ring.empty() );
+    REQUIRE( ring.validate() );
+    RingMgr::destroy();
+}
+
+TEST_CASE( "pring contents survive save and load", "[test_pring]" )
+{
+    const char* file = "test_pring.dat";
+    REQUIRE( RingMgr::create( 256 * 1024 ) );
+    {
+        pmm::pring<std::uint32_t, RingMgr, pmm::RingMode::Mpsc> ring( "events", 16 );
+        for ( std::uint32_t i = 0; i < 20; ++i )
+            ring.try_push( i );
+        std::uint32_t v = 0;
+        for ( int i = 0; i < 3; ++i )
+            REQUIRE( ring.try_pop( v ) );
+        REQUIRE( ring.size() == 13 );
+    }
+    REQUIRE( pmm::save_manager<RingMgr>( file ) );
+    REQUIRE( RingMgr2::create( RingMgr::total_size() ) );
+    RingMgr::destroy();
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<RingMgr2>( file, vr ) );
+    std::remove( file );
+
+    pmm::pring<std::uint32_t, RingMgr2, pmm::RingMode::Spsc> other_mode( "events" );
+    REQUIRE( other_mode.is_bound() );
+    REQUIRE( other_mode.empty() );
+
+    pmm::pring<std::uint32_t, RingMgr2, pmm::RingMode::Mpsc> ring( "events" );
+    REQUIRE( ring.is_bound() );
+    REQUIRE( ring.validate() );
+    REQUIRE( ring.size() == 13 );
+    std::uint32_t v = 0;
+    for ( std::uint32_t expect = 3; expect < 16; ++expect )
+    {
+        REQUIRE( ring.try_pop( v ) );
+        REQUIRE( v == expect );
+    }
+    REQUIRE( !ring.try_pop( v ) );
+    RingMgr2::destroy();
+}
+
+TEST_CASE( "pring recover repairs torn indices and unpublished slots", "[test_pring]" )
+{
+    REQUIRE( RingMgr::create( 256 * 1024 ) );
+    std::uint64_t v = 0;
+
+    pmm::pring<std::uint64_t, RingMgr> spsc( "torn", 8 );
+    for ( std::uint64_t i = 0; i < 3; ++i )
+        REQUIRE( spsc.try_push( i ) );
+    pmm::pring_header* h = RingMgr::resolve_unchecked( RingMgr::pptr<pmm::pring_header>( spsc.root_index() ) );
+    h->tail              = h->head + 100;
+    REQUIRE( !spsc.validate() );
+    REQUIRE( spsc.recover() );
+    REQUIRE( spsc.validate() );
+    REQUIRE( spsc.empty() );
+    REQUIRE( !spsc.recover() );
+    REQUIRE( spsc.try_push( 7 ) );
+    REQUIRE( spsc.try_pop( v ) );
+    REQUIRE( v == 7 );
+
+    pmm::pring<std::uint64_t, RingMgr, pmm::RingMode::Mpsc> mpsc( "torn", 8 );
+    for ( std::uint64_t i = 0; i < 3; ++i )
+        REQUIRE( mpsc.try_push( i ) );
+    h = RingMgr::resolve_unchecked( RingMgr::pptr<pmm::pring_header>( mpsc.root_index() ) );
+    h->tail += 2;
+    REQUIRE( !mpsc.validate() );
+    REQUIRE( mpsc.recover() );
+    REQUIRE( mpsc.validate() );
+    REQUIRE( mpsc.size() == 3 );
+    for ( std::uint64_t i = 0; i < 3; ++i )
+    {
+        REQUIRE( mpsc.try_pop( v ) );
+        REQUIRE( v == i );
+    }
+    for ( std::uint64_t i = 10; i < 18; ++i )
+        REQUIRE( mpsc.try_push( i ) );
+    REQUIRE( !mpsc.try_push( 99 ) );
+    REQUIRE( mpsc.validate() );
+    RingMgr::destroy();
+}
+
+TEST_CASE( "pring attaching to a torn ring refuses use until recover()", "[test_pring]" )
+{
+    REQUIRE( RingMgr::create( 256 * 1024 ) );
+    std::uint64_t v = 0;
+    {
+        pmm::pring<std::uint64_t, RingMgr, pmm::RingMode::Mpsc> ring( "attach", 8 );
+        for ( std::uint64_t i = 0; i < 3; ++i )
+            REQUIRE( ring.try_push( i ) );
+        pmm::pring_header* h = RingMgr::resolve_unchecked( RingMgr::pptr<pmm::pring_header>( ring.root_index() ) );
+        h->tail += 2;
+        REQUIRE( !ring.validate() );
+    }
+    pmm::pring<std::uint64_t, RingMgr, pmm::RingMode::Mpsc> ring( "attach" );
+    REQUIRE( ring.is_bound() );
+    REQUIRE( ring.needs_recovery() );
+    REQUIRE( !ring.validate() );
+    REQUIRE( !ring.try_pop( v ) );
+    REQUIRE( !ring.try_push( 9 ) );
+    REQUIRE( ring.recover() );
+    REQUIRE( !ring.needs_recovery() );
+    REQUIRE( ring.validate() );
+    REQUIRE( ring.size() == 3 );
+    for ( std::uint64_t i = 0; i < 3; ++i )
+    {
+        REQUIRE( ring.try_pop( v ) );
+        REQUIRE( v == i );
+    }
+    REQUIRE( !ring.try_pop( v ) );
+    RingMgr::destroy();
+}
@@ -0,0 +1,109 @@
+/**
+ * @file test_psegarray.cpp
+ * @brief Tests for psegarray — chunked persistent array that never moves its elements.
+ *
+ * Verifies:
+ *  - push_back/at/set/pop_back across many chunks; element addresses stay fixed as the array grows
+ *  - resize zero-fills new elements, reserve/clear keep chunks, free_data releases every block
+ *  - for_each_chunk visits all elements in order; the array survives save/load
+ */
+
+#include "pmm/io.h"
+#include "pmm/pmm_presets.h"
+#include "pmm/psegarray.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdio>
+
+using SegMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4101>;
+using SegMgr2 = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4102>;
+
+TEST_CASE( "psegarray grows by chunks without moving elements", "[test_psegarray]" )
+{
+    using Arr = pmm::psegarray<std::uint64_t, SegMgr, 256>;
+    REQUIRE( SegMgr::create( 4 * 1024 * 1024 ) );
+    const std::size_t blocks = SegMgr::alloc_block_count();
+    auto              p      = SegMgr::create_typed<Arr>();
+    REQUIRE( p.resolve()->empty() );
+    REQUIRE( p.resolve()->at( 0 ) == nullptr );
+
+    REQUIRE( p.resolve()->push_back( 7 ) );
+    const std::uint64_t* first = p.resolve()->front();
+    for ( std::uint64_t i = 1; i < 10000; ++i )
+        REQUIRE( p.resolve()->push_back( i * 3 ) );
+    Arr* a = p.resolve();
+    REQUIRE( a->size() == 10000 );
+    REQUIRE( a->chunk_count() == ( 10000 + 255 ) / 256 );
+    REQUIRE( a->front() == first );
+    REQUIRE( ( *a )[0] == 7 );
+    REQUIRE( ( *a )[9999] == 9999 * 3 );
+    REQUIRE( *a->back() == 9999 * 3 );
+    REQUIRE( a->at( 10000 ) == nullptr );
+    REQUIRE( a->set( 300, 42 ) );
+    REQUIRE( !a->set( 10000, 1 ) );
+    REQUIRE( ( *a )[300] == 42 );
+    a->pop_back();
+    REQUIRE( a->size() == 9999 );
+
+    std::size_t   seen = 0;
+    std::uint64_t sum  = 0;
+    a->for_each_chunk(
+        [&]( const std::uint64_t* data, std::size_t n )
+        {
+            for ( std::size_t i = 0; i < n; ++i )
+                sum += data[i];
+            seen += n;
+        } );
+    REQUIRE( seen == 9999 );
+    std::uint64_t expect = 7 + 42;
+    for ( std::uint64_t i = 1; i < 9999; ++i )
+        expect += ( i == 300 ) ? 0 : i * 3;
+    REQUIRE( sum == expect );
+
+    REQUIRE( p.resolve()->resize( 10300 ) );
+    a = p.resolve();
+    REQUIRE( ( *a )[9998] == 9998 * 3 );
+    REQUIRE( ( *a )[9999] == 0 );
+    REQUIRE( ( *a )[10299] == 0 );
+    const std::size_t chunks = a->chunk_count();
+    a->clear();
+    REQUIRE( a->empty() );
+    REQUIRE( a->chunk_count() == chunks );
+    REQUIRE( p.resolve()->reserve( 20000 ) );
+    REQUIRE( p.resolve()->capacity() >= 20000 );
+    p.resolve()->free_data();
+    REQUIRE( p.resolve()->chunk_count() == 0 );
+    SegMgr::destroy_typed( p );
+    REQUIRE( SegMgr::alloc_block_count() == blocks );
+    REQUIRE( SegMgr::verify().ok );
+    SegMgr::destroy();
+}
+
+TEST_CASE( "psegarray survives save/load", "[test_psegarray]" )
+{
+    using Arr        = pmm::psegarray<std::uint32_t, SegMgr, 64>;
+    using Arr2       = pmm::psegarray<std::uint32_t, SegMgr2, 64>;
+    const char* file = "test_psegarray.dat";
+    REQUIRE( SegMgr::create( 512 * 1024 ) );
+    auto p = SegMgr::create_typed<Arr>();
+    for ( std::uint32_t i = 0; i < 1000; ++i )
+        REQUIRE( p.resolve()->push_back( i ^ 0x5a5a ) );
+    auto offset = p.offset();
+    REQUIRE( pmm::save_manager<SegMgr>( file ) );
+    REQUIRE( SegMgr2::create( SegMgr::total_size() ) );
+    SegMgr::destroy();
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<SegMgr2>( file, vr ) );
+    {
+        SegMgr2::pptr<Arr2> q( offset );
+        REQUIRE( q.resolve()->size() == 1000 );
+        for ( std::uint32_t i = 0; i < 1000; ++i )
+            REQUIRE( ( *q.resolve() )[i] == ( i ^ 0x5a5a ) );
+        REQUIRE( q.resolve()->push_back( 1 ) );
+        REQUIRE( q.resolve()->size() == 1001 );
+        REQUIRE( SegMgr2::verify().ok );
+    }
+    SegMgr2::destroy();
+    std::remove( file );
+}
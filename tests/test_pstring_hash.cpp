@@ -0,0 +1,133 @@
+/**
+ * @file test_pstring_hash.cpp
+ * @brief Tests for the string hash and length-first comparisons.
+ *
+ * Verifies:
+ *  - pstring::hash() matches detail::str_hash of the content through assign/append/clear/free_data,
+ *    for inline and heap representations and across the inline-to-heap spill
+ *  - equality and ordering of pstring/pstringview agree with std::string for prefixes and equal lengths
+ *  - the stored hash of heap-backed and inline pstrings is persisted and stays valid across save/load
+ */
+
+#include "pmm/io.h"
+#include "pmm/pmm_presets.h"
+#include "pmm/pstring.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using HashMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4001>;
+using HashMgr2 = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 4002>;
+
+static std::uint32_t hash_of( const std::string& s )
+{
+    return pmm::detail::str_hash( s.data(), s.size() );
+}
+
+TEST_CASE( "pstring keeps its hash in sync with the content", "[test_pstring_hash]" )
+{
+    using Str = pmm::pstring<HashMgr>;
+    REQUIRE( HashMgr::create( 64 * 1024 ) );
+    auto p = HashMgr::create_typed<Str>();
+    Str* s = p.resolve();
+    REQUIRE( s->hash() == hash_of( "" ) );
+
+    REQUIRE( s->assign( "abc" ) );
+    REQUIRE( s->is_inline() );
+    REQUIRE( s->hash() == hash_of( "abc" ) );
+
+    std::string expect = "abc";
+    for ( int i = 0; i < 20; ++i )
+    {
+        const std::string part = "_" + std::to_string( i );
+        REQUIRE( s->append( part.c_str() ) );
+        expect += part;
+        REQUIRE( s->hash() == hash_of( expect ) );
+    }
+    REQUIRE( !s->is_inline() );
+
+    REQUIRE( s->assign( "short" ) );
+    REQUIRE( s->hash() == hash_of( "short" ) );
+    s->clear();
+    REQUIRE( s->hash() == hash_of( "" ) );
+    REQUIRE( s->append( "again" ) );
+    REQUIRE( s->hash() == hash_of( "again" ) );
+    s->free_data();
+    REQUIRE( s->hash() == hash_of( "" ) );
+    HashMgr::destroy_typed( p );
+    HashMgr::destroy();
+}
+
+TEST_CASE( "length-first comparisons agree with std::string", "[test_pstring_hash]" )
+{
+    using Str = pmm::pstring<HashMgr>;
+    REQUIRE( HashMgr::create( 256 * 1024 ) );
+    const std::vector<std::string> words = { "",       "a",          "ab",         "abc",       "abd",
+                                             "b",      "long_word_1", "long_word_2", "long_word_", "long_word_10" };
+    std::vector<HashMgr::pptr<Str>> strs;
+    for ( const std::string& w : words )
+    {
+        strs.push_back( HashMgr::create_typed<Str>() );
+        REQUIRE( strs.back().resolve()->assign( w.c_str() ) );
+    }
+    for ( std::size_t i = 0; i < words.size(); ++i )
+    {
+        const Str& a  = *strs[i].resolve();
+        auto       va = HashMgr::pstringview::intern( words[i].c_str() );
+        REQUIRE( a == words[i].c_str() );
+        REQUIRE( *va == words[i].c_str() );
+        for ( std::size_t j = 0; j < words.size(); ++j )
+        {
+            const Str& b  = *strs[j].resolve();
+            auto       vb = HashMgr::pstringview::intern( words[j].c_str() );
+            REQUIRE( ( a == b ) == ( words[i] == words[j] ) );
+            REQUIRE( ( a < b ) == ( words[i] < words[j] ) );
+            REQUIRE( ( *va < *vb ) == ( words[i] < words[j] ) );
+            REQUIRE( ( *va == *vb ) == ( words[i] == words[j] ) );
+            REQUIRE( ( a == words[j].c_str() ) == ( words[i] == words[j] ) );
+        }
+    }
+    for ( auto& p : strs )
+        HashMgr::destroy_typed( p );
+    HashMgr::destroy();
+}
+
+TEST_CASE( "the pstring hash is stable across save/load", "[test_pstring_hash]" )
+{
+    using Str        = pmm::pstring<HashMgr>;
+    static_assert( sizeof( Str ) == 24 );
+    const char* file = "test_pstring_hash.dat";
+    REQUIRE( HashMgr::create( 256 * 1024 ) );
+    auto p = HashMgr::create_typed<Str>();
+    REQUIRE( p.resolve()->assign( "a fairly long persisted string" ) );
+    auto q = HashMgr::create_typed<Str>();
+    REQUIRE( q.resolve()->assign( "tiny" ) );
+    REQUIRE( q.resolve()->is_inline() );
+    auto offset       = p.offset();
+    auto small_offset = q.offset();
+    REQUIRE( pmm::save_manager<HashMgr>( file ) );
+    REQUIRE( HashMgr2::create( HashMgr::total_size() ) );
+    HashMgr::destroy();
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<HashMgr2>( file, vr ) );
+    {
+        using Str2 = pmm::pstring<HashMgr2>;
+        Str2* s    = HashMgr2::pptr<Str2>( offset ).resolve();
+        REQUIRE( s != nullptr );
+        REQUIRE( !s->is_inline() );
+        REQUIRE( s->hash() == hash_of( "a fairly long persisted string" ) );
+        REQUIRE( *s == "a fairly long persisted string" );
+        REQUIRE( s->append( "!" ) );
+        REQUIRE( s->hash() == hash_of( "a fairly long persisted string!" ) );
+        Str2* small = HashMgr2::pptr<Str2>( small_offset ).resolve();
+        REQUIRE( small != nullptr );
+        REQUIRE( small->_hash == hash_of( "tiny" ) );
+        REQUIRE( small->append( "!" ) );
+        REQUIRE( small->_hash == hash_of( "tiny!" ) );
+    }
+    HashMgr2::destroy();
+    std::remove( file );
+}
@@ -0,0 +1,121 @@
+/**
+ * @file test_pstring_sso.cpp
+ * @brief Tests for the inline (small-string) representation of pstring.
+ *
+ * Verifies:
+ *  - strings up to inline_capacity() (15 bytes) are stored in the _capacity/_data_idx/_inline_tail bytes with no data block
+ *  - growing past inline_capacity() moves the content to a heap buffer transparently
+ *  - self-aliasing append, clear, free_data and comparisons work across both representations
+ *  - inline strings survive save/load
+ */
+
+#include "pmm/io.h"
+#include "pmm/pmm_presets.h"
+#include "pmm/pstring.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using SsoMgr   = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3801>;
+using SsoMgr2  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3802>;
+using SsoLarge = pmm::PersistMemoryManager<pmm::LargeDBConfig, 3803>;
+
+TEST_CASE( "pstring stores short strings inline without a data block", "[test_pstring_sso]" )
+{
+    using Str = pmm::pstring<SsoMgr>;
+    STATIC_REQUIRE( Str::inline_capacity() == sizeof( Str ) - 2 * sizeof( std::uint32_t ) - 1 );
+    STATIC_REQUIRE( Str::inline_capacity() == 15 );
+    STATIC_REQUIRE( pmm::pstring<SsoLarge>::inline_capacity() == 15 );
+    STATIC_REQUIRE( sizeof( pmm::pstring<SsoLarge> ) == 24 );
+    REQUIRE( SsoMgr::create( 64 * 1024 ) );
+    auto        p      = SsoMgr::create_typed<Str>();
+    std::size_t blocks = SsoMgr::alloc_block_count();
+    Str*        s      = p.resolve();
+
+    const std::string fits( Str::inline_capacity(), 'a' );
+    REQUIRE( s->assign( fits.c_str() ) );
+    REQUIRE( s->is_inline() );
+    REQUIRE( s->size() == fits.size() );
+    REQUIRE( *s == fits.c_str() );
+    REQUIRE( s->hash() == pmm::detail::str_hash( fits.data(), fits.size() ) );
+    REQUIRE( SsoMgr::alloc_block_count() == blocks );
+
+    REQUIRE( s->assign( "ab" ) );
+    REQUIRE( s->append( "c" ) );
+    REQUIRE( *s == "abc" );
+    REQUIRE( ( *s )[1] == 'b' );
+    REQUIRE( s->append( s->c_str() ) );
+    REQUIRE( *s == "abcabc" );
+    REQUIRE( SsoMgr::alloc_block_count() == blocks );
+
+    s->clear();
+    REQUIRE( s->empty() );
+    REQUIRE( *s == "" );
+    REQUIRE( s->assign( "" ) );
+    REQUIRE( s->empty() );
+    REQUIRE( SsoMgr::alloc_block_count() == blocks );
+    SsoMgr::destroy_typed( p );
+    SsoMgr::destroy();
+}
+
+TEST_CASE( "pstring spills to the heap when it grows past the inline buffer", "[test_pstring_sso]" )
+{
+    using Str = pmm::pstring<SsoMgr>;
+    REQUIRE( SsoMgr::create( 64 * 1024 ) );
+    auto        p      = SsoMgr::create_typed<Str>();
+    std::size_t blocks = SsoMgr::alloc_block_count();
+    Str*        s      = p.resolve();
+
+    REQUIRE( s->assign( "abcd" ) );
+    REQUIRE( s->is_inline() );
+    std::string expect = "abcd";
+    for ( int i = 0; i < 20; ++i )
+    {
+        REQUIRE( s->append( "xyz" ) );
+        expect += "xyz";
+        REQUIRE( *s == expect.c_str() );
+    }
+    REQUIRE_FALSE( s->is_inline() );
+    REQUIRE( SsoMgr::alloc_block_count() == blocks + 1 );
+
+    Str inline_copy;
+    REQUIRE( inline_copy.assign( "abcd" ) );
+    REQUIRE( s->assign( "abcd" ) );
+    REQUIRE_FALSE( s->is_inline() );
+    REQUIRE( *s == inline_copy );
+    REQUIRE_FALSE( *s < inline_copy );
+    REQUIRE_FALSE( inline_copy < *s );
+
+    s->free_data();
+    REQUIRE( SsoMgr::alloc_block_count() == blocks );
+    REQUIRE( s->assign( "tiny" ) );
+    REQUIRE( s->is_inline() );
+    REQUIRE( SsoMgr::alloc_block_count() == blocks );
+    SsoMgr::destroy_typed( p );
+    REQUIRE( SsoMgr::verify().ok );
+    SsoMgr::destroy();
+}
+
+TEST_CASE( "inline pstring survives save/load", "[test_pstring_sso]" )
+{
+    const char* kImage = "test_pstring_sso.img";
+    REQUIRE( SsoMgr::create( 64 * 1024 ) );
+    auto p = SsoMgr::create_typed<pmm::pstring<SsoMgr>>();
+    REQUIRE( p->assign( "key" ) );
+    auto q = SsoMgr::create_typed<pmm::pstring<SsoMgr>>();
+    REQUIRE( q->assign( "a value long enough for a heap buffer" ) );
+    REQUIRE( pmm::save_manager<SsoMgr>( kImage ) );
+    REQUIRE( SsoMgr2::create( SsoMgr::total_size() ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<SsoMgr2>( kImage, vr ) );
+    auto* p2 = SsoMgr2::pptr<pmm::pstring<SsoMgr2>>( p.offset() ).resolve();
+    auto* q2 = SsoMgr2::pptr<pmm::pstring<SsoMgr2>>( q.offset() ).resolve();
+    REQUIRE( p2->is_inline() );
+    REQUIRE( *p2 == "key" );
+    REQUIRE( *q2 == "a value long enough for a heap buffer" );
+    SsoMgr2::destroy();
+    SsoMgr::destroy();
+    std::remove( kImage );
+}
@@ -0,0 +1,187 @@
+/**
+ * @file test_psymbol_arena.cpp
+ * @brief Tests for psymbol_arena — interned strings packed back-to-back in large pages.
+ *
+ * Verifies:
+ *  - intern() deduplicates, find() does not insert, handles resolve to the stored bytes
+ *  - thousands of symbols share a few pages and use less image space than pstringview blocks
+ *  - oversized symbols get a dedicated page; for_each walks entries in insertion order
+ *  - the arena and its handles survive save/load and the image still verifies
+ *  - an index allocation that fails on the first intern is retried once memory is freed
+ *  - clear() frees every page, the index and the header, and the arena can be refilled
+ */
+
+#include "pmm/io.h"
+#include "pmm/pmm_presets.h"
+#include "pmm/psymbol_arena.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using ArenaMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3901>;
+using ArenaMgr2 = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3902>;
+using ArenaTiny = pmm::PersistMemoryManager<pmm::EmbeddedStaticConfig<16384>, 3903>;
+
+TEST_CASE( "psymbol_arena: intern deduplicates and resolves", "[psymbol_arena]" )
+{
+    REQUIRE( ArenaMgr::create( 1 << 20 ) );
+    {
+        pmm::psymbol_arena<ArenaMgr> arena( "symbols" );
+        REQUIRE( arena.is_bound() );
+        REQUIRE( arena.size() == 0 );
+        REQUIRE( arena.find( "alpha" ).is_null() );
+
+        pmm::psymbol a = arena.intern( "alpha" );
+        pmm::psymbol b = arena.intern( "beta" );
+        REQUIRE( !a.is_null() );
+        REQUIRE( !b.is_null() );
+        REQUIRE( a != b );
+        REQUIRE( arena.intern( "alpha" ) == a );
+        REQUIRE( arena.find( "beta" ) == b );
+        REQUIRE( arena.size() == 2 );
+        REQUIRE( arena.page_count() == 1 );
+        REQUIRE( std::strcmp( arena.c_str( a ), "alpha" ) == 0 );
+        REQUIRE( arena.length( b ) == 4 );
+
+        pmm::psymbol empty = arena.intern( "" );
+        REQUIRE( !empty.is_null() );
+        REQUIRE( arena.length( empty ) == 0 );
+        REQUIRE( arena.intern( nullptr ) == empty );
+        REQUIRE( std::strcmp( arena.c_str( pmm::psymbol{} ), "" ) == 0 );
+    }
+    ArenaMgr::destroy();
+}
+
+TEST_CASE( "psymbol_arena: many symbols pack densely across pages", "[psymbol_arena]" )
+{
+    REQUIRE( ArenaMgr::create( 8 << 20 ) );
+    {
+        pmm::psymbol_arena<ArenaMgr, 4096> arena( "dense" );
+        std::vector<pmm::psymbol>          syms;
+        const std::size_t                  before = ArenaMgr::used_size();
+        for ( int i = 0; i < 3000; ++i )
+            syms.push_back( arena.intern( ( "sym_" + std::to_string( i ) ).c_str() ) );
+        const std::size_t arena_bytes = ArenaMgr::used_size() - before;
+        REQUIRE( arena.size() == 3000 );
+        REQUIRE( arena.page_count() > 1 );
+        for ( int i = 0; i < 3000; ++i )
+        {
+            const std::string s = "sym_" + std::to_string( i );
+            REQUIRE( arena.find( s.c_str() ) == syms[static_cast<std::size_t>( i )] );
+            REQUIRE( s == arena.c_str( syms[static_cast<std::size_t>( i )] ) );
+        }
+
+        const std::size_t view_before = ArenaMgr::used_size();
+        for ( int i = 0; i < 3000; ++i )
+            ArenaMgr::pstringview::intern( ( "sym_" + std::to_string( i ) ).c_str() );
+        const std::size_t view_bytes = ArenaMgr::used_size() - view_before;
+        REQUIRE( arena_bytes < view_bytes );
+
+        std::string big( 10000, 'x' );
+        pmm::psymbol large = arena.intern( big.c_str() );
+        REQUIRE( !large.is_null() );
+        REQUIRE( arena.length( large ) == big.size() );
+        REQUIRE( big == arena.c_str( large ) );
+        REQUIRE( arena.intern( "after_large" ) != large );
+
+        std::size_t visited = 0;
+        bool        ordered = true;
+        arena.for_each(
+            [&]( pmm::psymbol sym, const char* s, std::size_t len )
+            {
+                if ( visited < syms.size() )
+                    ordered = ordered && sym == syms[visited] && len == std::strlen( s );
+                ++visited;
+            } );
+        REQUIRE( ordered );
+        REQUIRE( visited == arena.size() );
+        REQUIRE( ArenaMgr::verify().ok );
+    }
+    ArenaMgr::destroy();
+}
+
+TEST_CASE( "psymbol_arena: survives save/load", "[psymbol_arena]" )
+{
+    const char*  file = "test_psymbol_arena.dat";
+    pmm::psymbol hello;
+    REQUIRE( ArenaMgr::create( 1 << 20 ) );
+    {
+        pmm::psymbol_arena<ArenaMgr, 256> arena( "persisted" );
+        hello = arena.intern( "hello" );
+        for ( int i = 0; i < 200; ++i )
+            arena.intern( ( "word" + std::to_string( i ) ).c_str() );
+        REQUIRE( pmm::save_manager<ArenaMgr>( file ) );
+    }
+    REQUIRE( ArenaMgr2::create( ArenaMgr::total_size() ) );
+    ArenaMgr::destroy();
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<ArenaMgr2>( file, vr ) );
+    {
+        pmm::psymbol_arena<ArenaMgr2, 256> arena( "persisted" );
+        REQUIRE( arena.size() == 201 );
+        REQUIRE( arena.find( "hello" ) == hello );
+        REQUIRE( std::strcmp( arena.c_str( hello ), "hello" ) == 0 );
+        REQUIRE( arena.find( "word199" ) == arena.intern( "word199" ) );
+        REQUIRE( arena.size() == 201 );
+        REQUIRE( !arena.intern( "fresh" ).is_null() );
+        REQUIRE( ArenaMgr2::verify().ok );
+    }
+    ArenaMgr2::destroy();
+    std::remove( file );
+}
+
+TEST_CASE( "psymbol_arena: first intern retries the index after running out of memory", "[psymbol_arena]" )
+{
+    REQUIRE( ArenaTiny::create( 16384 ) );
+    {
+        pmm::psymbol_arena<ArenaTiny, 1024> arena( "symbols" );
+        REQUIRE( arena.is_bound() );
+        std::vector<ArenaTiny::pptr<std::uint8_t>> filler;
+        for ( auto p = ArenaTiny::allocate_typed<std::uint8_t>( 256 ); !p.is_null();
+              p      = ArenaTiny::allocate_typed<std::uint8_t>( 256 ) )
+            filler.push_back( p );
+        REQUIRE( !filler.empty() );
+        ArenaTiny::deallocate_typed( filler.back() );
+        filler.pop_back();
+        REQUIRE( arena.intern( "alpha" ).is_null() );
+        REQUIRE( arena.intern( "alpha" ).is_null() );
+
+        for ( auto& p : filler )
+            ArenaTiny::deallocate_typed( p );
+        pmm::psymbol a = arena.intern( "alpha" );
+        REQUIRE( !a.is_null() );
+        REQUIRE( arena.find( "alpha" ) == a );
+        REQUIRE( arena.size() == 1 );
+    }
+    ArenaTiny::destroy();
+}
+
+TEST_CASE( "psymbol_arena: clear frees every page", "[psymbol_arena]" )
+{
+    REQUIRE( ArenaMgr::create( 1 << 20 ) );
+    {
+        pmm::psymbol_arena<ArenaMgr, 256> arena( "cleared" );
+        std::size_t                       blocks = ArenaMgr::alloc_block_count();
+        for ( int i = 0; i < 500; ++i )
+            REQUIRE( !arena.intern( ( "sym" + std::to_string( i ) ).c_str() ).is_null() );
+        REQUIRE( arena.page_count() > 1 );
+        arena.clear();
+        REQUIRE( arena.size() == 0 );
+        REQUIRE( arena.page_count() == 0 );
+        REQUIRE( arena.bytes_used() == 0 );
+        REQUIRE( arena.find( "sym1" ).is_null() );
+        REQUIRE( ArenaMgr::alloc_block_count() == blocks );
+        REQUIRE( ArenaMgr::verify().ok );
+        arena.clear();
+
+        pmm::psymbol again = arena.intern( "sym1" );
+        REQUIRE( !again.is_null() );
+        REQUIRE( arena.find( "sym1" ) == again );
+        REQUIRE( arena.size() == 1 );
+    }
+    ArenaMgr::destroy();
+}
@@ -0,0 +1,107 @@
+/**
+ * @file test_sparse_save.cpp
+ * @brief Tests for save_manager_sparse(): free block payloads are written as file holes.
+ *
+ * Verifies:
+ *  - after a large deallocation the skipped byte count tracks the free space, not capacity
+ *  - the sparse image loads through the regular load_manager_from_file() with a valid CRC
+ *  - live data, allocator counters and verify() are intact after the reload
+ *  - on filesystems with hole support the file occupies fewer blocks than its size
+ *  - the CRC over a hole is computed without reading it and matches hashing the zeros
+ */
+
+#include "pmm/io.h"
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#if !defined( _WIN32 ) && !defined( _WIN64 )
+#include <sys/stat.h>
+#endif
+
+using SparseMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3001>;
+using SparseMgr2 = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3002>;
+
+static const char* kSparseFile = "test_sparse_save.dat";
+
+TEST_CASE( "sparse save skips free payloads and reloads", "[test_sparse_save]" )
+{
+    std::remove( kSparseFile );
+    const std::size_t size = 1024 * 1024;
+    REQUIRE( SparseMgr::create( size ) );
+
+    SparseMgr::pptr<std::uint8_t> big = SparseMgr::allocate_typed<std::uint8_t>( 700 * 1024 );
+    REQUIRE( !big.is_null() );
+    std::memset( &*big, 0xAB, 700 * 1024 );
+    SparseMgr::pptr<std::uint32_t> keep = SparseMgr::allocate_typed<std::uint32_t>( 64 );
+    REQUIRE( !keep.is_null() );
+    for ( std::uint32_t i = 0; i < 64; ++i )
+        ( &*keep )[i] = i * 7;
+    SparseMgr::deallocate_typed( big );
+
+    std::size_t total       = SparseMgr::total_size();
+    std::size_t used        = SparseMgr::used_size();
+    std::size_t blocks      = SparseMgr::block_count();
+    std::size_t free_blocks = SparseMgr::free_block_count();
+    std::size_t skipped     = 0;
+    REQUIRE( pmm::save_manager_sparse<SparseMgr>( kSparseFile, &skipped ) );
+    REQUIRE( skipped >= 600 * 1024 );
+    REQUIRE( skipped < total );
+    SparseMgr::destroy();
+
+#if !defined( _WIN32 ) && !defined( _WIN64 )
+    struct stat st{};
+    REQUIRE( ::stat( kSparseFile, &st ) == 0 );
+    REQUIRE( static_cast<std::size_t>( st.st_size ) == total );
+#endif
+
+    REQUIRE( SparseMgr2::create( total ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<SparseMgr2>( kSparseFile, vr ) );
+    REQUIRE( SparseMgr2::used_size() == used );
+    REQUIRE( SparseMgr2::block_count() == blocks );
+    REQUIRE( SparseMgr2::free_block_count() == free_blocks );
+    SparseMgr2::pptr<std::uint32_t> keep2( keep.offset() );
+    for ( std::uint32_t i = 0; i < 64; ++i )
+        REQUIRE( ( &*keep2 )[i] == i * 7 );
+    REQUIRE( SparseMgr2::verify().ok );
+    SparseMgr2::pptr<std::uint8_t> again = SparseMgr2::allocate_typed<std::uint8_t>( 500 * 1024 );
+    REQUIRE( !again.is_null() );
+    SparseMgr2::destroy();
+    std::remove( kSparseFile );
+}
+
+TEST_CASE( "sparse save of a full image skips nothing beyond free space", "[test_sparse_save]" )
+{
+    std::remove( kSparseFile );
+    REQUIRE( SparseMgr::create( 64 * 1024 ) );
+    std::size_t skipped = 1;
+    REQUIRE( pmm::save_manager_sparse<SparseMgr>( kSparseFile, &skipped ) );
+    REQUIRE( skipped <= SparseMgr::free_size() );
+    std::size_t total = SparseMgr::total_size();
+    SparseMgr::destroy();
+
+    REQUIRE( SparseMgr2::create( total ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<SparseMgr2>( kSparseFile, vr ) );
+    SparseMgr2::destroy();
+    REQUIRE_FALSE( pmm::save_manager_sparse<SparseMgr>( kSparseFile ) );
+    REQUIRE_FALSE( pmm::save_manager_sparse<SparseMgr>( nullptr ) );
+    std::remove( kSparseFile );
+}
+
+TEST_CASE( "sparse CRC skips holes without reading them", "[test_sparse_save]" )
+{
+    std::vector<std::uint8_t> zeros( 70000, 0 );
+    for ( std::size_t count : { std::size_t{ 0 }, std::size_t{ 1 }, std::size_t{ 7 }, std::size_t{ 4096 },
+                                std::size_t{ 65537 }, zeros.size() } )
+    {
+        std::uint32_t byte_wise = 0x12345678U;
+        for ( std::size_t i = 0; i < count; ++i )
+            byte_wise = pmm::detail::crc32_accumulate_byte( byte_wise, 0 );
+        REQUIRE( pmm::detail::crc32_accumulate_zeros( 0x12345678U, count ) == byte_wise );
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ * @file test_symbol_index.cpp
+ * @brief Tests for the persistent hash index behind pstringview interning.
+ *
+ * Verifies:
+ *  - interning goes through the system/symbol_index table and still deduplicates
+ *  - each symbol stores the FNV-1a hash of its bytes; the table grows and stays consistent with the AVL view
+ *  - the index survives save/load; pstringview::reset() drops it and it is rebuilt once enough symbols exist
+ *  - below the build threshold a header-only table keeps the persisted symbol count
+ */
+
+#include "pmm/io.h"
+#include "pmm/pmm_presets.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using SymMgr  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3701>;
+using SymMgr2 = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 3702>;
+
+template <typename Mgr> static const pmm::detail::SymbolIndexHeader* index_table()
+{
+    auto root = Mgr::get_domain_root_offset( pmm::detail::kSystemDomainSymbolIndex );
+    if ( root == 0 )
+        return nullptr;
+    return Mgr::template resolve<pmm::detail::SymbolIndexHeader>(
+        typename Mgr::template pptr<pmm::detail::SymbolIndexHeader>( root ) );
+}
+
+template <typename Mgr> static std::size_t avl_symbol_count()
+{
+    std::size_t count = 0;
+    auto        root  = Mgr::pstringview::root_index();
+    if ( root == 0 )
+        return 0;
+    using P = typename Mgr::template pptr<typename Mgr::pstringview>;
+    for ( P p = pmm::detail::avl_min_node( P( root ) ); !p.is_null(); p = pmm::detail::avl_inorder_successor( p ) )
+        ++count;
+    return count;
+}
+
+TEST_CASE( "symbol index deduplicates and stores hashes", "[test_symbol_index]" )
+{
+    REQUIRE( SymMgr::create( 512 * 1024 ) );
+    REQUIRE( SymMgr::has_domain( pmm::detail::kSystemDomainSymbolIndex ) );
+    std::vector<SymMgr::pptr<SymMgr::pstringview>> ids;
+    for ( int i = 0; i < 5000; ++i )
+    {
+        std::string name = "ident_" + std::to_string( i );
+        ids.push_back( SymMgr::pstringview( name.c_str() ) );
+        REQUIRE( !ids.back().is_null() );
+        REQUIRE( ids.back()->hash == pmm::detail::symbol_hash( name.c_str(), name.size() ) );
+    }
+    for ( int i = 0; i < 5000; i += 7 )
+    {
+        std::string name = "ident_" + std::to_string( i );
+        REQUIRE( SymMgr::pstringview::intern( name.c_str() ) == ids[static_cast<std::size_t>( i )] );
+    }
+    SymMgr::pptr<SymMgr::pstringview> empty = SymMgr::pstringview( "" );
+    REQUIRE( empty == SymMgr::pstringview::intern( nullptr ) );
+
+    const auto* table = index_table<SymMgr>();
+    REQUIRE( table != nullptr );
+    REQUIRE( table->count == avl_symbol_count<SymMgr>() );
+    REQUIRE( table->count * 2 <= table->capacity );
+    REQUIRE( ( table->capacity & ( table->capacity - 1 ) ) == 0 );
+    REQUIRE( *ids[42] == "ident_42" );
+    REQUIRE( *ids[42] != *ids[43] );
+    REQUIRE( SymMgr::verify().ok );
+
+    SymMgr::pstringview::reset();
+    REQUIRE( index_table<SymMgr>() == nullptr );
+    SymMgr::pptr<SymMgr::pstringview> again = SymMgr::pstringview( "after_reset" );
+    REQUIRE( !again.is_null() );
+    REQUIRE( index_table<SymMgr>() != nullptr );
+    REQUIRE( index_table<SymMgr>()->capacity == 0 );
+    REQUIRE( index_table<SymMgr>()->count == avl_symbol_count<SymMgr>() );
+    for ( int i = 0; i < 32; ++i )
+        SymMgr::pstringview::intern( ( "refill_" + std::to_string( i ) ).c_str() );
+    REQUIRE( index_table<SymMgr>() != nullptr );
+    REQUIRE( index_table<SymMgr>()->count == avl_symbol_count<SymMgr>() );
+    REQUIRE( SymMgr::pstringview::intern( "after_reset" ) == again );
+    SymMgr::destroy();
+}
+
+TEST_CASE( "symbol index survives save/load", "[test_symbol_index]" )
+{
+    const char* kImage = "test_symbol_index.img";
+    REQUIRE( SymMgr::create( 256 * 1024 ) );
+    std::vector<SymMgr::pptr<SymMgr::pstringview>::index_type> offsets;
+    for ( int i = 0; i < 500; ++i )
+        offsets.push_back( SymMgr::pstringview::intern( ( "sym/" + std::to_string( i ) ).c_str() ).offset() );
+    REQUIRE( pmm::save_manager<SymMgr>( kImage ) );
+    REQUIRE( SymMgr2::create( SymMgr::total_size() ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::load_manager_from_file<SymMgr2>( kImage, vr ) );
+    REQUIRE( index_table<SymMgr2>() != nullptr );
+    for ( int i = 0; i < 500; ++i )
+        REQUIRE( SymMgr2::pstringview::intern( ( "sym/" + std::to_string( i ) ).c_str() ).offset() ==
+                 offsets[static_cast<std::size_t>( i )] );
+    REQUIRE( index_table<SymMgr2>()->count == avl_symbol_count<SymMgr2>() );
+    SymMgr2::destroy();
+    SymMgr::destroy();
+    std::remove( kImage );
+}
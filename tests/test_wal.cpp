@@ -0,0 +1,294 @@
+/**
+ * @file test_wal.cpp
+ * @brief Tests for the page-level write-ahead log with group commit (pmm/wal.h).
+ *
+ * Verifies:
+ *  - committed allocator, pmap and root changes survive a crash and are replayed on recovery
+ *  - mutations after the last commit are lost, committed ones are not
+ *  - one commit() per batch produces one log record (group commit)
+ *  - a torn log tail is ignored, earlier records are still replayed
+ *  - a log that belongs to an older checkpoint is not replayed over a newer image
+ *  - commit() logs only the pages changed since the previous commit, including writes through raw pointers
+ *  - a record whose payload_size exceeds the log file is rejected before it is read
+ *  - a log whose page size is not a power of two is not replayed
+ */
+
+#include "pmm/pmm_presets.h"
+#include "pmm/wal.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using WalMgr     = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 2701>;
+using WalReplay  = pmm::PersistMemoryManager<pmm::CacheManagerConfig, 2702>;
+using WalPersist = pmm::PersistMemoryManager<pmm::PersistentDataConfig, 2703>;
+
+static const char*       kWalImage = "test_wal_image.dat";
+static const char*       kWalLog   = "test_wal_image.log";
+static const std::size_t kWalSize  = 128 * 1024;
+
+static void cleanup_wal_files()
+{
+    std::remove( kWalImage );
+    std::remove( kWalLog );
+    std::remove( "test_wal_image.log.old" );
+}
+
+static std::vector<std::uint8_t> read_all( const char* path )
+{
+    std::vector<std::uint8_t> bytes;
+    std::FILE*                f = std::fopen( path, "rb" );
+    if ( f == nullptr )
+        return bytes;
+    int c;
+    while ( ( c = std::fgetc( f ) ) != EOF )
+        bytes.push_back( static_cast<std::uint8_t>( c ) );
+    std::fclose( f );
+    return bytes;
+}
+
+static void write_all( const char* path, const std::vector<std::uint8_t>& bytes )
+{
+    std::FILE* f = std::fopen( path, "wb" );
+    REQUIRE( f != nullptr );
+    REQUIRE( std::fwrite( bytes.data(), 1, bytes.size(), f ) == bytes.size() );
+    std::fclose( f );
+}
+
+TEST_CASE( "wal replays committed mutations after a crash", "[test_wal]" )
+{
+    cleanup_wal_files();
+    REQUIRE( WalMgr::create( kWalSize ) );
+    pmm::WriteAheadLog<WalMgr> wal;
+    REQUIRE( wal.open( kWalImage, kWalLog ) );
+    REQUIRE( wal.is_open() );
+
+    WalMgr::pptr<int> p = WalMgr::allocate_typed<int>();
+    REQUIRE( !p.is_null() );
+    *p = 11;
+    WalMgr::pmap<int, int> map( "wal/map" );
+    map.insert( 1, 100 );
+    map.insert( 2, 200 );
+    WalMgr::set_root( p );
+    REQUIRE( wal.commit() );
+    REQUIRE( wal.sequence() == 1 );
+
+    *p = 22;
+    map.insert( 3, 300 );
+    REQUIRE( wal.commit() );
+    REQUIRE( wal.sequence() == 2 );
+
+    *p = 33;
+    wal.close();
+    WalMgr::destroy();
+
+    REQUIRE( WalReplay::create( kWalSize ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::recover_manager_from_wal<WalReplay>( kWalImage, kWalLog, vr ) );
+    WalReplay::pptr<int> root = WalReplay::get_root<int>();
+    REQUIRE( root.offset() == p.offset() );
+    REQUIRE( *root == 22 );
+    WalReplay::pmap<int, int> replayed( "wal/map" );
+    REQUIRE( replayed.size() == 3 );
+    REQUIRE( replayed.find( 3 )->value == 300 );
+    WalReplay::destroy();
+    cleanup_wal_files();
+}
+
+TEST_CASE( "wal group commit writes one record per batch", "[test_wal]" )
+{
+    cleanup_wal_files();
+    REQUIRE( WalMgr::create( kWalSize ) );
+    pmm::WriteAheadLog<WalMgr> wal;
+    REQUIRE( wal.open( kWalImage, kWalLog ) );
+
+    std::vector<WalMgr::pptr<int>> ptrs;
+    for ( int i = 0; i < 64; ++i )
+    {
+        ptrs.push_back( WalMgr::allocate_typed<int>() );
+        *ptrs.back() = i;
+    }
+    REQUIRE( wal.commit() );
+    REQUIRE( wal.sequence() == 1 );
+    REQUIRE( wal.commit() );
+    REQUIRE( wal.sequence() == 1 );
+
+    wal.close();
+    WalMgr::destroy();
+
+    REQUIRE( WalReplay::create( kWalSize ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::recover_manager_from_wal<WalReplay>( kWalImage, kWalLog, vr ) );
+    for ( int i = 0; i < 64; ++i )
+        REQUIRE( *WalReplay::pptr<int>( ptrs[static_cast<std::size_t>( i )].offset() ) == i );
+    WalReplay::destroy();
+    cleanup_wal_files();
+}
+
+TEST_CASE( "wal ignores a torn tail record", "[test_wal]" )
+{
+    cleanup_wal_files();
+    REQUIRE( WalMgr::create( kWalSize ) );
+    pmm::WriteAheadLog<WalMgr> wal;
+    REQUIRE( wal.open( kWalImage, kWalLog ) );
+    WalMgr::pptr<int> p = WalMgr::allocate_typed<int>();
+    *p                  = 7;
+    REQUIRE( wal.commit() );
+    *p = 8;
+    REQUIRE( wal.commit() );
+    wal.close();
+    WalMgr::destroy();
+
+    std::vector<std::uint8_t> log = read_all( kWalLog );
+    REQUIRE( log.size() > 16 );
+    log.resize( log.size() - 5 );
+    write_all( kWalLog, log );
+
+    REQUIRE( WalReplay::create( kWalSize ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::recover_manager_from_wal<WalReplay>( kWalImage, kWalLog, vr ) );
+    REQUIRE( *WalReplay::pptr<int>( p.offset() ) == 7 );
+    WalReplay::destroy();
+    cleanup_wal_files();
+}
+
+TEST_CASE( "wal from an older checkpoint is not replayed", "[test_wal]" )
+{
+    cleanup_wal_files();
+    REQUIRE( WalMgr::create( kWalSize ) );
+    pmm::WriteAheadLog<WalMgr> wal;
+    REQUIRE( wal.open( kWalImage, kWalLog ) );
+    WalMgr::pptr<int> p = WalMgr::allocate_typed<int>();
+    *p                  = 1;
+    REQUIRE( wal.commit() );
+    std::vector<std::uint8_t> old_log = read_all( kWalLog );
+
+    *p = 2;
+    REQUIRE( wal.checkpoint() );
+    REQUIRE( wal.sequence() == 0 );
+    wal.close();
+    WalMgr::destroy();
+    write_all( kWalLog, old_log );
+
+    REQUIRE( WalReplay::create( kWalSize ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::recover_manager_from_wal<WalReplay>( kWalImage, kWalLog, vr ) );
+    REQUIRE( *WalReplay::pptr<int>( p.offset() ) == 2 );
+    WalReplay::destroy();
+    cleanup_wal_files();
+}
+
+TEST_CASE( "wal works with a locking manager and a missing log", "[test_wal]" )
+{
+    cleanup_wal_files();
+    REQUIRE( WalPersist::create( kWalSize ) );
+    pmm::WriteAheadLog<WalPersist> wal;
+    REQUIRE( wal.open( kWalImage, kWalLog ) );
+    std::size_t           checkpoint_allocs = WalPersist::alloc_block_count();
+    WalPersist::pptr<int> p                 = WalPersist::allocate_typed<int>();
+    *p = 5;
+    REQUIRE( wal.commit() );
+    wal.close();
+    WalPersist::destroy();
+    std::remove( kWalLog );
+
+    REQUIRE( WalPersist::create( kWalSize ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::recover_manager_from_wal<WalPersist>( kWalImage, kWalLog, vr ) );
+    REQUIRE( WalPersist::alloc_block_count() == checkpoint_allocs );
+    WalPersist::destroy();
+    cleanup_wal_files();
+}
+
+TEST_CASE( "wal commit logs only changed pages", "[test_wal]" )
+{
+    cleanup_wal_files();
+    REQUIRE( WalMgr::create( 1024 * 1024 ) );
+    pmm::WriteAheadLog<WalMgr> wal;
+    REQUIRE( wal.open( kWalImage, kWalLog ) );
+    WalMgr::pptr<int> p   = WalMgr::allocate_typed<int>();
+    int*              raw = p.resolve();
+    *raw                  = 1;
+    REQUIRE( wal.commit() );
+    const std::size_t after_first = read_all( kWalLog ).size();
+
+    *raw = 2;
+    REQUIRE( wal.commit() );
+    REQUIRE( wal.sequence() == 2 );
+    const std::size_t record = read_all( kWalLog ).size() - after_first;
+    REQUIRE( record <= sizeof( pmm::detail::WalRecordHeader ) + 2 * ( 8 + wal.page_size() ) );
+    wal.close();
+    WalMgr::destroy();
+
+    REQUIRE( WalReplay::create( 1024 * 1024 ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::recover_manager_from_wal<WalReplay>( kWalImage, kWalLog, vr ) );
+    REQUIRE( *WalReplay::pptr<int>( p.offset() ) == 2 );
+    WalReplay::destroy();
+    cleanup_wal_files();
+}
+
+TEST_CASE( "wal rejects a record larger than the log file", "[test_wal]" )
+{
+    cleanup_wal_files();
+    REQUIRE( WalMgr::create( kWalSize ) );
+    pmm::WriteAheadLog<WalMgr> wal;
+    REQUIRE( wal.open( kWalImage, kWalLog ) );
+    WalMgr::pptr<int> p = WalMgr::allocate_typed<int>();
+    *p                  = 3;
+    REQUIRE( wal.commit() );
+    wal.close();
+    WalMgr::destroy();
+
+    pmm::detail::WalRecordHeader forged{};
+    forged.magic        = pmm::detail::kWalRecordMagic;
+    forged.page_count   = 1;
+    forged.sequence     = 2;
+    forged.image_size   = kWalSize;
+    forged.payload_size = std::uint64_t{ 1 } << 40;
+
+    std::vector<std::uint8_t> log = read_all( kWalLog );
+    const auto*               raw = reinterpret_cast<const std::uint8_t*>( &forged );
+    log.insert( log.end(), raw, raw + sizeof( forged ) );
+    write_all( kWalLog, log );
+
+    REQUIRE( WalReplay::create( kWalSize ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::recover_manager_from_wal<WalReplay>( kWalImage, kWalLog, vr ) );
+    REQUIRE( *WalReplay::pptr<int>( p.offset() ) == 3 );
+    WalReplay::destroy();
+    cleanup_wal_files();
+}
+
+TEST_CASE( "wal with a page size that is not a power of two is not replayed", "[test_wal]" )
+{
+    cleanup_wal_files();
+    REQUIRE( WalMgr::create( kWalSize ) );
+    pmm::WriteAheadLog<WalMgr> wal;
+    REQUIRE( wal.open( kWalImage, kWalLog ) );
+    WalMgr::pptr<int> p = WalMgr::allocate_typed<int>();
+    *p                  = 1;
+    REQUIRE( wal.checkpoint() );
+    *p = 2;
+    REQUIRE( wal.commit() );
+    wal.close();
+    WalMgr::destroy();
+
+    std::vector<std::uint8_t> log = read_all( kWalLog );
+    pmm::detail::WalFileHeader fh{};
+    REQUIRE( log.size() >= sizeof( fh ) );
+    std::memcpy( &fh, log.data(), sizeof( fh ) );
+    fh.page_size = 3000;
+    std::memcpy( log.data(), &fh, sizeof( fh ) );
+    write_all( kWalLog, log );
+
+    REQUIRE( WalReplay::create( kWalSize ) );
+    pmm::VerifyResult vr;
+    REQUIRE( pmm::recover_manager_from_wal<WalReplay>( kWalImage, kWalLog, vr ) );
+    REQUIRE( *WalReplay::pptr<int>( p.offset() ) == 1 );
+    WalReplay::destroy();
+    cleanup_wal_files();
+}